@@ -149,6 +149,21 @@ struct random_values
 };
 
 
+/** values using every (nonnegative) bit of T, to exercise the
+ * writers and readers with the widest numbers */
+template<class T>
+std::vector<T> mkwide()
+{
+    c4::rng::pcg rng;
+    std::vector<T> v(kNumValues);
+    for(T &val : v)
+    {
+        const uint64_t r = (uint64_t(rng()) << 32u) | uint64_t(rng());
+        val = static_cast<T>(r & static_cast<uint64_t>(std::numeric_limits<T>::max()));
+    }
+    return v;
+}
+
 /** a ring buffer with input strings for atox benchmarks */
 struct random_strings
 {
@@ -170,6 +185,49 @@ struct random_strings
         }
     }
 
+    /** strings of decimal digits, all with the max number of digits
+     * that fit in T */
+    template<class T>
+    void init_as_long_dec()
+    {
+        c4::rng::pcg rng;
+        std::uniform_int_distribution<uint32_t> idist(0, 9);
+        for(size_t i = 0; i < v.size(); ++i)
+        {
+            v[i].resize(std::numeric_limits<T>::digits10);
+            for(char &c : v[i])
+                c = static_cast<char>('0' + idist(rng));
+        }
+    }
+
+    /** short plain decimals as found in data feeds, eg prices and
+     * measurements: 1 to 6 integer digits, 0 to 4 decimals, no
+     * exponent, and some negative */
+    void init_as_short_decimal()
+    {
+        c4::rng::pcg rng;
+        std::uniform_int_distribution<uint32_t> ndist(1, 6);
+        std::uniform_int_distribution<uint32_t> ddist(0, 4);
+        std::uniform_int_distribution<uint32_t> idist(0, 9);
+        std::uniform_int_distribution<uint32_t> sdist(0, 3);
+        for(size_t i = 0; i < v.size(); ++i)
+        {
+            std::string &s = v[i];
+            s.clear();
+            if(sdist(rng) == 0)
+                s += '-';
+            const uint32_t num_int = ndist(rng);
+            s += static_cast<char>((num_int > 1 ? '1' : '0') + idist(rng) % (num_int > 1 ? 9u : 10u));
+            for(uint32_t d = 1; d < num_int; ++d)
+                s += static_cast<char>('0' + idist(rng));
+            const uint32_t num_dec = ddist(rng);
+            if(num_dec)
+                s += '.';
+            for(uint32_t d = 0; d < num_dec; ++d)
+                s += static_cast<char>('0' + idist(rng));
+        }
+    }
+
     template<class T>
     void init_as_hex()
     {
@@ -177,7 +235,22 @@ struct random_strings
         generate_n<T>(&tmp.v.front(), &tmp.v.back());
         for(size_t i = 0; i < v.size(); ++i)
         {
-            c4::catrs(&v[i], c4::fmt::hex(tmp.v[i]));
+            // write without the 0x prefix, which read_hex() does not
+            // accept, and without the minus sign
+            const auto u = static_cast<typename std::make_unsigned<T>::type>(tmp.v[i]);
+            v[i].resize(c4::write_hex(c4::substr{}, u));
+            c4::write_hex(c4::to_substr(v[i]), u);
+        }
+    }
+    /** hexadecimal strings of values using every bit of T */
+    template<class T>
+    void init_as_wide_hex()
+    {
+        std::vector<T> tmp = mkwide<T>();
+        for(size_t i = 0; i < v.size(); ++i)
+        {
+            v[i].resize(c4::write_hex(c4::substr{}, tmp[i]));
+            c4::write_hex(c4::to_substr(v[i]), tmp[i]);
         }
     }
     template<class T>
@@ -187,7 +260,10 @@ struct random_strings
         generate_n<T>(&tmp.v.front(), &tmp.v.back());
         for(size_t i = 0; i < v.size(); ++i)
         {
-            c4::catrs(&v[i], c4::fmt::oct(tmp.v[i]));
+            // write without the 0o prefix and without the minus sign
+            const auto u = static_cast<typename std::make_unsigned<T>::type>(tmp.v[i]);
+            v[i].resize(c4::write_oct(c4::substr{}, u));
+            c4::write_oct(c4::to_substr(v[i]), u);
         }
     }
     template<class T>
@@ -197,7 +273,10 @@ struct random_strings
         generate_n<T>(&tmp.v.front(), &tmp.v.back());
         for(size_t i = 0; i < v.size(); ++i)
         {
-            c4::catrs(&v[i], c4::fmt::bin(tmp.v[i]));
+            // write without the 0b prefix and without the minus sign
+            const auto u = static_cast<typename std::make_unsigned<T>::type>(tmp.v[i]);
+            v[i].resize(c4::write_bin(c4::substr{}, u));
+            c4::write_bin(c4::to_substr(v[i]), u);
         }
     }
 
@@ -246,6 +325,63 @@ atox_c4_read_dec(bm::State& st)
     for(auto _ : st)
     {
         c4::read_dec(strings.next(), &val);
+        bm::DoNotOptimize(val);
+    }
+    report<T>(st);
+}
+
+/** the scalar loop, reading one digit at a time. Used as a baseline
+ * for comparison with c4::read_dec() */
+template<class I>
+C4_ALWAYS_INLINE bool scalar_read_dec(c4::csubstr s, I *C4_RESTRICT v)
+{
+    *v = 0;
+    for(char c : s)
+    {
+        if(C4_UNLIKELY(c < '0' || c > '9'))
+            return false;
+        *v = (*v) * I(10) + (I(c) - I('0'));
+    }
+    return true;
+}
+
+C4FOR(T, isint)
+atox_scalar_read_dec(bm::State& st)
+{
+    random_strings strings = mkstrings<T>();
+    T val;
+    for(auto _ : st)
+    {
+        scalar_read_dec(strings.next(), &val);
+        bm::DoNotOptimize(val);
+    }
+    report<T>(st);
+}
+
+C4FOR(T, isint)
+atox_c4_read_dec_long(bm::State& st)
+{
+    random_strings strings;
+    strings.init_as_long_dec<T>();
+    T val;
+    for(auto _ : st)
+    {
+        c4::read_dec(strings.next(), &val);
+        bm::DoNotOptimize(val);
+    }
+    report<T>(st);
+}
+
+C4FOR(T, isint)
+atox_scalar_read_dec_long(bm::State& st)
+{
+    random_strings strings;
+    strings.init_as_long_dec<T>();
+    T val;
+    for(auto _ : st)
+    {
+        scalar_read_dec(strings.next(), &val);
+        bm::DoNotOptimize(val);
     }
     report<T>(st);
 }
@@ -259,6 +395,7 @@ atox_c4_read_hex(bm::State& st)
     for(auto _ : st)
     {
         c4::read_hex(strings.next(), &val);
+        bm::DoNotOptimize(val);
     }
     report<T>(st);
 }
@@ -272,6 +409,7 @@ atox_c4_read_oct(bm::State& st)
     for(auto _ : st)
     {
         c4::read_oct(strings.next(), &val);
+        bm::DoNotOptimize(val);
     }
     report<T>(st);
 }
@@ -285,6 +423,113 @@ atox_c4_read_bin(bm::State& st)
     for(auto _ : st)
     {
         c4::read_bin(strings.next(), &val);
+        bm::DoNotOptimize(val);
+    }
+    report<T>(st);
+}
+
+/** the previous (digit by digit) hexadecimal writer, as a baseline */
+template<class T>
+size_t naive_write_hex(c4::substr buf, T v)
+{
+    size_t pos = 0;
+    do {
+        if(pos < buf.len)
+            buf.str[pos] = c4::hexchars[v & T(15)];
+        ++pos;
+        v >>= 4;
+    } while(v);
+    buf.reverse_range(0, pos <= buf.len ? pos : buf.len);
+    return pos;
+}
+
+/** the previous (digit by digit) hexadecimal reader, as a baseline */
+template<class T>
+bool naive_read_hex(c4::csubstr s, T *v)
+{
+    *v = 0;
+    for(char c : s)
+    {
+        T cv;
+        if(c >= '0' && c <= '9')
+            cv = T(c) - T('0');
+        else if(c >= 'a' && c <= 'f')
+            cv = T(10) + (T(c) - T('a'));
+        else if(c >= 'A' && c <= 'F')
+            cv = T(10) + (T(c) - T('A'));
+        else
+            return false;
+        *v = (*v) * T(16) + cv;
+    }
+    return true;
+}
+
+template<class T>
+void xtoa_c4_write_hex_wide(bm::State& st)
+{
+    string_buffer buf;
+    std::vector<T> vals = mkwide<T>();
+    size_t i = 0;
+    for(auto _ : st)
+    {
+        c4::write_hex(buf, vals[i]);
+        i = (i + 1) % vals.size();
+    }
+    report<T>(st);
+}
+
+template<class T>
+void xtoa_naive_write_hex_wide(bm::State& st)
+{
+    string_buffer buf;
+    std::vector<T> vals = mkwide<T>();
+    size_t i = 0;
+    for(auto _ : st)
+    {
+        naive_write_hex(buf, vals[i]);
+        i = (i + 1) % vals.size();
+    }
+    report<T>(st);
+}
+
+template<class T>
+void xtoa_c4_write_bin_wide(bm::State& st)
+{
+    string_buffer buf;
+    std::vector<T> vals = mkwide<T>();
+    size_t i = 0;
+    for(auto _ : st)
+    {
+        c4::write_bin(buf, vals[i]);
+        i = (i + 1) % vals.size();
+    }
+    report<T>(st);
+}
+
+template<class T>
+void atox_c4_read_hex_wide(bm::State& st)
+{
+    random_strings strings;
+    strings.init_as_wide_hex<T>();
+    T val;
+    for(auto _ : st)
+    {
+        c4::read_hex(strings.next(), &val);
+        bm::DoNotOptimize(val);
+    }
+    report<T>(st);
+}
+
+template<class T>
+void atox_naive_read_hex_wide(bm::State& st)
+{
+    random_strings strings;
+    strings.init_as_wide_hex<T>();
+    T val;
+    for(auto _ : st)
+    {
+        naive_read_hex(strings.next(), &val);
+        bm::DoNotOptimize(val);
     }
     report<T>(st);
 }
@@ -315,6 +560,32 @@ xtoa_c4_write_dec(bm::State& st)
     report<T>(st);
 }
 
+C4FOR(T, isuint)
+xtoa_c4_write_dec_zpad(bm::State& st)
+{
+    string_buffer buf;
+    T i = 0;
+    for(auto _ : st)
+    {
+        c4::write_dec(buf, i++, std::numeric_limits<T>::digits10 + 1);
+    }
+    report<T>(st);
+}
+
+C4FOR(T, isiint)
+xtoa_c4_write_dec_zpad(bm::State& st)
+{
+    string_buffer buf;
+    T i = 0;
+    for(auto _ : st)
+    {
+        if(i < 0)
+            i = 0;
+        c4::write_dec(buf, i++, std::numeric_limits<T>::digits10 + 1);
+    }
+    report<T>(st);
+}
+
 C4FOR(T, isuint)
 xtoa_c4_write_hex(bm::State& st)
 {
@@ -442,6 +713,54 @@ xtoa_c4_dtoa(bm::State& st)
     report<T>(st);
 }
 
+C4FOR(T, isfloat)
+xtoa_c4_ftoa_scient(bm::State& st)
+{
+    string_buffer buf;
+    random_values<T> values;
+    for(auto _ : st)
+    {
+        c4::ftoa(buf, values.next(), -1, c4::FTOA_SCIENT);
+    }
+    report<T>(st);
+}
+
+C4FOR(T, isdouble)
+xtoa_c4_dtoa_scient(bm::State& st)
+{
+    string_buffer buf;
+    random_values<T> values;
+    for(auto _ : st)
+    {
+        c4::dtoa(buf, values.next(), -1, c4::FTOA_SCIENT);
+    }
+    report<T>(st);
+}
+
+C4FOR(T, isfloat)
+xtoa_c4_ftoa_fixed2(bm::State& st)
+{
+    string_buffer buf;
+    random_values<T> values;
+    for(auto _ : st)
+    {
+        c4::ftoa(buf, values.next(), 2, c4::FTOA_FLOAT);
+    }
+    report<T>(st);
+}
+
+C4FOR(T, isdouble)
+xtoa_c4_dtoa_fixed2(bm::State& st)
+{
+    string_buffer buf;
+    random_values<T> values;
+    for(auto _ : st)
+    {
+        c4::dtoa(buf, values.next(), 2, c4::FTOA_FLOAT);
+    }
+    report<T>(st);
+}
+
 template<class T>
 void xtoa_c4_xtoa(bm::State& st)
 {
@@ -454,6 +773,34 @@ void xtoa_c4_xtoa(bm::State& st)
     report<T>(st);
 }
 
+#if C4CORE_HAVE_INT128
+/** write 128 bit integers (signed if T is signed) with both halves
+ * random. Compare with xtoa_c4_xtoa<uint64_t> */
+template<class T>
+void xtoa_c4_xtoa_int128(bm::State& st)
+{
+    using I = typename std::conditional<std::is_signed<T>::value, c4::detail::i128, c4::detail::u128>::type;
+    string_buffer buf;
+    std::vector<T> hi = mkwide<T>();
+    std::vector<uint64_t> lo = mkwide<uint64_t>();
+    std::vector<I> vals(hi.size());
+    for(size_t i = 0; i < vals.size(); ++i)
+    {
+        vals[i] = static_cast<I>((static_cast<c4::detail::u128>(hi[i] >> (i % 64u)) << 64u) | lo[i]);
+        if(std::is_signed<T>::value && (i & 1u))
+            vals[i] = static_cast<I>(c4::detail::u128(0) - static_cast<c4::detail::u128>(vals[i]));
+    }
+    size_t i = 0;
+    for(auto _ : st)
+    {
+        c4::xtoa(buf, vals[i]);
+        i = (i + 1) % vals.size();
+    }
+    st.SetBytesProcessed(static_cast<int64_t>(st.iterations() * sizeof(I)));
+    st.SetItemsProcessed(static_cast<int64_t>(st.iterations()));
+}
+#endif
+
 
 //-----------------------------------------------------------------------------
 
@@ -517,6 +864,111 @@ void atox_c4_atox(bm::State& st)
     report<T>(st);
 }
 
+template<class T>
+void atox_c4_atox_checked(bm::State& st)
+{
+    random_strings strings = mkstrings<T>();
+    T val; C4_UNUSED(val);
+    for(auto _ : st)
+    {
+        c4::atox_checked(strings.next(), &val);
+    }
+    report<T>(st);
+}
+
+/** join the random strings into a single comma-separated string */
+template<class T>
+std::string mkjoined()
+{
+    random_strings strings = mkstrings<T>();
+    std::string joined;
+    for(std::string const& s : strings.v)
+    {
+        if(!joined.empty())
+            joined += ',';
+        joined += s;
+    }
+    return joined;
+}
+
+template<class T>
+void report_array(bm::State &st, c4::csubstr joined, size_t num_values)
+{
+    st.SetBytesProcessed(static_cast<int64_t>(st.iterations() * joined.len));
+    st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * num_values));
+}
+
+template<class T>
+void atox_c4_parse_array(bm::State& st)
+{
+    std::string joined = mkjoined<T>();
+    c4::csubstr src = c4::to_csubstr(joined);
+    std::vector<T> vals(kNumValues);
+    c4::span<T> out(vals.data(), vals.size());
+    for(auto _ : st)
+    {
+        c4::parse_array_result ret = c4::parse_array(src, ',', out);
+        bm::DoNotOptimize(ret);
+    }
+    report_array<T>(st, src, vals.size());
+}
+
+/** the baseline for parse_array(): split, then convert each field */
+template<class T>
+void atox_c4_next_split_atox(bm::State& st)
+{
+    std::string joined = mkjoined<T>();
+    c4::csubstr src = c4::to_csubstr(joined);
+    std::vector<T> vals(kNumValues);
+    for(auto _ : st)
+    {
+        size_t pos = 0, i = 0;
+        c4::csubstr field;
+        while(src.next_split(',', &pos, &field) && i < vals.size())
+            c4::atox(field, &vals[i++]);
+        bm::DoNotOptimize(vals.data());
+    }
+    report_array<T>(st, src, vals.size());
+}
+
+template<class T>
+void xtoa_c4_to_chars_array(bm::State& st)
+{
+    random_values<T> values;
+    c4::cspan<T> vals(values.v.data(), values.v.size());
+    std::string buf(32u * values.v.size(), '\0');
+    c4::substr out = c4::to_substr(buf);
+    c4::to_chars_array_result ret = {};
+    for(auto _ : st)
+    {
+        ret = c4::to_chars_array(out, vals, ",");
+        bm::DoNotOptimize(ret);
+    }
+    report_array<T>(st, out.first(ret.pos), vals.size());
+}
+
+/** the baseline for to_chars_array(): convert each value, then the separator */
+template<class T>
+void xtoa_c4_xtoa_loop(bm::State& st)
+{
+    random_values<T> values;
+    std::string buf(32u * values.v.size(), '\0');
+    c4::substr out = c4::to_substr(buf);
+    size_t pos = 0;
+    for(auto _ : st)
+    {
+        pos = 0;
+        for(size_t i = 0; i < values.v.size(); ++i)
+        {
+            if(i)
+                out[pos++] = ',';
+            pos += c4::xtoa(out.sub(pos), values.v[i]);
+        }
+        bm::DoNotOptimize(buf.data());
+    }
+    report_array<T>(st, out.first(pos), values.v.size());
+}
+
 
 //-----------------------------------------------------------------------------
 
@@ -756,6 +1208,340 @@ atox_fp_from_chars_unlimited(bm::State &st)
 
 //-----------------------------------------------------------------------------
 
+template<class T>
+void atox_c4_atox_short_decimal(bm::State &st)
+{
+    random_strings strings;
+    strings.init_as_short_decimal();
+    T val = {};
+    for(auto _ : st)
+    {
+        bool ok = c4::atox(strings.next(), &val);
+        bm::DoNotOptimize(ok);
+        bm::DoNotOptimize(val);
+    }
+    report<T>(st);
+}
+
+template<class T>
+void atox_fast_float_short_decimal(bm::State &st)
+{
+    random_strings strings;
+    strings.init_as_short_decimal();
+    T val = {};
+    for(auto _ : st)
+    {
+        c4::csubstr s = strings.next();
+        fast_float::from_chars_result ret = fast_float::from_chars(s.str, s.str + s.len, val);
+        bm::DoNotOptimize(ret);
+        bm::DoNotOptimize(val);
+    }
+    report<T>(st);
+}
+
+/** 16 bit reals (c4::half or c4::bfloat16) from random floats in
+ * [0,1), with some integral values, as in feature vectors */
+template<class T>
+std::vector<T> mkreal16()
+{
+    random_values<float> tmp;
+    std::vector<T> v(tmp.v.size());
+    for(size_t i = 0; i < v.size(); ++i)
+        v[i] = T(tmp.v[i]);
+    return v;
+}
+
+template<class T>
+random_strings mkreal16_strings()
+{
+    std::vector<T> tmp = mkreal16<T>();
+    random_strings rs;
+    for(size_t i = 0; i < rs.v.size(); ++i)
+        c4::catrs(&rs.v[i], tmp[i]);
+    return rs;
+}
+
+/** write the shortest digits of the 16 bit real */
+template<class T>
+void xtoa_c4_real16(bm::State &st)
+{
+    string_buffer buf;
+    std::vector<T> vals = mkreal16<T>();
+    size_t i = 0;
+    for(auto _ : st)
+    {
+        size_t ret = c4::xtoa(buf, vals[i]);
+        bm::DoNotOptimize(ret);
+        i = (i + 1) % vals.size();
+    }
+    report<T>(st);
+}
+
+/** compare with xtoa_c4_real16: widen to float and write that, which
+ * also needs more digits */
+template<class T>
+void xtoa_c4_real16_widened(bm::State &st)
+{
+    string_buffer buf;
+    std::vector<T> vals = mkreal16<T>();
+    size_t i = 0;
+    for(auto _ : st)
+    {
+        size_t ret = c4::xtoa(buf, static_cast<float>(vals[i]));
+        bm::DoNotOptimize(ret);
+        i = (i + 1) % vals.size();
+    }
+    report<T>(st);
+}
+
+/** read the 16 bit real, correctly rounded */
+template<class T>
+void atox_c4_real16(bm::State &st)
+{
+    random_strings strings = mkreal16_strings<T>();
+    T val = {};
+    for(auto _ : st)
+    {
+        bool ok = c4::atox(strings.next(), &val);
+        bm::DoNotOptimize(ok);
+        bm::DoNotOptimize(val);
+    }
+    report<T>(st);
+}
+
+/** compare with atox_c4_real16: read a float and narrow it, which
+ * may round twice */
+template<class T>
+void atox_c4_real16_narrowed(bm::State &st)
+{
+    random_strings strings = mkreal16_strings<T>();
+    T val = {};
+    for(auto _ : st)
+    {
+        float f = 0.f;
+        bool ok = c4::atox(strings.next(), &f);
+        val = T(f);
+        bm::DoNotOptimize(ok);
+        bm::DoNotOptimize(val);
+    }
+    report<T>(st);
+}
+
+inline size_t _write_hexa(c4::substr buf, float v) { return c4::ftoa(buf, v, -1, c4::FTOA_HEXA); }
+inline size_t _write_hexa(c4::substr buf, double v) { return c4::dtoa(buf, v, -1, c4::FTOA_HEXA); }
+
+template<class T>
+random_strings mkhexa_strings()
+{
+    random_values<T> tmp;
+    random_strings rs;
+    char buf[64];
+    for(size_t i = 0; i < rs.v.size(); ++i)
+        rs.v[i].assign(buf, _write_hexa(buf, tmp.v[i]));
+    return rs;
+}
+
+/** write the exact hexadecimal format (%a) */
+template<class T>
+void xtoa_c4_hexa(bm::State &st)
+{
+    string_buffer buf;
+    random_values<T> values;
+    for(auto _ : st)
+    {
+        size_t ret = _write_hexa(buf, values.next());
+        bm::DoNotOptimize(ret);
+    }
+    report<T>(st);
+}
+
+/** compare with xtoa_c4_hexa */
+template<class T>
+void xtoa_sprintf_hexa(bm::State &st)
+{
+    string_buffer buf;
+    random_values<T> values;
+    for(auto _ : st)
+    {
+        int ret = ::snprintf(buf.buf.str, buf.buf.len, "%a", static_cast<double>(values.next()));
+        bm::DoNotOptimize(ret);
+    }
+    report<T>(st);
+}
+
+/** read the exact hexadecimal format */
+template<class T>
+void atox_c4_hexa(bm::State &st)
+{
+    random_strings strings = mkhexa_strings<T>();
+    T val = {};
+    for(auto _ : st)
+    {
+        bool ok = c4::atox(strings.next(), &val);
+        bm::DoNotOptimize(ok);
+        bm::DoNotOptimize(val);
+    }
+    report<T>(st);
+}
+
+/** compare with atox_c4_hexa */
+template<class T>
+void atox_std_strtod_hexa(bm::State &st)
+{
+    random_strings strings = mkhexa_strings<T>();
+    double val = {};
+    for(auto _ : st)
+    {
+        std::string const& s = strings.next_s();
+        val = std::strtod(s.c_str(), nullptr);
+        bm::DoNotOptimize(val);
+    }
+    report<T>(st);
+}
+
+/** write a batch in the exact hexadecimal format; compare with
+ * xtoa_c4_to_chars_array, which writes the shortest decimal */
+template<class T>
+void xtoa_c4_to_chars_array_hexa(bm::State& st)
+{
+    random_values<T> values;
+    c4::cspan<T> vals(values.v.data(), values.v.size());
+    std::string buf(32u * values.v.size(), '\0');
+    c4::substr out = c4::to_substr(buf);
+    c4::to_chars_array_result ret = {};
+    for(auto _ : st)
+    {
+        ret = c4::to_chars_array_hexa(out, vals, ",");
+        bm::DoNotOptimize(ret);
+    }
+    report_array<T>(st, out.first(ret.pos), vals.size());
+}
+
+/** read a batch in the exact hexadecimal format; compare with
+ * atox_c4_parse_array, which reads decimals */
+template<class T>
+void atox_c4_parse_array_hexa(bm::State& st)
+{
+    random_values<T> values;
+    std::string joined(32u * values.v.size(), '\0');
+    c4::to_chars_array_result wret = c4::to_chars_array_hexa(c4::to_substr(joined), c4::cspan<T>(values.v.data(), values.v.size()), ",");
+    joined.resize(wret.pos);
+    c4::csubstr src = c4::to_csubstr(joined);
+    std::vector<T> vals(values.v.size());
+    c4::span<T> out(vals.data(), vals.size());
+    for(auto _ : st)
+    {
+        c4::parse_array_result ret = c4::parse_array(src, ',', out);
+        bm::DoNotOptimize(ret);
+    }
+    report_array<T>(st, src, vals.size());
+}
+
+/** fixed point decimals as found in prices and meter readings: up
+ * to 6 integer digits and 4 decimals, some negative */
+std::vector<c4::decimal<4>> mkdecimal()
+{
+    c4::rng::pcg rng;
+    std::uniform_int_distribution<int64_t> idist(-INT64_C(1000000000), INT64_C(10000000000) - 1);
+    std::vector<c4::decimal<4>> v(kNumValues);
+    for(c4::decimal<4> &d : v)
+        d = c4::decimal<4>::from_raw(idist(rng));
+    return v;
+}
+
+random_strings mkdecimal_strings()
+{
+    std::vector<c4::decimal<4>> tmp = mkdecimal();
+    random_strings rs;
+    for(size_t i = 0; i < rs.v.size(); ++i)
+        c4::catrs(&rs.v[i], tmp[i]);
+    return rs;
+}
+
+/** write a decimal<4> */
+template<class T>
+void xtoa_c4_decimal(bm::State &st)
+{
+    string_buffer buf;
+    std::vector<T> vals = mkdecimal();
+    size_t i = 0;
+    for(auto _ : st)
+    {
+        size_t ret = c4::xtoa(buf, vals[i]);
+        bm::DoNotOptimize(ret);
+        i = (i + 1) % vals.size();
+    }
+    report<T>(st);
+}
+
+/** compare with xtoa_c4_decimal: write the same values as doubles,
+ * with 4 decimals */
+template<class T>
+void xtoa_c4_decimal_as_double(bm::State &st)
+{
+    string_buffer buf;
+    std::vector<T> vals = mkdecimal();
+    std::vector<double> dvals(vals.size());
+    for(size_t j = 0; j < vals.size(); ++j)
+        dvals[j] = static_cast<double>(vals[j]);
+    size_t i = 0;
+    for(auto _ : st)
+    {
+        size_t ret = c4::dtoa(buf, dvals[i], 4, c4::FTOA_FLOAT);
+        bm::DoNotOptimize(ret);
+        i = (i + 1) % dvals.size();
+    }
+    report<T>(st);
+}
+
+/** read a decimal<4> */
+template<class T>
+void atox_c4_decimal(bm::State &st)
+{
+    random_strings strings = mkdecimal_strings();
+    T val = {};
+    for(auto _ : st)
+    {
+        bool ok = c4::atox(strings.next(), &val);
+        bm::DoNotOptimize(ok);
+        bm::DoNotOptimize(val);
+    }
+    report<T>(st);
+}
+
+/** compare with atox_c4_decimal: read the same strings as doubles */
+template<class T>
+void atox_c4_decimal_as_double(bm::State &st)
+{
+    random_strings strings = mkdecimal_strings();
+    double val = {};
+    for(auto _ : st)
+    {
+        bool ok = c4::atox(strings.next(), &val);
+        bm::DoNotOptimize(ok);
+        bm::DoNotOptimize(val);
+    }
+    report<T>(st);
+}
+
+/** compare with atox_c4_decimal: read the same digits, without the
+ * point, as an int64_t */
+template<class T>
+void atox_c4_decimal_as_int(bm::State &st)
+{
+    random_strings strings = mkdecimal_strings();
+    for(std::string &s : strings.v)
+        s.erase(s.find('.'), 1);
+    int64_t val = {};
+    for(auto _ : st)
+    {
+        bool ok = c4::atox(strings.next(), &val);
+        bm::DoNotOptimize(ok);
+        bm::DoNotOptimize(val);
+    }
+    report<T>(st);
+}
+
 template<class T>
 void atox_fast_float(bm::State &st)
 {
@@ -831,6 +1617,18 @@ xtoa_sprintf(bm::State& st)
     report<T>(st);
 }
 
+C4FOR(T, isreal)
+xtoa_sprintf_fixed2(bm::State& st)
+{
+    string_buffer buf;
+    random_values<T> values;
+    for(auto _ : st)
+    {
+        ::snprintf(buf.buf.str, buf.buf.len, "%.2f", (double)values.next());
+    }
+    report<T>(st);
+}
+
 template<class T>
 void atox_scanf(bm::State& st)
 {
@@ -843,6 +1641,22 @@ void atox_scanf(bm::State& st)
     report<T>(st);
 }
 
+/** the native scanner used by atof()/atod() when neither fast_float
+ * nor std::from_chars() are available */
+template<class T>
+void atox_c4_scan_real(bm::State& st)
+{
+    random_strings strings = mkstrings<T>();
+    T val = {};
+    for(auto _ : st)
+    {
+        size_t ret = c4::detail::scan_real(strings.next(), &val);
+        bm::DoNotOptimize(ret);
+        bm::DoNotOptimize(val);
+    }
+    report<T>(st);
+}
+
 
 //-----------------------------------------------------------------------------
 
@@ -998,6 +1812,72 @@ void atox_c4_from_chars(bm::State& st)
     report<T>(st);
 }
 
+template<class T>
+void atox_c4_from_chars_first(bm::State& st)
+{
+    random_strings strings = mkstrings<T>();
+    T val;
+    for(auto _ : st)
+    {
+        size_t ret = c4::from_chars_first(strings.next(), &val);
+        bm::DoNotOptimize(ret);
+        bm::DoNotOptimize(val);
+    }
+    report<T>(st);
+}
+
+template<class T>
+void atox_c4_from_chars_first_checked(bm::State& st)
+{
+    random_strings strings = mkstrings<T>();
+    T val;
+    for(auto _ : st)
+    {
+        c4::parse_result ret = c4::from_chars_first_checked(strings.next(), &val);
+        bm::DoNotOptimize(ret);
+        bm::DoNotOptimize(val);
+    }
+    report<T>(st);
+}
+
+/** numbers followed by a bad character, as in a corrupted record:
+ * find where the reading stopped by scanning the string again, as
+ * was needed before from_chars_first_checked() */
+template<class T>
+void atox_c4_from_chars_first_error_rescan(bm::State& st)
+{
+    random_strings strings = mkstrings<T>();
+    for(std::string &s : strings.v)
+        s += 'x';
+    T val;
+    for(auto _ : st)
+    {
+        c4::csubstr s = strings.next();
+        size_t pos = c4::from_chars_first(s, &val);
+        if(pos == c4::csubstr::npos)
+            pos = s.first_not_of("0123456789+-.eE");
+        bm::DoNotOptimize(pos);
+    }
+    report<T>(st);
+}
+
+/** numbers followed by a bad character: the position comes with the
+ * error */
+template<class T>
+void atox_c4_from_chars_first_error_checked(bm::State& st)
+{
+    random_strings strings = mkstrings<T>();
+    for(std::string &s : strings.v)
+        s += 'x';
+    T val;
+    for(auto _ : st)
+    {
+        c4::parse_result ret = c4::from_chars_first_checked(strings.next(), &val);
+        bm::DoNotOptimize(ret);
+    }
+    report<T>(st);
+}
+
 #if (C4_CPP >= 17) && defined(__cpp_lib_to_chars)
 C4FOR(T, isint)
 xtoa_std_to_chars(bm::State& st)
@@ -1041,9 +1921,13 @@ void atox_std_from_chars(bm::State& st)
 //-----------------------------------------------------------------------------
 
 C4BM_TEMPLATE(xtoa_c4_write_dec,  uint8_t);
+C4BM_TEMPLATE(xtoa_c4_write_dec_zpad,  uint8_t);
 C4BM_TEMPLATE(xtoa_c4_write_hex,  uint8_t);
 C4BM_TEMPLATE(xtoa_c4_write_oct,  uint8_t);
 C4BM_TEMPLATE(xtoa_c4_write_bin,  uint8_t);
+C4BM_TEMPLATE(xtoa_c4_write_hex_wide, uint8_t);
+C4BM_TEMPLATE(xtoa_naive_write_hex_wide, uint8_t);
+C4BM_TEMPLATE(xtoa_c4_write_bin_wide, uint8_t);
 C4BM_TEMPLATE(xtoa_c4_utoa,  uint8_t);
 C4BM_TEMPLATE(xtoa_c4_xtoa,  uint8_t);
 C4BM_TEMPLATE(xtoa_c4_to_chars,  uint8_t);
@@ -1054,9 +1938,13 @@ C4BM_TEMPLATE(xtoa_sstream_reuse,  uint8_t);
 C4BM_TEMPLATE(xtoa_sstream,  uint8_t);
 
 C4BM_TEMPLATE(xtoa_c4_write_dec,  int8_t);
+C4BM_TEMPLATE(xtoa_c4_write_dec_zpad,  int8_t);
 C4BM_TEMPLATE(xtoa_c4_write_hex,  int8_t);
 C4BM_TEMPLATE(xtoa_c4_write_oct,  int8_t);
 C4BM_TEMPLATE(xtoa_c4_write_bin,  int8_t);
+C4BM_TEMPLATE(xtoa_c4_write_hex_wide, int8_t);
+C4BM_TEMPLATE(xtoa_naive_write_hex_wide, int8_t);
+C4BM_TEMPLATE(xtoa_c4_write_bin_wide, int8_t);
 C4BM_TEMPLATE(xtoa_c4_itoa,   int8_t);
 C4BM_TEMPLATE(xtoa_c4_xtoa,   int8_t);
 C4BM_TEMPLATE(xtoa_c4_to_chars,  int8_t);
@@ -1067,9 +1955,13 @@ C4BM_TEMPLATE(xtoa_sstream_reuse,   int8_t);
 C4BM_TEMPLATE(xtoa_sstream,   int8_t);
 
 C4BM_TEMPLATE(xtoa_c4_write_dec,  uint16_t);
+C4BM_TEMPLATE(xtoa_c4_write_dec_zpad,  uint16_t);
 C4BM_TEMPLATE(xtoa_c4_write_hex,  uint16_t);
 C4BM_TEMPLATE(xtoa_c4_write_oct,  uint16_t);
 C4BM_TEMPLATE(xtoa_c4_write_bin,  uint16_t);
+C4BM_TEMPLATE(xtoa_c4_write_hex_wide, uint16_t);
+C4BM_TEMPLATE(xtoa_naive_write_hex_wide, uint16_t);
+C4BM_TEMPLATE(xtoa_c4_write_bin_wide, uint16_t);
 C4BM_TEMPLATE(xtoa_c4_utoa, uint16_t);
 C4BM_TEMPLATE(xtoa_c4_xtoa, uint16_t);
 C4BM_TEMPLATE(xtoa_c4_to_chars,  uint16_t);
@@ -1080,9 +1972,13 @@ C4BM_TEMPLATE(xtoa_sstream_reuse, uint16_t);
 C4BM_TEMPLATE(xtoa_sstream, uint16_t);
 
 C4BM_TEMPLATE(xtoa_c4_write_dec,  int16_t);
+C4BM_TEMPLATE(xtoa_c4_write_dec_zpad,  int16_t);
 C4BM_TEMPLATE(xtoa_c4_write_hex,  int16_t);
 C4BM_TEMPLATE(xtoa_c4_write_oct,  int16_t);
 C4BM_TEMPLATE(xtoa_c4_write_bin,  int16_t);
+C4BM_TEMPLATE(xtoa_c4_write_hex_wide, int16_t);
+C4BM_TEMPLATE(xtoa_naive_write_hex_wide, int16_t);
+C4BM_TEMPLATE(xtoa_c4_write_bin_wide, int16_t);
 C4BM_TEMPLATE(xtoa_c4_itoa,  int16_t);
 C4BM_TEMPLATE(xtoa_c4_xtoa,  int16_t);
 C4BM_TEMPLATE(xtoa_c4_to_chars,  int16_t);
@@ -1093,9 +1989,13 @@ C4BM_TEMPLATE(xtoa_sstream_reuse,  int16_t);
 C4BM_TEMPLATE(xtoa_sstream,  int16_t);
 
 C4BM_TEMPLATE(xtoa_c4_write_dec,  uint32_t);
+C4BM_TEMPLATE(xtoa_c4_write_dec_zpad,  uint32_t);
 C4BM_TEMPLATE(xtoa_c4_write_hex,  uint32_t);
 C4BM_TEMPLATE(xtoa_c4_write_oct,  uint32_t);
 C4BM_TEMPLATE(xtoa_c4_write_bin,  uint32_t);
+C4BM_TEMPLATE(xtoa_c4_write_hex_wide, uint32_t);
+C4BM_TEMPLATE(xtoa_naive_write_hex_wide, uint32_t);
+C4BM_TEMPLATE(xtoa_c4_write_bin_wide, uint32_t);
 C4BM_TEMPLATE(xtoa_c4_utoa, uint32_t);
 C4BM_TEMPLATE(xtoa_c4_xtoa, uint32_t);
 C4BM_TEMPLATE(xtoa_c4_to_chars,  uint32_t);
@@ -1106,9 +2006,13 @@ C4BM_TEMPLATE(xtoa_sstream_reuse, uint32_t);
 C4BM_TEMPLATE(xtoa_sstream, uint32_t);
 
 C4BM_TEMPLATE(xtoa_c4_write_dec,  int32_t);
+C4BM_TEMPLATE(xtoa_c4_write_dec_zpad,  int32_t);
 C4BM_TEMPLATE(xtoa_c4_write_hex,  int32_t);
 C4BM_TEMPLATE(xtoa_c4_write_oct,  int32_t);
 C4BM_TEMPLATE(xtoa_c4_write_bin,  int32_t);
+C4BM_TEMPLATE(xtoa_c4_write_hex_wide, int32_t);
+C4BM_TEMPLATE(xtoa_naive_write_hex_wide, int32_t);
+C4BM_TEMPLATE(xtoa_c4_write_bin_wide, int32_t);
 C4BM_TEMPLATE(xtoa_c4_itoa,  int32_t);
 C4BM_TEMPLATE(xtoa_c4_xtoa,  int32_t);
 C4BM_TEMPLATE(xtoa_c4_to_chars,  int32_t);
@@ -1119,11 +2023,18 @@ C4BM_TEMPLATE(xtoa_sstream_reuse,  int32_t);
 C4BM_TEMPLATE(xtoa_sstream,  int32_t);
 
 C4BM_TEMPLATE(xtoa_c4_write_dec,  uint64_t);
+C4BM_TEMPLATE(xtoa_c4_write_dec_zpad,  uint64_t);
 C4BM_TEMPLATE(xtoa_c4_write_hex,  uint64_t);
 C4BM_TEMPLATE(xtoa_c4_write_oct,  uint64_t);
 C4BM_TEMPLATE(xtoa_c4_write_bin,  uint64_t);
+C4BM_TEMPLATE(xtoa_c4_write_hex_wide, uint64_t);
+C4BM_TEMPLATE(xtoa_naive_write_hex_wide, uint64_t);
+C4BM_TEMPLATE(xtoa_c4_write_bin_wide, uint64_t);
 C4BM_TEMPLATE(xtoa_c4_utoa, uint64_t);
 C4BM_TEMPLATE(xtoa_c4_xtoa, uint64_t);
+#if C4CORE_HAVE_INT128
+C4BM_TEMPLATE(xtoa_c4_xtoa_int128, uint64_t);
+#endif
 C4BM_TEMPLATE(xtoa_c4_to_chars,  uint64_t);
 C4BM_TEMPLATE_CPP17(xtoa_std_to_chars,  uint64_t);
 C4BM_TEMPLATE(xtoa_std_to_string,  uint64_t);
@@ -1132,11 +2043,18 @@ C4BM_TEMPLATE(xtoa_sstream_reuse, uint64_t);
 C4BM_TEMPLATE(xtoa_sstream, uint64_t);
 
 C4BM_TEMPLATE(xtoa_c4_write_dec,  int64_t);
+C4BM_TEMPLATE(xtoa_c4_write_dec_zpad,  int64_t);
 C4BM_TEMPLATE(xtoa_c4_write_hex,  int64_t);
 C4BM_TEMPLATE(xtoa_c4_write_oct,  int64_t);
 C4BM_TEMPLATE(xtoa_c4_write_bin,  int64_t);
+C4BM_TEMPLATE(xtoa_c4_write_hex_wide, int64_t);
+C4BM_TEMPLATE(xtoa_naive_write_hex_wide, int64_t);
+C4BM_TEMPLATE(xtoa_c4_write_bin_wide, int64_t);
 C4BM_TEMPLATE(xtoa_c4_itoa,  int64_t);
 C4BM_TEMPLATE(xtoa_c4_xtoa,  int64_t);
+#if C4CORE_HAVE_INT128
+C4BM_TEMPLATE(xtoa_c4_xtoa_int128, int64_t);
+#endif
 C4BM_TEMPLATE(xtoa_c4_to_chars,  int64_t);
 C4BM_TEMPLATE_CPP17(xtoa_std_to_chars,  int64_t);
 C4BM_TEMPLATE(xtoa_std_to_string,  int64_t);
@@ -1145,6 +2063,8 @@ C4BM_TEMPLATE(xtoa_sstream_reuse,  int64_t);
 C4BM_TEMPLATE(xtoa_sstream,  int64_t);
 
 C4BM_TEMPLATE(xtoa_c4_ftoa,  float);
+C4BM_TEMPLATE(xtoa_c4_ftoa_scient,  float);
+C4BM_TEMPLATE(xtoa_c4_ftoa_fixed2,  float);
 C4BM_TEMPLATE(xtoa_c4_xtoa,  float);
 C4BM_TEMPLATE(xtoa_c4_to_chars,  float);
 #ifdef C4CORE_BM_USE_RYU
@@ -1153,10 +2073,13 @@ C4BM_TEMPLATE(xtoa_ryu_f2s,  float);
 C4BM_TEMPLATE_CPP17(xtoa_std_to_chars,  float);
 C4BM_TEMPLATE(xtoa_std_to_string,  float);
 C4BM_TEMPLATE(xtoa_sprintf,  float);
+C4BM_TEMPLATE(xtoa_sprintf_fixed2,  float);
 C4BM_TEMPLATE(xtoa_sstream_reuse,  float);
 C4BM_TEMPLATE(xtoa_sstream,  float);
 
 C4BM_TEMPLATE(xtoa_c4_dtoa,  double);
+C4BM_TEMPLATE(xtoa_c4_dtoa_scient,  double);
+C4BM_TEMPLATE(xtoa_c4_dtoa_fixed2,  double);
 C4BM_TEMPLATE(xtoa_c4_xtoa,  double);
 C4BM_TEMPLATE(xtoa_c4_to_chars,  double);
 #ifdef C4CORE_BM_USE_RYU
@@ -1165,6 +2088,7 @@ C4BM_TEMPLATE(xtoa_ryu_d2s,  double);
 C4BM_TEMPLATE_CPP17(xtoa_std_to_chars,  double);
 C4BM_TEMPLATE(xtoa_std_to_string,  double);
 C4BM_TEMPLATE(xtoa_sprintf,  double);
+C4BM_TEMPLATE(xtoa_sprintf_fixed2,  double);
 C4BM_TEMPLATE(xtoa_sstream_reuse,  double);
 C4BM_TEMPLATE(xtoa_sstream,  double);
 
@@ -1174,12 +2098,24 @@ C4BM_TEMPLATE(xtoa_sstream,  double);
 //-----------------------------------------------------------------------------
 
 C4BM_TEMPLATE(atox_c4_read_dec, uint8_t);
+C4BM_TEMPLATE(atox_scalar_read_dec, uint8_t);
+C4BM_TEMPLATE(atox_c4_read_dec_long, uint8_t);
+C4BM_TEMPLATE(atox_scalar_read_dec_long, uint8_t);
 C4BM_TEMPLATE(atox_c4_read_hex, uint8_t);
 C4BM_TEMPLATE(atox_c4_read_oct, uint8_t);
 C4BM_TEMPLATE(atox_c4_read_bin, uint8_t);
+C4BM_TEMPLATE(atox_c4_read_hex_wide, uint8_t);
+C4BM_TEMPLATE(atox_naive_read_hex_wide, uint8_t);
 C4BM_TEMPLATE(atox_c4_atou,  uint8_t);
 C4BM_TEMPLATE(atox_c4_atox,  uint8_t);
+C4BM_TEMPLATE(atox_c4_atox_checked, uint8_t);
+C4BM_TEMPLATE(atox_c4_parse_array, uint8_t);
+C4BM_TEMPLATE(atox_c4_next_split_atox, uint8_t);
+C4BM_TEMPLATE(xtoa_c4_to_chars_array, uint8_t);
+C4BM_TEMPLATE(xtoa_c4_xtoa_loop, uint8_t);
 C4BM_TEMPLATE(atox_c4_from_chars, uint8_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first, uint8_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first_checked, uint8_t);
 C4BM_TEMPLATE_CPP17(atox_std_from_chars, uint8_t);
 C4BM_TEMPLATE(atox_std_atoi,   uint8_t);
 C4BM_TEMPLATE(atox_std_strtoul,   uint8_t);
@@ -1188,12 +2124,24 @@ C4BM_TEMPLATE(atox_sstream,   uint8_t);
 C4BM_TEMPLATE(atox_sstream_reuse,   uint8_t);
 
 C4BM_TEMPLATE(atox_c4_read_dec, int8_t);
+C4BM_TEMPLATE(atox_scalar_read_dec, int8_t);
+C4BM_TEMPLATE(atox_c4_read_dec_long, int8_t);
+C4BM_TEMPLATE(atox_scalar_read_dec_long, int8_t);
 C4BM_TEMPLATE(atox_c4_read_hex, int8_t);
 C4BM_TEMPLATE(atox_c4_read_oct, int8_t);
 C4BM_TEMPLATE(atox_c4_read_bin, int8_t);
+C4BM_TEMPLATE(atox_c4_read_hex_wide, int8_t);
+C4BM_TEMPLATE(atox_naive_read_hex_wide, int8_t);
 C4BM_TEMPLATE(atox_c4_atoi,   int8_t);
 C4BM_TEMPLATE(atox_c4_atox,   int8_t);
+C4BM_TEMPLATE(atox_c4_atox_checked, int8_t);
+C4BM_TEMPLATE(atox_c4_parse_array, int8_t);
+C4BM_TEMPLATE(atox_c4_next_split_atox, int8_t);
+C4BM_TEMPLATE(xtoa_c4_to_chars_array, int8_t);
+C4BM_TEMPLATE(xtoa_c4_xtoa_loop, int8_t);
 C4BM_TEMPLATE(atox_c4_from_chars, int8_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first, int8_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first_checked, int8_t);
 C4BM_TEMPLATE_CPP17(atox_std_from_chars, int8_t);
 C4BM_TEMPLATE(atox_std_atoi,   int8_t);
 C4BM_TEMPLATE(atox_std_strtol,   int8_t);
@@ -1202,12 +2150,24 @@ C4BM_TEMPLATE(atox_sstream,   int8_t);
 C4BM_TEMPLATE(atox_sstream_reuse,   int8_t);
 
 C4BM_TEMPLATE(atox_c4_read_dec, uint16_t);
+C4BM_TEMPLATE(atox_scalar_read_dec, uint16_t);
+C4BM_TEMPLATE(atox_c4_read_dec_long, uint16_t);
+C4BM_TEMPLATE(atox_scalar_read_dec_long, uint16_t);
 C4BM_TEMPLATE(atox_c4_read_hex, uint16_t);
 C4BM_TEMPLATE(atox_c4_read_oct, uint16_t);
 C4BM_TEMPLATE(atox_c4_read_bin, uint16_t);
+C4BM_TEMPLATE(atox_c4_read_hex_wide, uint16_t);
+C4BM_TEMPLATE(atox_naive_read_hex_wide, uint16_t);
 C4BM_TEMPLATE(atox_c4_atou, uint16_t);
 C4BM_TEMPLATE(atox_c4_atox, uint16_t);
+C4BM_TEMPLATE(atox_c4_atox_checked, uint16_t);
+C4BM_TEMPLATE(atox_c4_parse_array, uint16_t);
+C4BM_TEMPLATE(atox_c4_next_split_atox, uint16_t);
+C4BM_TEMPLATE(xtoa_c4_to_chars_array, uint16_t);
+C4BM_TEMPLATE(xtoa_c4_xtoa_loop, uint16_t);
 C4BM_TEMPLATE(atox_c4_from_chars, uint16_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first, uint16_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first_checked, uint16_t);
 C4BM_TEMPLATE_CPP17(atox_std_from_chars, uint16_t);
 C4BM_TEMPLATE(atox_std_atoi,   uint16_t);
 C4BM_TEMPLATE(atox_std_strtoul,   uint16_t);
@@ -1216,12 +2176,24 @@ C4BM_TEMPLATE(atox_sstream,   uint16_t);
 C4BM_TEMPLATE(atox_sstream_reuse,   uint16_t);
 
 C4BM_TEMPLATE(atox_c4_read_dec, int16_t);
+C4BM_TEMPLATE(atox_scalar_read_dec, int16_t);
+C4BM_TEMPLATE(atox_c4_read_dec_long, int16_t);
+C4BM_TEMPLATE(atox_scalar_read_dec_long, int16_t);
 C4BM_TEMPLATE(atox_c4_read_hex, int16_t);
 C4BM_TEMPLATE(atox_c4_read_oct, int16_t);
 C4BM_TEMPLATE(atox_c4_read_bin, int16_t);
+C4BM_TEMPLATE(atox_c4_read_hex_wide, int16_t);
+C4BM_TEMPLATE(atox_naive_read_hex_wide, int16_t);
 C4BM_TEMPLATE(atox_c4_atoi,  int16_t);
 C4BM_TEMPLATE(atox_c4_atox,  int16_t);
+C4BM_TEMPLATE(atox_c4_atox_checked, int16_t);
+C4BM_TEMPLATE(atox_c4_parse_array, int16_t);
+C4BM_TEMPLATE(atox_c4_next_split_atox, int16_t);
+C4BM_TEMPLATE(xtoa_c4_to_chars_array, int16_t);
+C4BM_TEMPLATE(xtoa_c4_xtoa_loop, int16_t);
 C4BM_TEMPLATE(atox_c4_from_chars, int16_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first, int16_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first_checked, int16_t);
 C4BM_TEMPLATE_CPP17(atox_std_from_chars, int16_t);
 C4BM_TEMPLATE(atox_std_atoi,   int16_t);
 C4BM_TEMPLATE(atox_std_strtol,   int16_t);
@@ -1230,12 +2202,24 @@ C4BM_TEMPLATE(atox_sstream,   int16_t);
 C4BM_TEMPLATE(atox_sstream_reuse,   int16_t);
 
 C4BM_TEMPLATE(atox_c4_read_dec, uint32_t);
+C4BM_TEMPLATE(atox_scalar_read_dec, uint32_t);
+C4BM_TEMPLATE(atox_c4_read_dec_long, uint32_t);
+C4BM_TEMPLATE(atox_scalar_read_dec_long, uint32_t);
 C4BM_TEMPLATE(atox_c4_read_hex, uint32_t);
 C4BM_TEMPLATE(atox_c4_read_oct, uint32_t);
 C4BM_TEMPLATE(atox_c4_read_bin, uint32_t);
+C4BM_TEMPLATE(atox_c4_read_hex_wide, uint32_t);
+C4BM_TEMPLATE(atox_naive_read_hex_wide, uint32_t);
 C4BM_TEMPLATE(atox_c4_atou, uint32_t);
 C4BM_TEMPLATE(atox_c4_atox, uint32_t);
+C4BM_TEMPLATE(atox_c4_atox_checked, uint32_t);
+C4BM_TEMPLATE(atox_c4_parse_array, uint32_t);
+C4BM_TEMPLATE(atox_c4_next_split_atox, uint32_t);
+C4BM_TEMPLATE(xtoa_c4_to_chars_array, uint32_t);
+C4BM_TEMPLATE(xtoa_c4_xtoa_loop, uint32_t);
 C4BM_TEMPLATE(atox_c4_from_chars, uint32_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first, uint32_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first_checked, uint32_t);
 C4BM_TEMPLATE_CPP17(atox_std_from_chars, uint32_t);
 C4BM_TEMPLATE(atox_std_atoi,   uint32_t);
 C4BM_TEMPLATE(atox_std_strtoul,   uint32_t);
@@ -1244,12 +2228,26 @@ C4BM_TEMPLATE(atox_sstream,   uint32_t);
 C4BM_TEMPLATE(atox_sstream_reuse,   uint32_t);
 
 C4BM_TEMPLATE(atox_c4_read_dec, int32_t);
+C4BM_TEMPLATE(atox_scalar_read_dec, int32_t);
+C4BM_TEMPLATE(atox_c4_read_dec_long, int32_t);
+C4BM_TEMPLATE(atox_scalar_read_dec_long, int32_t);
 C4BM_TEMPLATE(atox_c4_read_hex, int32_t);
 C4BM_TEMPLATE(atox_c4_read_oct, int32_t);
 C4BM_TEMPLATE(atox_c4_read_bin, int32_t);
+C4BM_TEMPLATE(atox_c4_read_hex_wide, int32_t);
+C4BM_TEMPLATE(atox_naive_read_hex_wide, int32_t);
 C4BM_TEMPLATE(atox_c4_atoi,  int32_t);
 C4BM_TEMPLATE(atox_c4_atox,  int32_t);
+C4BM_TEMPLATE(atox_c4_atox_checked, int32_t);
+C4BM_TEMPLATE(atox_c4_parse_array, int32_t);
+C4BM_TEMPLATE(atox_c4_next_split_atox, int32_t);
+C4BM_TEMPLATE(xtoa_c4_to_chars_array, int32_t);
+C4BM_TEMPLATE(xtoa_c4_xtoa_loop, int32_t);
 C4BM_TEMPLATE(atox_c4_from_chars, int32_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first, int32_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first_checked, int32_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first_error_rescan, int32_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first_error_checked, int32_t);
 C4BM_TEMPLATE_CPP17(atox_std_from_chars, int32_t);
 C4BM_TEMPLATE(atox_std_atoi,   int32_t);
 C4BM_TEMPLATE(atox_std_strtol,   int32_t);
@@ -1258,12 +2256,24 @@ C4BM_TEMPLATE(atox_sstream,   int32_t);
 C4BM_TEMPLATE(atox_sstream_reuse,   int32_t);
 
 C4BM_TEMPLATE(atox_c4_read_dec, uint64_t);
+C4BM_TEMPLATE(atox_scalar_read_dec, uint64_t);
+C4BM_TEMPLATE(atox_c4_read_dec_long, uint64_t);
+C4BM_TEMPLATE(atox_scalar_read_dec_long, uint64_t);
 C4BM_TEMPLATE(atox_c4_read_hex, uint64_t);
 C4BM_TEMPLATE(atox_c4_read_oct, uint64_t);
 C4BM_TEMPLATE(atox_c4_read_bin, uint64_t);
+C4BM_TEMPLATE(atox_c4_read_hex_wide, uint64_t);
+C4BM_TEMPLATE(atox_naive_read_hex_wide, uint64_t);
 C4BM_TEMPLATE(atox_c4_atou, uint64_t);
 C4BM_TEMPLATE(atox_c4_atox, uint64_t);
+C4BM_TEMPLATE(atox_c4_atox_checked, uint64_t);
+C4BM_TEMPLATE(atox_c4_parse_array, uint64_t);
+C4BM_TEMPLATE(atox_c4_next_split_atox, uint64_t);
+C4BM_TEMPLATE(xtoa_c4_to_chars_array, uint64_t);
+C4BM_TEMPLATE(xtoa_c4_xtoa_loop, uint64_t);
 C4BM_TEMPLATE(atox_c4_from_chars, uint64_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first, uint64_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first_checked, uint64_t);
 C4BM_TEMPLATE_CPP17(atox_std_from_chars, uint64_t);
 C4BM_TEMPLATE(atox_std_atol,   uint64_t);
 C4BM_TEMPLATE(atox_std_strtoull,   uint64_t);
@@ -1272,12 +2282,26 @@ C4BM_TEMPLATE(atox_sstream,   uint64_t);
 C4BM_TEMPLATE(atox_sstream_reuse,   uint64_t);
 
 C4BM_TEMPLATE(atox_c4_read_dec, int64_t);
+C4BM_TEMPLATE(atox_scalar_read_dec, int64_t);
+C4BM_TEMPLATE(atox_c4_read_dec_long, int64_t);
+C4BM_TEMPLATE(atox_scalar_read_dec_long, int64_t);
 C4BM_TEMPLATE(atox_c4_read_hex, int64_t);
 C4BM_TEMPLATE(atox_c4_read_oct, int64_t);
 C4BM_TEMPLATE(atox_c4_read_bin, int64_t);
+C4BM_TEMPLATE(atox_c4_read_hex_wide, int64_t);
+C4BM_TEMPLATE(atox_naive_read_hex_wide, int64_t);
 C4BM_TEMPLATE(atox_c4_atoi,  int64_t);
 C4BM_TEMPLATE(atox_c4_atox,  int64_t);
+C4BM_TEMPLATE(atox_c4_atox_checked, int64_t);
+C4BM_TEMPLATE(atox_c4_parse_array, int64_t);
+C4BM_TEMPLATE(atox_c4_next_split_atox, int64_t);
+C4BM_TEMPLATE(xtoa_c4_to_chars_array, int64_t);
+C4BM_TEMPLATE(xtoa_c4_xtoa_loop, int64_t);
 C4BM_TEMPLATE(atox_c4_from_chars, int64_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first, int64_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first_checked, int64_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first_error_rescan, int64_t);
+C4BM_TEMPLATE(atox_c4_from_chars_first_error_checked, int64_t);
 C4BM_TEMPLATE_CPP17(atox_std_from_chars, int64_t);
 C4BM_TEMPLATE(atox_std_atol,   int64_t);
 C4BM_TEMPLATE(atox_std_strtoll,   int64_t);
@@ -1287,7 +2311,15 @@ C4BM_TEMPLATE(atox_sstream_reuse,   int64_t);
 
 C4BM_TEMPLATE(atox_c4_atof,  float);
 C4BM_TEMPLATE(atox_c4_atox,  float);
+C4BM_TEMPLATE(atox_c4_parse_array, float);
+C4BM_TEMPLATE(atox_c4_next_split_atox, float);
+C4BM_TEMPLATE(xtoa_c4_to_chars_array, float);
+C4BM_TEMPLATE(xtoa_c4_xtoa_loop, float);
 C4BM_TEMPLATE(atox_c4_from_chars, float);
+C4BM_TEMPLATE(atox_c4_from_chars_first, float);
+C4BM_TEMPLATE(atox_c4_from_chars_first_checked, float);
+C4BM_TEMPLATE(atox_c4_atox_short_decimal, float);
+C4BM_TEMPLATE(atox_fast_float_short_decimal, float);
 #ifdef C4CORE_BM_USE_RYU
 C4BM_TEMPLATE(atox_ryu_s2f,  float);
 #endif
@@ -1298,13 +2330,24 @@ C4BM_FP_BENCHMARK(atox_fp_from_chars_unlimited,  float);
 C4BM_TEMPLATE(atox_std_atof,   float);
 C4BM_TEMPLATE(atox_std_strtof,   float);
 C4BM_TEMPLATE(atox_std_stof,   float);
+C4BM_TEMPLATE(atox_c4_scan_real,   float);
 C4BM_TEMPLATE(atox_scanf,   float);
 C4BM_TEMPLATE(atox_sstream,   float);
 C4BM_TEMPLATE(atox_sstream_reuse,   float);
 
 C4BM_TEMPLATE(atox_c4_atod,  double);
 C4BM_TEMPLATE(atox_c4_atox,  double);
+C4BM_TEMPLATE(atox_c4_parse_array, double);
+C4BM_TEMPLATE(atox_c4_next_split_atox, double);
+C4BM_TEMPLATE(xtoa_c4_to_chars_array, double);
+C4BM_TEMPLATE(xtoa_c4_xtoa_loop, double);
 C4BM_TEMPLATE(atox_c4_from_chars, double);
+C4BM_TEMPLATE(atox_c4_from_chars_first, double);
+C4BM_TEMPLATE(atox_c4_from_chars_first_checked, double);
+C4BM_TEMPLATE(atox_c4_from_chars_first_error_rescan, double);
+C4BM_TEMPLATE(atox_c4_from_chars_first_error_checked, double);
+C4BM_TEMPLATE(atox_c4_atox_short_decimal, double);
+C4BM_TEMPLATE(atox_fast_float_short_decimal, double);
 #ifdef C4CORE_BM_USE_RYU
 C4BM_TEMPLATE(atox_ryu_s2d,  double);
 #endif
@@ -1315,10 +2358,39 @@ C4BM_FP_BENCHMARK(atox_fp_from_chars_unlimited,  double);
 C4BM_TEMPLATE(atox_std_atof,   double);
 C4BM_TEMPLATE(atox_std_strtod,   double);
 C4BM_TEMPLATE(atox_std_stod,   double);
+C4BM_TEMPLATE(atox_c4_scan_real,   double);
 C4BM_TEMPLATE(atox_scanf,   double);
 C4BM_TEMPLATE(atox_sstream,   double);
 C4BM_TEMPLATE(atox_sstream_reuse,   double);
 
+C4BM_TEMPLATE(xtoa_c4_hexa, float);
+C4BM_TEMPLATE(xtoa_sprintf_hexa, float);
+C4BM_TEMPLATE(atox_c4_hexa, float);
+C4BM_TEMPLATE(atox_std_strtod_hexa, float);
+C4BM_TEMPLATE(xtoa_c4_to_chars_array_hexa, float);
+C4BM_TEMPLATE(atox_c4_parse_array_hexa, float);
+C4BM_TEMPLATE(xtoa_c4_hexa, double);
+C4BM_TEMPLATE(xtoa_sprintf_hexa, double);
+C4BM_TEMPLATE(atox_c4_hexa, double);
+C4BM_TEMPLATE(atox_std_strtod_hexa, double);
+C4BM_TEMPLATE(xtoa_c4_to_chars_array_hexa, double);
+C4BM_TEMPLATE(atox_c4_parse_array_hexa, double);
+
+C4BM_TEMPLATE(xtoa_c4_decimal, c4::decimal<4>);
+C4BM_TEMPLATE(xtoa_c4_decimal_as_double, c4::decimal<4>);
+C4BM_TEMPLATE(atox_c4_decimal, c4::decimal<4>);
+C4BM_TEMPLATE(atox_c4_decimal_as_double, c4::decimal<4>);
+C4BM_TEMPLATE(atox_c4_decimal_as_int, c4::decimal<4>);
+
+C4BM_TEMPLATE(xtoa_c4_real16, c4::half);
+C4BM_TEMPLATE(xtoa_c4_real16_widened, c4::half);
+C4BM_TEMPLATE(atox_c4_real16, c4::half);
+C4BM_TEMPLATE(atox_c4_real16_narrowed, c4::half);
+C4BM_TEMPLATE(xtoa_c4_real16, c4::bfloat16);
+C4BM_TEMPLATE(xtoa_c4_real16_widened, c4::bfloat16);
+C4BM_TEMPLATE(atox_c4_real16, c4::bfloat16);
+C4BM_TEMPLATE(atox_c4_real16_narrowed, c4::bfloat16);
+
 
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
@@ -3,12 +3,18 @@
 #include <c4/std/std.hpp>
 #include <c4/format.hpp>
 #include <c4/dump.hpp>
+#include <c4/scanner.hpp>
 #include <sstream>
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
 #include <vector>
 #include <benchmark/benchmark.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 namespace bm = benchmark;
 
@@ -121,6 +127,42 @@ struct lambda_style
     ~lambda_style() { fclose(subject); }
     FILE * subject;
 };
+/** bypasses the stdio buffer, so that each call to the dumper is a
+ * call to write(), ie a syscall. Counts the calls. */
+struct fd_style
+{
+    FILE * subject;
+    int fd;
+    size_t num_writes;
+    fd_style() : subject(fopen("asdkjhasdkjhsdfoiefkjn", "wb")), num_writes(0)
+    {
+        #ifdef _WIN32
+        fd = _fileno(subject);
+        #else
+        fd = fileno(subject);
+        #endif
+    }
+    ~fd_style() { fclose(subject); }
+    void operator() (c4::csubstr s)
+    {
+        ++num_writes;
+        #ifdef _WIN32
+        (void)_write(fd, s.str, (unsigned)s.len);
+        #else
+        (void)!write(fd, s.str, s.len);
+        #endif
+    }
+};
+/** a copyable sink for c4::dump_buffer, forwarding to fd_style */
+struct fd_sink
+{
+    fd_style *dumper;
+    void operator() (c4::csubstr s) const { (*dumper)(s); }
+};
+void report_writes(bm::State &st, fd_style const& dumper)
+{
+    st.counters["writes"] = bm::Counter(static_cast<double>(dumper.num_writes), bm::Counter::kAvgIterations);
+}
 } // namespace dump2fil
 
 template<class T>
@@ -397,6 +439,37 @@ void catfile_c4catdump_lambda_style(bm::State &st)
     report(st, sz);
 }
 
+void catfile_c4catdump_fd_unbuffered(bm::State &st)
+{
+    char buf_[256];
+    c4::substr buf(buf_);
+    size_t sz = c4::cat(buf, _c4argbundle);
+    dump2file::fd_style dumper;
+    for(auto _ : st)
+    {
+        c4::cat_dump(dumper, buf, _c4argbundle);
+    }
+    report(st, sz);
+    dump2file::report_writes(st, dumper);
+}
+
+void catfile_c4dumpbuffer_fd(bm::State &st)
+{
+    char buf_[256];
+    size_t sz = c4::cat(buf_, _c4argbundle);
+    char mem[4096];
+    dump2file::fd_style dumper;
+    {
+        c4::dump_buffer<dump2file::fd_sink> out(c4::substr(mem, sizeof(mem)), dump2file::fd_sink{&dumper});
+        for(auto _ : st)
+        {
+            out.cat(_c4argbundle);
+        }
+    }
+    report(st, sz);
+    dump2file::report_writes(st, dumper);
+}
+
 void catfile_fprintf(bm::State &st)
 {
     char buf[256];
@@ -664,6 +737,31 @@ void format_c4format(bm::State &st)
     report(st, sz);
 }
 
+void format_c4format_ct(bm::State &st)
+{
+    char buf_[512];
+    c4::substr buf(buf_);
+    size_t sz = 0;
+    for(auto _ : st)
+    {
+        sz = format(buf, C4_FMT(_c4argbundle_fmt), _c4argbundle);
+    }
+    report(st, sz);
+}
+
+void format_c4format_compiled(bm::State &st)
+{
+    char buf_[512];
+    c4::substr buf(buf_);
+    const c4::compiled_format cf(_c4argbundle_fmt);
+    size_t sz = 0;
+    for(auto _ : st)
+    {
+        sz = format(buf, cf, _c4argbundle);
+    }
+    report(st, sz);
+}
+
 void format_c4formatrs_reuse(bm::State &st)
 {
     std::string buf;
@@ -676,6 +774,31 @@ void format_c4formatrs_reuse(bm::State &st)
     report(st, sz);
 }
 
+void format_c4formatrs_ct_reuse(bm::State &st)
+{
+    std::string buf;
+    size_t sz = 0;
+    for(auto _ : st)
+    {
+        c4::formatrs(&buf, C4_FMT(_c4argbundle_fmt), _c4argbundle);
+        sz = buf.size();
+    }
+    report(st, sz);
+}
+
+void format_c4formatrs_compiled_reuse(bm::State &st)
+{
+    std::string buf;
+    const c4::compiled_format cf(_c4argbundle_fmt);
+    size_t sz = 0;
+    for(auto _ : st)
+    {
+        c4::formatrs(&buf, cf, _c4argbundle);
+        sz = buf.size();
+    }
+    report(st, sz);
+}
+
 void format_c4formatrs_no_reuse(bm::State &st)
 {
     size_t sz = 0;
@@ -699,6 +822,18 @@ void format_c4formatdump_c_style_static_dispatch(bm::State &st)
     report(st, sz);
 }
 
+void format_c4formatdump_ct_c_style_static_dispatch(bm::State &st)
+{
+    char buf_[256];
+    c4::substr buf(buf_);
+    size_t sz = c4::format(buf, _c4argbundle_fmt, _c4argbundle);
+    for(auto _ : st)
+    {
+        c4::format_dump<&dump2str::c_style>(buf, C4_FMT(_c4argbundle_fmt), _c4argbundle);
+    }
+    report(st, sz);
+}
+
 void format_c4formatdump_c_style_dynamic_dispatch(bm::State &st)
 {
     char buf_[256];
@@ -810,6 +945,37 @@ void formatfile_c4formatdump_lambda_style(bm::State &st)
     report(st, sz);
 }
 
+void formatfile_c4formatdump_fd_unbuffered(bm::State &st)
+{
+    char buf_[256];
+    c4::substr buf(buf_);
+    size_t sz = c4::format(buf, _c4argbundle_fmt, _c4argbundle);
+    dump2file::fd_style dumper;
+    for(auto _ : st)
+    {
+        c4::format_dump(dumper, buf, _c4argbundle_fmt, _c4argbundle);
+    }
+    report(st, sz);
+    dump2file::report_writes(st, dumper);
+}
+
+void formatfile_c4dumpbuffer_fd(bm::State &st)
+{
+    char buf_[256];
+    size_t sz = c4::format(buf_, _c4argbundle_fmt, _c4argbundle);
+    char mem[4096];
+    dump2file::fd_style dumper;
+    {
+        c4::dump_buffer<dump2file::fd_sink> out(c4::substr(mem, sizeof(mem)), dump2file::fd_sink{&dumper});
+        for(auto _ : st)
+        {
+            out.format(_c4argbundle_fmt, _c4argbundle);
+        }
+    }
+    report(st, sz);
+    dump2file::report_writes(st, dumper);
+}
+
 void formatfile_fprintf(bm::State &st)
 {
     char buf[256];
@@ -823,6 +989,258 @@ void formatfile_fprintf(bm::State &st)
 }
 
 
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+#define _c4alignbundle(align) \
+    c4::fmt::align(c4::fmt::real(3.14159265358979, 6), 16),    \
+    c4::fmt::align(uint64_t(18446744073709551615u), 24),       \
+    c4::fmt::align(c4::fmt::real(-2.5e-10, 9), 20),             \
+    c4::fmt::align(int64_t(-922337203685477580), 24)
+
+void align_c4cat_left(bm::State &st)
+{
+    char buf_[256];
+    c4::substr buf(buf_);
+    size_t sz = 0;
+    for(auto _ : st)
+    {
+        sz = c4::cat(buf, _c4alignbundle(left));
+    }
+    report(st, sz);
+}
+
+void align_c4cat_right(bm::State &st)
+{
+    char buf_[256];
+    c4::substr buf(buf_);
+    size_t sz = 0;
+    for(auto _ : st)
+    {
+        sz = c4::cat(buf, _c4alignbundle(right));
+    }
+    report(st, sz);
+}
+
+void align_snprintf(bm::State &st)
+{
+    char buf[256];
+    size_t sz = 0;
+    for(auto _ : st)
+    {
+        int ret = snprintf(buf, sizeof(buf), "%16.6f%24llu%20.9f%24lld", 3.14159265358979, 18446744073709551615ull, -2.5e-10, -922337203685477580ll);
+        sz = static_cast<size_t>(ret);
+    }
+    report(st, sz);
+}
+
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+std::string make_scan_numbers()
+{
+    std::string lines;
+    for(int i = 0; i < 1000; ++i)
+        c4::catseprs(c4::append, &lines, ' ', 1700000000 + i, i * 37, -i, i % 7, '\n');
+    return lines;
+}
+
+std::string make_scan_fields()
+{
+    std::string lines;
+    for(int i = 0; i < 1000; ++i)
+        c4::formatrs(c4::append, &lines, "GET /item/{} HTTP/1.{}\r\n", i * 37, i % 2);
+    return lines;
+}
+
+void scan_c4uncat(bm::State &st)
+{
+    const std::string lines = make_scan_numbers();
+    const c4::csubstr buf = c4::to_csubstr(lines);
+    int64_t sum = 0;
+    for(auto _ : st)
+    {
+        sum = 0;
+        c4::csubstr rem = buf;
+        int a = 0, b = 0, c = 0, d = 0;
+        while(rem.len > 1)
+        {
+            size_t num = c4::uncat(rem, a, b, c, d);
+            if(num == c4::csubstr::npos)
+                break;
+            rem = rem.sub(num);
+            sum += a + b + c + d;
+        }
+    }
+    C4_CHECK(sum != 0);
+    report(st, buf.len);
+}
+
+void scan_c4scanner(bm::State &st)
+{
+    const std::string lines = make_scan_numbers();
+    const c4::csubstr buf = c4::to_csubstr(lines);
+    int64_t sum = 0;
+    for(auto _ : st)
+    {
+        sum = 0;
+        c4::scanner sc(buf);
+        int a = 0, b = 0, c = 0, d = 0;
+        while(sc.skip_ws(), !sc.at_end())
+        {
+            sc.read(&a).read(&b).read(&c).read(&d);
+            sum += a + b + c + d;
+        }
+        C4_CHECK(sc.ok());
+    }
+    C4_CHECK(sum != 0);
+    report(st, buf.len);
+}
+
+void scan_c4substr_fields(bm::State &st)
+{
+    const std::string lines = make_scan_fields();
+    const c4::csubstr buf = c4::to_csubstr(lines);
+    int64_t sum = 0;
+    for(auto _ : st)
+    {
+        sum = 0;
+        c4::csubstr rem = buf;
+        while(!rem.empty())
+        {
+            size_t pos = rem.first_of(' ');
+            C4_CHECK(pos != c4::csubstr::npos && rem.first(pos) == "GET");
+            rem = rem.sub(pos).triml(' ');
+            C4_CHECK(rem.begins_with("/item/"));
+            rem = rem.sub(6);
+            pos = rem.first_of(' ');
+            C4_CHECK(pos != c4::csubstr::npos);
+            int id = 0;
+            C4_CHECK(c4::from_chars(rem.first(pos), &id));
+            rem = rem.sub(pos).triml(' ');
+            C4_CHECK(rem.begins_with("HTTP/1."));
+            rem = rem.sub(7);
+            int minor = 0;
+            pos = rem.first_of('\r');
+            C4_CHECK(pos != c4::csubstr::npos && c4::from_chars(rem.first(pos), &minor));
+            rem = rem.sub(pos);
+            C4_CHECK(rem.begins_with("\r\n"));
+            rem = rem.sub(2);
+            sum += id + minor;
+        }
+    }
+    C4_CHECK(sum != 0);
+    report(st, buf.len);
+}
+
+void scan_c4scanner_fields(bm::State &st)
+{
+    const std::string lines = make_scan_fields();
+    const c4::csubstr buf = c4::to_csubstr(lines);
+    int64_t sum = 0;
+    for(auto _ : st)
+    {
+        sum = 0;
+        c4::scanner sc(buf);
+        int id = 0, minor = 0;
+        while(!sc.at_end())
+        {
+            sc.expect("GET").skip(' ').expect("/item/").read(&id).skip(' ').expect("HTTP/1.").read(&minor).expect("\r\n");
+            sum += id + minor;
+        }
+        C4_CHECK(sc.ok());
+    }
+    C4_CHECK(sum != 0);
+    report(st, buf.len);
+}
+
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+#define _c4unformat_fmt "t={} id={} lat={} code={}"
+
+std::string make_unformat_lines()
+{
+    std::string lines;
+    for(size_t i = 0; i < 1000; ++i)
+        c4::formatrs(c4::append, &lines, _c4unformat_fmt "\n", 1700000000u + i, i * 37u, 0.25 * (double)(i % 16), 200 + (int)(i % 5) * 100);
+    return lines;
+}
+
+void unformat_c4unformat(bm::State &st)
+{
+    const std::string lines = make_unformat_lines();
+    const c4::csubstr buf = c4::to_csubstr(lines);
+    uint64_t t = 0; uint32_t id = 0; double lat = 0; int code = 0;
+    size_t sz = 0;
+    for(auto _ : st)
+    {
+        sz = 0;
+        for(c4::csubstr line : buf.split('\n'))
+            sz += c4::unformat(line, _c4unformat_fmt, t, id, lat, code) != c4::csubstr::npos;
+    }
+    C4_CHECK(sz == 1000u);
+    report(st, buf.len);
+}
+
+void unformat_c4unformat_checked_ct(bm::State &st)
+{
+    const std::string lines = make_unformat_lines();
+    const c4::csubstr buf = c4::to_csubstr(lines);
+    uint64_t t = 0; uint32_t id = 0; double lat = 0; int code = 0;
+    size_t sz = 0;
+    for(auto _ : st)
+    {
+        sz = c4::unformat_lines(buf, C4_FMT(_c4unformat_fmt), [](size_t, c4::csubstr, c4::unformat_result){}, t, id, lat, code);
+    }
+    C4_CHECK(sz == 1000u);
+    report(st, buf.len);
+}
+
+void unformat_c4unformat_checked_compiled(bm::State &st)
+{
+    const std::string lines = make_unformat_lines();
+    const c4::csubstr buf = c4::to_csubstr(lines);
+    const c4::compiled_format cf(_c4unformat_fmt);
+    uint64_t t = 0; uint32_t id = 0; double lat = 0; int code = 0;
+    size_t sz = 0;
+    for(auto _ : st)
+    {
+        sz = c4::unformat_lines(buf, cf, [](size_t, c4::csubstr, c4::unformat_result){}, t, id, lat, code);
+    }
+    C4_CHECK(sz == 1000u);
+    report(st, buf.len);
+}
+
+void unformat_sscanf(bm::State &st)
+{
+    const std::string lines = make_unformat_lines();
+    const c4::csubstr buf = c4::to_csubstr(lines);
+    unsigned long long t = 0; unsigned id = 0; double lat = 0; int code = 0;
+    char line_[128];
+    size_t sz = 0;
+    for(auto _ : st)
+    {
+        sz = 0;
+        for(c4::csubstr line : buf.split('\n'))
+        {
+            if(line.empty())
+                continue;
+            memcpy(line_, line.str, line.len);
+            line_[line.len] = '\0';
+            sz += sscanf(line_, "t=%llu id=%u lat=%lf code=%d", &t, &id, &lat, &code) == 4;
+        }
+    }
+    C4_CHECK(sz == 1000u);
+    report(st, buf.len);
+}
+
+
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
@@ -843,6 +1261,8 @@ C4BM(catfile_c4catdump_c_style_static_dispatch);
 C4BM(catfile_c4catdump_c_style_dynamic_dispatch);
 C4BM(catfile_c4catdump_cpp_style);
 C4BM(catfile_c4catdump_lambda_style);
+C4BM(catfile_c4catdump_fd_unbuffered);
+C4BM(catfile_c4dumpbuffer_fd);
 C4BM(catfile_fprintf);
 C4BM(catfile_ofstream);
 
@@ -868,9 +1288,14 @@ C4BM(catsepfile_ofstream);
 
 
 C4BM(format_c4format);
+C4BM(format_c4format_ct);
+C4BM(format_c4format_compiled);
 C4BM(format_c4formatrs_reuse);
+C4BM(format_c4formatrs_ct_reuse);
+C4BM(format_c4formatrs_compiled_reuse);
 C4BM(format_c4formatrs_no_reuse);
 C4BM(format_c4formatdump_c_style_static_dispatch);
+C4BM(format_c4formatdump_ct_c_style_static_dispatch);
 C4BM(format_c4formatdump_c_style_dynamic_dispatch);
 C4BM(format_c4formatdump_cpp_style);
 C4BM(format_c4formatdump_lambda_style);
@@ -880,8 +1305,24 @@ C4BM(formatfile_c4formatdump_c_style_static_dispatch);
 C4BM(formatfile_c4formatdump_c_style_dynamic_dispatch);
 C4BM(formatfile_c4formatdump_cpp_style);
 C4BM(formatfile_c4formatdump_lambda_style);
+C4BM(formatfile_c4formatdump_fd_unbuffered);
+C4BM(formatfile_c4dumpbuffer_fd);
 C4BM(formatfile_fprintf);
 
+C4BM(scan_c4uncat);
+C4BM(scan_c4scanner);
+C4BM(scan_c4substr_fields);
+C4BM(scan_c4scanner_fields);
+
+C4BM(unformat_c4unformat);
+C4BM(unformat_c4unformat_checked_ct);
+C4BM(unformat_c4unformat_checked_compiled);
+C4BM(unformat_sscanf);
+
+C4BM(align_c4cat_left);
+C4BM(align_c4cat_right);
+C4BM(align_snprintf);
+
 
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
@@ -0,0 +1,61 @@
+#include <c4/format.hpp>
+#include <c4/std/string.hpp>
+#include <cstdio>
+#include <cstdint>
+
+// Many call sites, each with a different list of argument types, as
+// is typical of logging code. Each distinct list instantiates a new
+// chain of templates, unless C4CORE_FORMAT_ERASED_ARGS is defined.
+
+#define C4_SIZE_CALLS(buf, str, a, b, c, d, e)                            \
+    sz += c4::cat(buf, a, b);                                           \
+    sz += c4::cat(buf, a, " ", b, ' ', c);                              \
+    sz += c4::cat(buf, d, ':', e, ':', a, ':', b);                      \
+    sz += c4::catsep(buf, ',', a, b, c);                                \
+    sz += c4::catsep(buf, " | ", e, d, c, b, a);                        \
+    sz += c4::format(buf, "a={} b={}", a, b);                           \
+    sz += c4::format(buf, "c={} d={} e={}", c, d, e);                   \
+    sz += c4::format(buf, "{}/{}/{}/{}/{}", e, d, c, b, a);             \
+    c4::catrs(&str, b, a, c);                                           \
+    sz += str.size();                                                   \
+    c4::catseprs(&str, ' ', d, e, a);                                   \
+    sz += str.size();                                                   \
+    c4::formatrs(&str, "[{}] {}: {}", a, e, d);                         \
+    sz += str.size()
+
+template<class T>
+T get(int argc, int i)
+{
+    return static_cast<T>(argc * (i + 1));
+}
+
+int main(int argc, char *argv[])
+{
+    char bufmem[256];
+    c4::substr buf = bufmem;
+    std::string str;
+    size_t sz = 0;
+    c4::csubstr name = c4::to_csubstr(argv[0]);
+
+    const int8_t   i8  = get<int8_t  >(argc, 1);
+    const uint8_t  u8  = get<uint8_t >(argc, 2);
+    const int16_t  i16 = get<int16_t >(argc, 3);
+    const uint16_t u16 = get<uint16_t>(argc, 4);
+    const int32_t  i32 = get<int32_t >(argc, 5);
+    const uint32_t u32 = get<uint32_t>(argc, 6);
+    const int64_t  i64 = get<int64_t >(argc, 7);
+    const uint64_t u64 = get<uint64_t>(argc, 8);
+    const float    f   = get<float   >(argc, 9);
+    const double   d   = get<double  >(argc, 10);
+    const std::string s = "string";
+
+    C4_SIZE_CALLS(buf, str, i8, u8, i16, u16, name);
+    C4_SIZE_CALLS(buf, str, u16, i32, u32, i64, u64);
+    C4_SIZE_CALLS(buf, str, f, d, name, s, i8);
+    C4_SIZE_CALLS(buf, str, c4::fmt::hex(u32), c4::fmt::real(d, 3), i64, name, f);
+    C4_SIZE_CALLS(buf, str, s, u64, c4::fmt::zpad(i32, 8), d, u8);
+    C4_SIZE_CALLS(buf, str, c4::fmt::left(name, 10), c4::fmt::boolalpha(argc > 1), f, i16, u32);
+
+    std::printf("%zu\n", sz);
+    return 0;
+}
@@ -87,6 +87,13 @@ inline size_t to_chars(substr buf, fmt::const_base64_wrapper b)
     return base64_encode(buf, b.data);
 }
 
+/** each group of 3 bytes is encoded in 4 characters */
+template<>
+struct max_chars<fmt::const_base64_wrapper>
+{
+    static C4_CONSTEXPR14 size_t bound(fmt::const_base64_wrapper const& b) noexcept { return ((b.data.len + 2u) / 3u) * 4u; }
+};
+
 /** read a variable in base64 format */
 inline size_t from_chars(csubstr buf, fmt::base64_wrapper *b)
 {
@@ -31,6 +31,13 @@
  * // skipping leading whitespace, and convert it using from_chars().
  * // Return the number of characters read for converting.
  * template<class T> size_t c4::from_chars_first(csubstr buf, T * C4_RESTRICT val);
+ *
+ *
+ * // Same as from_chars() and from_chars_first(), but when the
+ * // conversion fails, tell where and why: return the number of
+ * // characters consumed and the error kind.
+ * template<class T> parse_result c4::from_chars_checked(csubstr buf, T * C4_RESTRICT val);
+ * template<class T> parse_result c4::from_chars_first_checked(csubstr buf, T * C4_RESTRICT val);
  * @endcode
  */
 
@@ -38,6 +45,7 @@
 #include <inttypes.h>
 #include <type_traits>
 #include <climits>
+#include <cfloat>
 #include <limits>
 #include <utility>
 
@@ -102,10 +110,18 @@
 #endif
 
 
-#if !C4CORE_HAVE_STD_FROMCHARS && !defined(C4CORE_HAVE_FAST_FLOAT)
+#if !C4CORE_HAVE_STD_TOCHARS
 #include <cstdio>
 #endif
 
+/** 128 bit integers are supported when the compiler provides them.
+ * Define C4CORE_NO_INT128 to disable this support. */
+#if defined(__SIZEOF_INT128__) && !defined(C4CORE_NO_INT128)
+#   define C4CORE_HAVE_INT128 1
+#else
+#   define C4CORE_HAVE_INT128 0
+#endif
+
 
 #ifdef _MSC_VER
 #   pragma warning(push)
@@ -141,6 +157,46 @@ typedef enum : uint8_t {
 } RealFormat_e;
 
 
+/** error codes for the conversion functions which can tell apart the
+ * reason for a failure. The names mirror the corresponding values in
+ * std::errc. */
+enum class errc : uint8_t {
+    /** the conversion was successful */
+    ok = 0,
+    /** the string does not represent a valid value of the type */
+    invalid_argument = 1,
+    /** the string represents a valid number, but the value is out
+     * of the type's range */
+    result_out_of_range = 2,
+};
+
+
+/** the result of from_chars_checked() and from_chars_first_checked():
+ * how far the string was read, and why the conversion stopped
+ * there. This is obtained in the same pass which reads the value, so
+ * a caller reporting an error does not need to scan the string
+ * again. */
+struct parse_result
+{
+    /** On success, the number of characters read for the value,
+     * including any leading whitespace skipped by the *_first()
+     * functions. On failure, the position where the conversion
+     * stopped: for errc::invalid_argument, this is the offending
+     * character (or the string's length if more characters were
+     * expected); for errc::result_out_of_range, this is the end of
+     * the value which does not fit. */
+    size_t consumed;
+    /** errc::ok if the conversion was successful */
+    errc err;
+
+    C4_CONSTEXPR14 bool ok() const noexcept { return err == errc::ok; }
+    C4_CONSTEXPR14 explicit operator bool() const noexcept { return err == errc::ok; }
+    /** the value returned by from_chars_first(): the number of
+     * characters read, or csubstr::npos on failure */
+    C4_CONSTEXPR14 size_t first() const noexcept { return err == errc::ok ? consumed : csubstr::npos; }
+};
+
+
 inline C4_CONSTEXPR14 char to_c_fmt(RealFormat_e f)
 {
     constexpr const char fmt[] = {
@@ -199,6 +255,44 @@ struct is_fixed_length
 };
 
 
+namespace detail {
+
+#if C4CORE_HAVE_INT128
+// __extension__ prevents -Wpedantic warnings
+__extension__ typedef __int128 i128;
+__extension__ typedef unsigned __int128 u128;
+#endif
+
+/** std::is_integral, std::is_signed and std::make_unsigned do not
+ * know about the 128 bit integers when the compiler is in strict
+ * ANSI mode. These traits are used instead in the integer
+ * conversion functions. */
+template<class T> struct is_int  { enum : bool { value = std::is_integral<T>::value }; };
+template<class T> struct is_sint { enum : bool { value = std::is_integral<T>::value && std::is_signed<T>::value }; };
+template<class T> struct is_uint { enum : bool { value = std::is_integral<T>::value && std::is_unsigned<T>::value }; };
+template<class T> struct make_uint { using type = typename std::make_unsigned<T>::type; };
+#if C4CORE_HAVE_INT128
+template<> struct is_int<i128>  { enum : bool { value = true }; };
+template<> struct is_int<u128>  { enum : bool { value = true }; };
+template<> struct is_sint<i128> { enum : bool { value = true }; };
+template<> struct is_sint<u128> { enum : bool { value = false }; };
+template<> struct is_uint<i128> { enum : bool { value = false }; };
+template<> struct is_uint<u128> { enum : bool { value = true }; };
+template<> struct make_uint<i128> { using type = u128; };
+template<> struct make_uint<u128> { using type = u128; };
+#endif
+
+/** the minimum value of a signed integer type. std::numeric_limits
+ * is not specialized for the 128 bit integers in strict ANSI mode. */
+template<class T>
+constexpr T _int_min() noexcept
+{
+    return static_cast<T>(static_cast<typename make_uint<T>::type>(1) << (8u * sizeof(T) - 1u));
+}
+
+} // namespace detail
+
+
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
@@ -225,87 +319,394 @@ struct is_fixed_length
 namespace c4 {
 C4_INLINE_CONSTEXPR const char hexchars[] = "0123456789abcdef";
 
+namespace detail {
+
+/** the decimal representation of every number in [0,99], two
+ * characters per number. Used to write decimal numbers two digits at
+ * a time. */
+C4_INLINE_CONSTEXPR const char digits0099[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/** powers of 10 for 32 bit integers */
+C4_INLINE_CONSTEXPR const uint32_t powers_of_10_u32[] = {
+    UINT32_C(1), UINT32_C(10), UINT32_C(100), UINT32_C(1000),
+    UINT32_C(10000), UINT32_C(100000), UINT32_C(1000000),
+    UINT32_C(10000000), UINT32_C(100000000), UINT32_C(1000000000),
+};
+
+/** powers of 10 for 64 bit integers */
+C4_INLINE_CONSTEXPR const uint64_t powers_of_10_u64[] = {
+    UINT64_C(1), UINT64_C(10), UINT64_C(100), UINT64_C(1000),
+    UINT64_C(10000), UINT64_C(100000), UINT64_C(1000000),
+    UINT64_C(10000000), UINT64_C(100000000), UINT64_C(1000000000),
+    UINT64_C(10000000000), UINT64_C(100000000000), UINT64_C(1000000000000),
+    UINT64_C(10000000000000), UINT64_C(100000000000000), UINT64_C(1000000000000000),
+    UINT64_C(10000000000000000), UINT64_C(100000000000000000), UINT64_C(1000000000000000000),
+    UINT64_C(10000000000000000000),
+};
+
+/** number of significant bits, ie one plus the index of the most
+ * significant set bit. Requires v>0. */
+C4_ALWAYS_INLINE unsigned _bitwidth(uint32_t v) noexcept
+{
+    C4_ASSERT(v > 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return 32u - static_cast<unsigned>(__builtin_clz(v));
+#else
+    unsigned n = 1;
+    if(v & UINT32_C(0xffff0000)) { v >>= 16; n += 16; }
+    if(v & UINT32_C(    0xff00)) { v >>=  8; n +=  8; }
+    if(v & UINT32_C(      0xf0)) { v >>=  4; n +=  4; }
+    if(v & UINT32_C(       0xc)) { v >>=  2; n +=  2; }
+    if(v & UINT32_C(       0x2)) { /*....*/  n +=  1; }
+    return n;
+#endif
+}
+
+/** number of significant bits, ie one plus the index of the most
+ * significant set bit. Requires v>0. */
+C4_ALWAYS_INLINE unsigned _bitwidth(uint64_t v) noexcept
+{
+    C4_ASSERT(v > 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return 64u - static_cast<unsigned>(__builtin_clzll(v));
+#else
+    const uint32_t hi = static_cast<uint32_t>(v >> 32);
+    return hi ? 32u + _bitwidth(hi) : _bitwidth(static_cast<uint32_t>(v));
+#endif
+}
+
+// the (v|1) trick deals with v==0, which has one digit: since
+// every power of 10 from 10 on is even, (v|1) >= 10^n iff v >= 10^n
+C4_ALWAYS_INLINE unsigned _digits_dec(uint32_t v) noexcept
+{
+    // 1233/4096 is an approximation of log10(2)
+    const unsigned t = (_bitwidth(v | 1u) * 1233u) >> 12u;
+    return t + static_cast<unsigned>((v | 1u) >= powers_of_10_u32[t]);
+}
+
+C4_ALWAYS_INLINE unsigned _digits_dec(uint64_t v) noexcept
+{
+    // 1233/4096 is an approximation of log10(2)
+    const unsigned t = (_bitwidth(v | 1u) * 1233u) >> 12u;
+    return t + static_cast<unsigned>((v | 1u) >= powers_of_10_u64[t]);
+}
+
+#if C4CORE_HAVE_INT128
+C4_ALWAYS_INLINE unsigned _bitwidth(u128 v) noexcept
+{
+    const uint64_t hi = static_cast<uint64_t>(v >> 64u);
+    return hi ? 64u + _bitwidth(hi) : _bitwidth(static_cast<uint64_t>(v));
+}
+
+/** 10^19 is the largest power of 10 fitting in 64 bits: 128 bit
+ * numbers are handled in chunks of 19 digits */
+constexpr const uint64_t _pow10_19 = UINT64_C(10000000000000000000);
+
+C4_ALWAYS_INLINE unsigned _digits_dec(u128 v) noexcept
+{
+    if(static_cast<uint64_t>(v >> 64u) == 0u)
+        return _digits_dec(static_cast<uint64_t>(v));
+    // as above, but 10^t needs a product for t > 19
+    const unsigned t = (_bitwidth(v) * 1233u) >> 12u;
+    const u128 pow10 = t <= 19u ?
+        static_cast<u128>(powers_of_10_u64[t]) :
+        static_cast<u128>(powers_of_10_u64[t - 19u]) * _pow10_19;
+    return t + static_cast<unsigned>(v >= pow10);
+}
+#endif
+
+/** the unsigned type used to do the decimal arithmetic for T */
+#if C4CORE_HAVE_INT128
+template<class T>
+using dec_uint = typename std::conditional<(sizeof(T) <= 4u), uint32_t,
+                 typename std::conditional<(sizeof(T) <= 8u), uint64_t, u128>::type>::type;
+#else
+template<class T>
+using dec_uint = typename std::conditional<(sizeof(T) <= 4u), uint32_t, uint64_t>::type;
+#endif
+
+} // namespace detail
+
+
+/** return the number of digits required to write an integer in
+ * decimal format. This is computed without divisions, by counting
+ * the leading zero bits.
+ * @note does not accept negative numbers */
+template<class T>
+C4_ALWAYS_INLINE unsigned digits_dec(T v) noexcept
+{
+    C4_STATIC_ASSERT(detail::is_int<T>::value);
+    C4_ASSERT(v >= 0);
+    return detail::_digits_dec(static_cast<detail::dec_uint<T>>(v));
+}
+
+
+namespace detail {
+template<class U>
+C4_ALWAYS_INLINE void _write_dec_unchecked(substr buf, U u, unsigned digits_v) noexcept
+{
+    // write from the back, two digits at a time
+    while(u >= U(100))
+    {
+        const U num = static_cast<U>((u % U(100)) << 1u);
+        u /= U(100);
+        digits_v -= 2u;
+        buf.str[digits_v    ] = detail::digits0099[num     ];
+        buf.str[digits_v + 1] = detail::digits0099[num + 1u];
+    }
+    if(u >= U(10))
+    {
+        C4_ASSERT(digits_v == 2u);
+        const U num = static_cast<U>(u << 1u);
+        buf.str[0] = detail::digits0099[num     ];
+        buf.str[1] = detail::digits0099[num + 1u];
+    }
+    else
+    {
+        C4_ASSERT(digits_v == 1u);
+        buf.str[0] = static_cast<char>('0' + u);
+    }
+}
+
+#if C4CORE_HAVE_INT128
+/** 128 bit division is expensive, so the number is split into
+ * chunks of 19 digits, which are then written with 64 bit
+ * arithmetic. This needs at most two 128 bit divisions. */
+inline void _write_dec_unchecked(substr buf, u128 u, unsigned digits_v) noexcept
+{
+    // write the chunks from the back, padded with zeroes
+    while(digits_v > 19u)
+    {
+        const uint64_t chunk = static_cast<uint64_t>(u % _pow10_19);
+        u /= _pow10_19;
+        digits_v -= 19u;
+        const unsigned chunk_digits = _digits_dec(chunk);
+        memset(buf.str + digits_v, '0', 19u - chunk_digits);
+        _write_dec_unchecked(buf.sub(digits_v + 19u - chunk_digits), chunk, chunk_digits);
+    }
+    _write_dec_unchecked(buf, static_cast<uint64_t>(u), digits_v);
+}
+#endif
+} // namespace detail
+
+/** write an integer to a string in decimal format, using exactly the
+ * given number of digits. The string must have at least that
+ * number of characters; this is not checked.
+ * @note does not accept negative numbers
+ * @note the number of digits must be digits_dec(v) */
+template<class T>
+C4_ALWAYS_INLINE void write_dec_unchecked(substr buf, T v, unsigned digits_v) noexcept
+{
+    C4_STATIC_ASSERT(detail::is_int<T>::value);
+    C4_ASSERT(v >= 0);
+    C4_ASSERT(buf.len >= digits_v);
+    C4_ASSERT(digits_v == digits_dec(v));
+    detail::_write_dec_unchecked(buf, static_cast<detail::dec_uint<T>>(v), digits_v);
+}
+
+
 /** write an integer to a string in decimal format. This is the
  * lowest level (and the fastest) function to do this task.
  * @note does not accept negative numbers
  * @return the number of characters required for the string,
  * even if the string is not long enough for the result.
- * No writes are done past the end of the string. */
+ * No writes are done past the end of the string; if the string is
+ * not long enough, only the least significant digits are written. */
 template<class T>
-size_t write_dec(substr buf, T v)
+C4_ALWAYS_INLINE size_t write_dec(substr buf, T v)
 {
-    C4_STATIC_ASSERT(std::is_integral<T>::value);
+    C4_STATIC_ASSERT(detail::is_int<T>::value);
     C4_ASSERT(v >= 0);
-    size_t pos = 0;
-    do {
-        _c4append('0' + (v % T(10)));
-        v /= T(10);
-    } while(v);
-    buf.reverse_range(0, pos <= buf.len ? pos : buf.len);
-    return pos;
+    const unsigned digits = digits_dec(v);
+    if(C4_LIKELY(digits <= buf.len))
+    {
+        write_dec_unchecked(buf, v, digits);
+    }
+    else
+    {
+        for(size_t pos = buf.len; pos > 0; --pos)
+        {
+            buf.str[pos - 1] = static_cast<char>('0' + (v % T(10)));
+            v /= T(10);
+        }
+    }
+    return digits;
+}
+
+
+namespace detail {
+
+// SWAR (SIMD within a register) helpers to write hexadecimal, binary
+// and octal digits eight at a time. The digits of a chunk are spread
+// into the bytes of a 64 bit word, with the most significant digit
+// in the least significant byte, so that the word can be stored
+// directly into the string as characters.
+
+/** store the @p n lowest bytes of @p v, the least significant byte
+ * going to the first character */
+C4_ALWAYS_INLINE void _swar_store(char *C4_RESTRICT s, uint64_t v, unsigned n) noexcept
+{
+    C4_ASSERT(n <= 8u);
+#if C4_LITTLE_ENDIAN
+    if(n == 8u)
+    {
+        memcpy(s, &v, 8);
+        return;
+    }
+    if(n & 4u)
+    {
+        const uint32_t v4 = static_cast<uint32_t>(v);
+        memcpy(s, &v4, 4);
+        s += 4;
+        v >>= 32u;
+    }
+    if(n & 2u)
+    {
+        const uint16_t v2 = static_cast<uint16_t>(v);
+        memcpy(s, &v2, 2);
+        s += 2;
+        v >>= 16u;
+    }
+    if(n & 1u)
+        *s = static_cast<char>(v);
+#else
+    for(unsigned i = 0; i < n; ++i)
+        s[i] = static_cast<char>(static_cast<uint8_t>(v >> (8u * i)));
+#endif
+}
+
+/** spread the 8 nibbles of @p v into hexadecimal characters */
+C4_ALWAYS_INLINE uint64_t _swar_hex8(uint32_t v) noexcept
+{
+    uint64_t n = (v >> 16u) | (static_cast<uint64_t>(v & UINT32_C(0xffff)) << 32u);
+    n = ((n >> 8u) & UINT64_C(0x000000ff000000ff)) | ((n & UINT64_C(0x000000ff000000ff)) << 16u);
+    n = ((n >> 4u) & UINT64_C(0x000f000f000f000f)) | ((n & UINT64_C(0x000f000f000f000f)) << 8u);
+    // add 'a'-'0'-10 to the bytes which are 10 or more
+    const uint64_t letters = ((n + UINT64_C(0x0606060606060606)) >> 4u) & UINT64_C(0x0101010101010101);
+    return n + UINT64_C(0x3030303030303030) + letters * UINT64_C(39);
+}
+
+/** spread the 8 bits of @p v into binary characters */
+C4_ALWAYS_INLINE uint64_t _swar_bin8(uint8_t v) noexcept
+{
+    // each byte keeps a different bit of the broadcast value
+    const uint64_t n = (v * UINT64_C(0x0101010101010101)) & UINT64_C(0x0102040810204080);
+    return (((n + UINT64_C(0x7f7f7f7f7f7f7f7f)) >> 7u) & UINT64_C(0x0101010101010101)) + UINT64_C(0x3030303030303030);
+}
+
+/** spread the 24 lowest bits of @p v into octal characters */
+C4_ALWAYS_INLINE uint64_t _swar_oct8(uint32_t v) noexcept
+{
+    C4_ASSERT(v <= UINT32_C(0xffffff));
+    uint64_t n = (v >> 12u) | (static_cast<uint64_t>(v & UINT32_C(0xfff)) << 32u);
+    n = ((n >> 6u) & UINT64_C(0x0000003f0000003f)) | ((n & UINT64_C(0x0000003f0000003f)) << 16u);
+    n = ((n >> 3u) & UINT64_C(0x0007000700070007)) | ((n & UINT64_C(0x0007000700070007)) << 8u);
+    return n + UINT64_C(0x3030303030303030);
+}
+
+/** write an unsigned integer with a power-of-two radix, using
+ * exactly the given number of digits, from the back to the front,
+ * eight digits at a time.
+ * @p bits is the number of bits per digit */
+template<unsigned bits, class U>
+C4_ALWAYS_INLINE void _write_pow2_unchecked(char *C4_RESTRICT s, U v, unsigned digits) noexcept
+{
+    C4_STATIC_ASSERT(detail::is_uint<U>::value);
+    C4_STATIC_ASSERT(bits == 1u || bits == 3u || bits == 4u);
+    // the chunk does not fit in U for 32 bit types and hexadecimal
+    using chunk_type = typename std::conditional<(8u * bits < 8u * sizeof(U)), U, uint64_t>::type;
+    while(digits > 8u)
+    {
+        digits -= 8u;
+        const uint32_t chunk = static_cast<uint32_t>(v & static_cast<U>((UINT64_C(1) << (8u * bits)) - 1u));
+        const uint64_t chars = bits == 4u ? _swar_hex8(chunk) : (bits == 3u ? _swar_oct8(chunk) : _swar_bin8(static_cast<uint8_t>(chunk)));
+        _swar_store(s + digits, chars, 8u);
+        v = static_cast<U>(static_cast<chunk_type>(v) >> (8u * bits));
+    }
+    const uint32_t chunk = static_cast<uint32_t>(v);
+    const uint64_t chars = bits == 4u ? _swar_hex8(chunk) : (bits == 3u ? _swar_oct8(chunk) : _swar_bin8(static_cast<uint8_t>(chunk)));
+    // the chunk was spread with leading zeroes: skip them
+    _swar_store(s, chars >> (8u * (8u - digits)), digits);
+}
+
+/** write an integer with a power-of-two radix.
+ * @return the number of digits, even if the string is not long
+ * enough. In that case, only the least significant digits are
+ * written. */
+template<unsigned bits, class T>
+C4_ALWAYS_INLINE size_t _write_pow2(substr buf, T v) noexcept
+{
+    C4_STATIC_ASSERT(detail::is_int<T>::value);
+    C4_ASSERT(v >= 0);
+    using U = dec_uint<T>;
+    U u = static_cast<U>(v);
+    const unsigned digits = u ? (_bitwidth(u) + bits - 1u) / bits : 1u;
+    if(C4_LIKELY(digits <= buf.len))
+    {
+        _write_pow2_unchecked<bits>(buf.str, u, digits);
+    }
+    else
+    {
+        for(size_t pos = buf.len; pos > 0; --pos)
+        {
+            buf.str[pos - 1] = hexchars[u & ((U(1) << bits) - 1u)];
+            u >>= bits;
+        }
+    }
+    return digits;
 }
 
+} // namespace detail
+
 
 /** write an integer to a string in hexadecimal format. This is the
  * lowest level (and the fastest) function to do this task.
+ * Digits are written eight at a time.
  * @note does not accept negative numbers
+ * @note does not prefix with 0x
  * @return the number of characters required for the string,
  * even if the string is not long enough for the result.
- * No writes are done past the end of the string. */
+ * No writes are done past the end of the string; if the string is
+ * not long enough, only the least significant digits are written. */
 template<class T>
 size_t write_hex(substr buf, T v)
 {
-    C4_STATIC_ASSERT(std::is_integral<T>::value);
-    C4_ASSERT(v >= 0);
-    size_t pos = 0;
-    do {
-        _c4appendhex(v & T(15));
-        v >>= 4;
-    } while(v);
-    buf.reverse_range(0, pos <= buf.len ? pos : buf.len);
-    return pos;
+    return detail::_write_pow2<4u>(buf, v);
 }
 
 /** write an integer to a string in octal format. This is the
  * lowest level (and the fastest) function to do this task.
+ * Digits are written eight at a time.
  * @note does not accept negative numbers
  * @note does not prefix with 0o
  * @return the number of characters required for the string,
  * even if the string is not long enough for the result.
- * No writes are done past the end of the string. */
+ * No writes are done past the end of the string; if the string is
+ * not long enough, only the least significant digits are written. */
 template<class T>
 size_t write_oct(substr buf, T v)
 {
-    C4_STATIC_ASSERT(std::is_integral<T>::value);
-    C4_ASSERT(v >= 0);
-    size_t pos = 0;
-    do {
-        _c4append('0' + (v & T(7)));
-        v >>= 3;
-    } while(v);
-    buf.reverse_range(0, pos <= buf.len ? pos : buf.len);
-    return pos;
+    return detail::_write_pow2<3u>(buf, v);
 }
 
 /** write an integer to a string in binary format. This is the
  * lowest level (and the fastest) function to do this task.
+ * Digits are written eight at a time.
  * @note does not accept negative numbers
  * @note does not prefix with 0b
  * @return the number of characters required for the string,
  * even if the string is not long enough for the result.
- * No writes are done past the end of the string. */
+ * No writes are done past the end of the string; if the string is
+ * not long enough, only the least significant digits are written. */
 template<class T>
 size_t write_bin(substr buf, T v)
 {
-    C4_STATIC_ASSERT(std::is_integral<T>::value);
-    C4_ASSERT(v >= 0);
-    size_t pos = 0;
-    do {
-        _c4append('0' + (v & T(1)));
-        v >>= 1;
-    } while(v);
-    buf.reverse_range(0, pos <= buf.len ? pos : buf.len);
-    return pos;
+    return detail::_write_pow2<1u>(buf, v);
 }
 
 
@@ -315,7 +716,7 @@ template<class U> using NumberWriter = size_t (*)(substr, U);
 template<class T, NumberWriter<T> writer>
 size_t write_num_digits(substr buf, T v, size_t num_digits)
 {
-    C4_STATIC_ASSERT(std::is_integral<T>::value);
+    C4_STATIC_ASSERT(detail::is_int<T>::value);
     size_t ret = writer(buf, v);
     if(ret >= num_digits)
         return ret;
@@ -334,9 +735,20 @@ size_t write_num_digits(substr buf, T v, size_t num_digits)
  * such that the resulting string is @p num_digits wide.
  * If the given number is wider than num_digits, then the number prevails. */
 template<class T>
-size_t write_dec(substr buf, T val, size_t num_digits)
+C4_ALWAYS_INLINE size_t write_dec(substr buf, T val, size_t num_digits)
 {
-    return detail::write_num_digits<T, &write_dec<T>>(buf, val, num_digits);
+    C4_STATIC_ASSERT(detail::is_int<T>::value);
+    C4_ASSERT(val >= 0);
+    const unsigned digits = digits_dec(val);
+    const size_t npad = num_digits > digits ? num_digits - digits : 0u;
+    if(C4_LIKELY(npad + digits <= buf.len))
+    {
+        // the number of digits is known beforehand, so the padding
+        // can be written directly before the number
+        memset(buf.str, '0', npad);
+        write_dec_unchecked(buf.sub(npad), val, digits);
+    }
+    return npad + digits;
 }
 
 /** same as c4::write_hex(), but pad with zeroes on the left
@@ -371,27 +783,354 @@ size_t write_oct(substr buf, T val, size_t num_digits)
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 
+namespace detail {
+
+// SWAR (SIMD within a register) helpers to read decimal digits
+// several at a time. The characters are loaded such that the first
+// character goes to the least significant byte.
+// @see https://lemire.me/blog/2022/01/21/swar-explained-parsing-eight-digits/
+
+C4_ALWAYS_INLINE uint64_t _swar_load8(const char *C4_RESTRICT s) noexcept
+{
+#if C4_LITTLE_ENDIAN
+    uint64_t v;
+    memcpy(&v, s, 8);
+    return v;
+#else
+    uint64_t v = 0;
+    for(unsigned i = 0; i < 8u; ++i)
+        v |= static_cast<uint64_t>(static_cast<uint8_t>(s[i])) << (8u * i);
+    return v;
+#endif
+}
+
+C4_ALWAYS_INLINE uint32_t _swar_load4(const char *C4_RESTRICT s) noexcept
+{
+#if C4_LITTLE_ENDIAN
+    uint32_t v;
+    memcpy(&v, s, 4);
+    return v;
+#else
+    uint32_t v = 0;
+    for(unsigned i = 0; i < 4u; ++i)
+        v |= static_cast<uint32_t>(static_cast<uint8_t>(s[i])) << (8u * i);
+    return v;
+#endif
+}
+
+/** load 1 to 8 characters in the byte order of _swar_load8(), with
+ * the missing bytes set to zero. Nothing is read beyond s+n. */
+C4_ALWAYS_INLINE uint64_t _swar_load_upto8(const char *C4_RESTRICT s, size_t n) noexcept
+{
+    C4_ASSERT(n >= 1u && n <= 8u);
+    if(n >= 4u) // two overlapping loads
+        return static_cast<uint64_t>(_swar_load4(s)) | (static_cast<uint64_t>(_swar_load4(s + n - 4u)) << (8u * (n - 4u)));
+    return static_cast<uint64_t>(static_cast<uint8_t>(s[0]))
+        | (static_cast<uint64_t>(static_cast<uint8_t>(s[n >> 1u])) << (8u * (n >> 1u)))
+        | (static_cast<uint64_t>(static_cast<uint8_t>(s[n - 1u])) << (8u * (n - 1u)));
+}
+
+/** get a mask with nonzero bytes where the characters are not in
+ * [0-9]. Only the lowest nonzero byte is reliable, as the carries
+ * from a non-digit may spill into the bytes after it. */
+C4_ALWAYS_INLINE uint64_t _swar_nondec8(uint64_t v) noexcept
+{
+    return ((v & UINT64_C(0xf0f0f0f0f0f0f0f0))
+            | (((v + UINT64_C(0x0606060606060606)) & UINT64_C(0xf0f0f0f0f0f0f0f0)) >> 4u))
+        ^ UINT64_C(0x3333333333333333);
+}
+
+/** true if each of the 8 characters is in [0-9] */
+C4_ALWAYS_INLINE bool _swar_is_dec8(uint64_t v) noexcept
+{
+    return _swar_nondec8(v) == 0u;
+}
+
+/** true if each of the 4 characters is in [0-9] */
+C4_ALWAYS_INLINE bool _swar_is_dec4(uint32_t v) noexcept
+{
+    return ((v & UINT32_C(0xf0f0f0f0))
+            | (((v + UINT32_C(0x06060606)) & UINT32_C(0xf0f0f0f0)) >> 4u))
+        == UINT32_C(0x33333333);
+}
+
+/** convert 8 decimal characters into their value. The characters must
+ * have been validated with _swar_is_dec8() */
+C4_ALWAYS_INLINE uint32_t _swar_parse_dec8(uint64_t v) noexcept
+{
+    v -= UINT64_C(0x3030303030303030);
+    v = (v * 10u) + (v >> 8u); // pairs of digits in each even byte
+    v = (((v & UINT64_C(0x000000ff000000ff)) * (UINT64_C(100) + (UINT64_C(1000000) << 32u)))
+         + (((v >> 16u) & UINT64_C(0x000000ff000000ff)) * (UINT64_C(1) + (UINT64_C(10000) << 32u))))
+        >> 32u;
+    return static_cast<uint32_t>(v);
+}
+
+/** convert 4 decimal characters into their value. The characters must
+ * have been validated with _swar_is_dec4() */
+C4_ALWAYS_INLINE uint32_t _swar_parse_dec4(uint32_t v) noexcept
+{
+    v -= UINT32_C(0x30303030);
+    v = (v * 10u) + (v >> 8u); // pairs of digits in each even byte
+    v = ((v & UINT32_C(0x00ff00ff)) * (UINT32_C(1) + (UINT32_C(100) << 16u))) >> 16u;
+    return v & UINT32_C(0xffff);
+}
+
+/** get a mask with the top bit of each byte set where the characters
+ * are not hexadecimal digits (upper or lower case) */
+C4_ALWAYS_INLINE uint64_t _swar_nonhex8(uint64_t v) noexcept
+{
+    // the range checks below assume that the top bit of each byte is
+    // clear: this way the additions do not carry into the next byte
+    const uint64_t high = v & UINT64_C(0x8080808080808080);
+    v &= UINT64_C(0x7f7f7f7f7f7f7f7f);
+    const uint64_t lower = v | UINT64_C(0x2020202020202020);
+    // top bit of each byte set if the character is in [0-9]
+    const uint64_t dec = (v + UINT64_C(0x5050505050505050)) & ~(v + UINT64_C(0x4646464646464646));
+    // top bit of each byte set if the character is in [a-fA-F]
+    const uint64_t alpha = (lower + UINT64_C(0x1f1f1f1f1f1f1f1f)) & ~(lower + UINT64_C(0x1919191919191919));
+    return (high | ~(dec | alpha)) & UINT64_C(0x8080808080808080);
+}
+
+/** convert 8 hexadecimal characters into their value. The characters
+ * must have been validated with _swar_nonhex8() */
+C4_ALWAYS_INLINE uint32_t _swar_parse_hex8(uint64_t v) noexcept
+{
+    // '0'-'9' have the digit in the low nibble; a-f and A-F have 1-6,
+    // and are told apart by their 0x40 bit
+    uint64_t n = (v & UINT64_C(0x0f0f0f0f0f0f0f0f)) + ((v & UINT64_C(0x4040404040404040)) >> 6u) * UINT64_C(9);
+    // gather the nibbles; the first character is the most significant
+    n = ((n << 4u) | (n >> 8u)) & UINT64_C(0x00ff00ff00ff00ff);
+    n = ((n << 8u) | (n >> 16u)) & UINT64_C(0x0000ffff0000ffff);
+    return static_cast<uint32_t>((n << 16u) | (n >> 32u));
+}
+
+/** validate and convert 8 hexadecimal characters (upper or lower
+ * case) into their value
+ * @return true if every character is an hexadecimal digit */
+C4_ALWAYS_INLINE bool _swar_read_hex8(uint64_t v, uint32_t *C4_RESTRICT out) noexcept
+{
+    if(C4_UNLIKELY(_swar_nonhex8(v) != 0u))
+        return false;
+    *out = _swar_parse_hex8(v);
+    return true;
+}
+
+/** validate and convert 8 binary characters into their value
+ * @return true if every character is 0 or 1 */
+C4_ALWAYS_INLINE bool _swar_read_bin8(uint64_t v, uint32_t *C4_RESTRICT out) noexcept
+{
+    if(C4_UNLIKELY((v & ~UINT64_C(0x0101010101010101)) != UINT64_C(0x3030303030303030)))
+        return false;
+    // gather each byte's bit at the top; the first character is the
+    // most significant bit. No two partial products overlap.
+    *out = static_cast<uint32_t>(((v & UINT64_C(0x0101010101010101)) * UINT64_C(0x8040201008040201)) >> 56u);
+    return true;
+}
+
+/** validate and convert 8 octal characters into their value
+ * @return true if every character is in [0-7] */
+C4_ALWAYS_INLINE bool _swar_read_oct8(uint64_t v, uint32_t *C4_RESTRICT out) noexcept
+{
+    if(C4_UNLIKELY((v & UINT64_C(0xf8f8f8f8f8f8f8f8)) != UINT64_C(0x3030303030303030)))
+        return false;
+    uint64_t n = v & UINT64_C(0x0707070707070707);
+    n = ((n << 3u) | (n >> 8u)) & UINT64_C(0x003f003f003f003f);
+    n = ((n << 6u) | (n >> 16u)) & UINT64_C(0x00000fff00000fff);
+    *out = static_cast<uint32_t>(((n << 12u) | (n >> 32u)) & UINT64_C(0xffffff));
+    return true;
+}
+
+/** read an integer with a power-of-two radix, eight characters at a
+ * time. A final chunk with less than eight characters is padded on
+ * the left with zeroes.
+ * @p bits is the number of bits per digit */
+template<unsigned bits, class I>
+C4_ALWAYS_INLINE bool _read_pow2(csubstr s, I *C4_RESTRICT v) noexcept
+{
+    C4_STATIC_ASSERT(detail::is_int<I>::value);
+    C4_STATIC_ASSERT(bits == 1u || bits == 3u || bits == 4u);
+    // do the arithmetic in an unsigned type at least as wide as I,
+    // which wraps around in the same way as I. The shifts are done
+    // in at least 64 bits, as they may be as wide as the 32 bit types.
+    using U = dec_uint<I>;
+    using W = typename std::conditional<(sizeof(U) < 8u), uint64_t, U>::type;
+    U acc = 0;
+    uint32_t chunk;
+    *v = 0;
+    const char *C4_RESTRICT str = s.str;
+    size_t len = s.len;
+    for( ; len >= 8u; str += 8, len -= 8u)
+    {
+        const uint64_t chars = _swar_load8(str);
+        if(C4_UNLIKELY( ! (bits == 4u ? _swar_read_hex8(chars, &chunk) : (bits == 3u ? _swar_read_oct8(chars, &chunk) : _swar_read_bin8(chars, &chunk)))))
+            return false;
+        acc = static_cast<U>((static_cast<W>(acc) << (8u * bits)) | chunk);
+    }
+    if(len)
+    {
+        uint64_t chars;
+        if(s.len >= 8u)
+        {
+            // load the last 8 characters, and replace the ones
+            // which were already read with zeroes
+            const uint64_t read_mask = (UINT64_C(1) << (8u * (8u - len))) - 1u;
+            chars = (_swar_load8(str + len - 8u) & ~read_mask) | (UINT64_C(0x3030303030303030) & read_mask);
+        }
+        else
+        {
+            // gather the characters in a register: going through
+            // memory would stall the load
+            chars = UINT64_C(0x3030303030303030) >> (8u * len);
+            for(unsigned i = 8u - static_cast<unsigned>(len); i < 8u; ++i, ++str)
+                chars |= static_cast<uint64_t>(static_cast<uint8_t>(*str)) << (8u * i);
+        }
+        if(C4_UNLIKELY( ! (bits == 4u ? _swar_read_hex8(chars, &chunk) : (bits == 3u ? _swar_read_oct8(chars, &chunk) : _swar_read_bin8(chars, &chunk)))))
+            return false;
+        acc = static_cast<U>((static_cast<W>(acc) << (bits * len)) | chunk);
+    }
+    *v = static_cast<I>(acc);
+    return true;
+}
+
+/** read the decimal digits at the start of [str,end), stopping at
+ * the first character which is not a digit. The digits are found
+ * and converted eight at a time, so that the end of the number
+ * need not be known beforehand.
+ * @return a pointer to the first character which is not a digit */
+template<class U>
+C4_ALWAYS_INLINE const char* _read_dec_prefix(const char *C4_RESTRICT str, const char *C4_RESTRICT end, U *C4_RESTRICT v) noexcept
+{
+    C4_STATIC_ASSERT(detail::is_uint<U>::value);
+    U acc = 0;
+    while(end - str >= 8)
+    {
+        const uint64_t chunk = _swar_load8(str);
+        const uint64_t nondec = _swar_nondec8(chunk);
+        if(C4_LIKELY(nondec == 0u))
+        {
+            acc = static_cast<U>(acc * U(100000000) + U(_swar_parse_dec8(chunk)));
+            str += 8;
+            continue;
+        }
+        // number of digits before the first non-digit
+        const unsigned k = (_bitwidth(nondec & (~nondec + 1u)) - 1u) >> 3u;
+        if(k)
+        {
+            // move the digits to the top, and fill the bottom with zeroes
+            const uint64_t digits = (chunk << (64u - 8u * k)) | (UINT64_C(0x3030303030303030) >> (8u * k));
+            acc = static_cast<U>(acc * static_cast<U>(powers_of_10_u32[k]) + U(_swar_parse_dec8(digits)));
+        }
+        *v = acc;
+        return str + k;
+    }
+    for( ; str < end; ++str)
+    {
+        const char c = *str;
+        if(c < '0' || c > '9')
+            break;
+        acc = static_cast<U>(acc * U(10) + static_cast<U>(c - '0'));
+    }
+    *v = acc;
+    return str;
+}
+
+/** read the hexadecimal digits at the start of [str,end), stopping
+ * at the first character which is not an hexadecimal digit, as in
+ * _read_dec_prefix(). Digits beyond the width of U are shifted out.
+ * @return a pointer to the first character which is not a digit */
+template<class U>
+C4_ALWAYS_INLINE const char* _read_hex_prefix(const char *C4_RESTRICT str, const char *C4_RESTRICT end, U *C4_RESTRICT v) noexcept
+{
+    C4_STATIC_ASSERT(detail::is_uint<U>::value);
+    C4_STATIC_ASSERT(sizeof(U) >= 8u);
+    U acc = 0;
+    while(end - str >= 8)
+    {
+        const uint64_t chunk = _swar_load8(str);
+        const uint64_t nonhex = _swar_nonhex8(chunk);
+        if(C4_LIKELY(nonhex == 0u))
+        {
+            acc = static_cast<U>((acc << 32u) | _swar_parse_hex8(chunk));
+            str += 8;
+            continue;
+        }
+        // number of digits before the first non-digit
+        const unsigned k = (_bitwidth(nonhex & (~nonhex + 1u)) - 1u) >> 3u;
+        if(k)
+        {
+            // move the digits to the top, and fill the bottom with zeroes
+            const uint64_t digits = (chunk << (64u - 8u * k)) | (UINT64_C(0x3030303030303030) >> (8u * k));
+            acc = static_cast<U>((acc << (4u * k)) | _swar_parse_hex8(digits));
+        }
+        *v = acc;
+        return str + k;
+    }
+    for( ; str < end; ++str)
+    {
+        const char c = *str;
+        if( ! csubstr::_is_hex_char(c))
+            break;
+        acc = static_cast<U>((acc << 4u) | static_cast<U>(c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10));
+    }
+    *v = acc;
+    return str;
+}
+
+} // namespace detail
+
+
 /** read a decimal integer from a string. This is the
  * lowest level (and the fastest) function to do this task.
+ * Digits are validated and converted eight (or four) at a time.
  * @note does not accept negative numbers
  * @note The string must be trimmed. Whitespace is not accepted.
+ * @note overflow is not detected; the result wraps around the
+ * type's range.
  * @return true if the conversion was successful */
 template<class I>
 C4_ALWAYS_INLINE bool read_dec(csubstr s, I *C4_RESTRICT v)
 {
-    C4_STATIC_ASSERT(std::is_integral<I>::value);
+    C4_STATIC_ASSERT(detail::is_int<I>::value);
+    // do the arithmetic in an unsigned type at least as wide as I,
+    // which wraps around in the same way as I.
+    using U = detail::dec_uint<I>;
+    U acc = 0;
     *v = 0;
-    for(char c : s)
+    const char *C4_RESTRICT str = s.str;
+    size_t len = s.len;
+    while(len >= 8u)
+    {
+        const uint64_t chunk = detail::_swar_load8(str);
+        if(C4_UNLIKELY( ! detail::_swar_is_dec8(chunk)))
+            return false;
+        acc = static_cast<U>(acc * U(100000000) + U(detail::_swar_parse_dec8(chunk)));
+        str += 8;
+        len -= 8u;
+    }
+    if(len >= 4u)
+    {
+        const uint32_t chunk = detail::_swar_load4(str);
+        if(C4_UNLIKELY( ! detail::_swar_is_dec4(chunk)))
+            return false;
+        acc = static_cast<U>(acc * U(10000) + U(detail::_swar_parse_dec4(chunk)));
+        str += 4;
+        len -= 4u;
+    }
+    for(; len; --len, ++str)
     {
+        const char c = *str;
         if(C4_UNLIKELY(c < '0' || c > '9'))
             return false;
-        *v = (*v) * I(10) + (I(c) - I('0'));
+        acc = static_cast<U>(acc * U(10) + static_cast<U>(c - '0'));
     }
+    *v = static_cast<I>(acc);
     return true;
 }
 
 /** read an hexadecimal integer from a string. This is the
  * lowest level (and the fastest) function to do this task.
+ * Digits are validated and converted eight at a time.
  * @note does not accept negative numbers
  * @note does not accept leading 0x or 0X
  * @note the string must be trimmed. Whitespace is not accepted.
@@ -399,26 +1138,12 @@ C4_ALWAYS_INLINE bool read_dec(csubstr s, I *C4_RESTRICT v)
 template<class I>
 C4_ALWAYS_INLINE bool read_hex(csubstr s, I *C4_RESTRICT v)
 {
-    C4_STATIC_ASSERT(std::is_integral<I>::value);
-    *v = 0;
-    for(char c : s)
-    {
-        I cv;
-        if(c >= '0' && c <= '9')
-            cv = I(c) - I('0');
-        else if(c >= 'a' && c <= 'f')
-            cv = I(10) + (I(c) - I('a'));
-        else if(c >= 'A' && c <= 'F')
-            cv = I(10) + (I(c) - I('A'));
-        else
-            return false;
-        *v = (*v) * I(16) + cv;
-    }
-    return true;
+    return detail::_read_pow2<4u>(s, v);
 }
 
 /** read a binary integer from a string. This is the
  * lowest level (and the fastest) function to do this task.
+ * Digits are validated and converted eight at a time.
  * @note does not accept negative numbers
  * @note does not accept leading 0b or 0B
  * @note the string must be trimmed. Whitespace is not accepted.
@@ -426,21 +1151,12 @@ C4_ALWAYS_INLINE bool read_hex(csubstr s, I *C4_RESTRICT v)
 template<class I>
 C4_ALWAYS_INLINE bool read_bin(csubstr s, I *C4_RESTRICT v)
 {
-    C4_STATIC_ASSERT(std::is_integral<I>::value);
-    *v = 0;
-    for(char c : s)
-    {
-        *v <<= 1;
-        if(c == '1')
-            *v |= 1;
-        else if(c != '0')
-            return false;
-    }
-    return true;
+    return detail::_read_pow2<1u>(s, v);
 }
 
 /** read an octal integer from a string. This is the
  * lowest level (and the fastest) function to do this task.
+ * Digits are validated and converted eight at a time.
  * @note does not accept negative numbers
  * @note does not accept leading 0o or 0O
  * @note the string must be trimmed. Whitespace is not accepted.
@@ -448,15 +1164,7 @@ C4_ALWAYS_INLINE bool read_bin(csubstr s, I *C4_RESTRICT v)
 template<class I>
 C4_ALWAYS_INLINE bool read_oct(csubstr s, I *C4_RESTRICT v)
 {
-    C4_STATIC_ASSERT(std::is_integral<I>::value);
-    *v = 0;
-    for(char c : s)
-    {
-        if(C4_UNLIKELY(c < '0' || c > '7'))
-            return false;
-        *v = (*v) * I(8) + (I(c) - I('0'));
-    }
-    return true;
+    return detail::_read_pow2<3u>(s, v);
 }
 
 
@@ -497,6 +1205,15 @@ template<> struct itoa_min<8>
     static csubstr value_oct() { return csubstr("1000000000000000000000"); }
     static csubstr value_bin() { return csubstr("1000000000000000000000000000000000000000000000000000000000000000"); }
 };
+#if C4CORE_HAVE_INT128
+template<> struct itoa_min<16>
+{
+    static csubstr value_dec() { return csubstr("170141183460469231731687303715884105728"); }
+    static csubstr value_hex() { return csubstr("80000000000000000000000000000000"); }
+    static csubstr value_oct() { return csubstr("2000000000000000000000000000000000000000000"); }
+    static csubstr value_bin() { return csubstr("10000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"); }
+};
+#endif
 inline size_t _itoa2buf(substr buf, size_t pos, csubstr val)
 {
     if(C4_LIKELY(pos + val.len <= buf.len))
@@ -572,14 +1289,14 @@ size_t _itoa2buf(substr buf, I radix, size_t num_digits)
 template<class T>
 size_t itoa(substr buf, T v)
 {
-    C4_STATIC_ASSERT(std::is_signed<T>::value);
+    C4_STATIC_ASSERT(detail::is_sint<T>::value);
     if(v >= 0)
     {
         return write_dec(buf, v);
     }
     else
     {
-        if(C4_LIKELY(v != std::numeric_limits<T>::min()))
+        if(C4_LIKELY(v != detail::_int_min<T>()))
         {
             if(C4_LIKELY(buf.len > 0))
             {
@@ -612,11 +1329,11 @@ size_t itoa(substr buf, T v)
 template<class T>
 size_t itoa(substr buf, T v, T radix)
 {
-    C4_STATIC_ASSERT(std::is_signed<T>::value);
+    C4_STATIC_ASSERT(detail::is_sint<T>::value);
     C4_ASSERT(radix == 2 || radix == 8 || radix == 10 || radix == 16);
     // when T is the min value (eg i8: -128), negating it
     // will overflow
-    if(C4_LIKELY(v != std::numeric_limits<T>::min()))
+    if(C4_LIKELY(v != detail::_int_min<T>()))
     {
         size_t pos = 0;
         if(v < 0)
@@ -652,9 +1369,9 @@ size_t itoa(substr buf, T v, T radix)
 template<class T>
 size_t itoa(substr buf, T v, T radix, size_t num_digits)
 {
-    C4_STATIC_ASSERT(std::is_signed<T>::value);
+    C4_STATIC_ASSERT(detail::is_sint<T>::value);
     C4_ASSERT(radix == 2 || radix == 8 || radix == 10 || radix == 16);
-    if(C4_LIKELY(v != std::numeric_limits<T>::min()))
+    if(C4_LIKELY(v != detail::_int_min<T>()))
     {
         size_t pos = 0;
         if(v < 0)
@@ -691,7 +1408,7 @@ size_t itoa(substr buf, T v, T radix, size_t num_digits)
 template<class T>
 size_t utoa(substr buf, T v)
 {
-    C4_STATIC_ASSERT(std::is_unsigned<T>::value);
+    C4_STATIC_ASSERT(detail::is_uint<T>::value);
     return write_dec(buf, v);
 }
 
@@ -702,7 +1419,7 @@ size_t utoa(substr buf, T v)
 template<class T>
 size_t utoa(substr buf, T v, T radix)
 {
-    C4_STATIC_ASSERT(std::is_unsigned<T>::value);
+    C4_STATIC_ASSERT(detail::is_uint<T>::value);
     C4_ASSERT(radix == 10 || radix == 16 || radix == 2 || radix == 8);
     size_t pos = 0;
     switch(radix)
@@ -730,7 +1447,7 @@ size_t utoa(substr buf, T v, T radix)
 template<class T>
 size_t utoa(substr buf, T v, T radix, size_t num_digits)
 {
-    C4_STATIC_ASSERT(std::is_unsigned<T>::value);
+    C4_STATIC_ASSERT(detail::is_uint<T>::value);
     C4_ASSERT(radix == 10 || radix == 16 || radix == 2 || radix == 8);
     size_t pos = 0;
     switch(radix)
@@ -771,20 +1488,20 @@ size_t utoa(substr buf, T v, T radix, size_t num_digits)
 template<class T>
 bool atoi(csubstr str, T * C4_RESTRICT v)
 {
-    C4_STATIC_ASSERT(std::is_integral<T>::value);
-    C4_STATIC_ASSERT(std::is_signed<T>::value);
+    C4_STATIC_ASSERT(detail::is_int<T>::value);
+    C4_STATIC_ASSERT(detail::is_sint<T>::value);
 
     if(C4_UNLIKELY(str.len == 0))
         return false;
 
-    T sign = 1;
+    bool neg = false;
     size_t start = 0;
     if(str.str[0] == '-')
     {
         if(C4_UNLIKELY(str.len == 1))
             return false;
         ++start;
-        sign = -1;
+        neg = true;
     }
 
     if(str.str[start] != '0')
@@ -839,26 +1556,252 @@ bool atoi(csubstr str, T * C4_RESTRICT v)
             }
         }
     }
-    *v *= sign;
+    // negate in the unsigned type: the magnitude of the minimum value
+    // does not fit in T
+    using U = detail::dec_uint<T>;
+    if(neg)
+        *v = static_cast<T>(U(0) - static_cast<U>(*v));
     return true;
 }
 
 
+namespace detail {
+
+/** skip the whitespace preceding the value in the *_first() functions
+ * @see csubstr::first_non_empty_span() */
+C4_ALWAYS_INLINE const char* _skip_first_space(const char *C4_RESTRICT s, const char *C4_RESTRICT end) noexcept
+{
+    while(s < end && (*s == ' ' || *s == '\n' || *s == '\r' || *s == '\t'))
+        ++s;
+    return s;
+}
+
+/** read a decimal magnitude, failing if it is larger than @p
+ * max_val. Only strings with as many digits as the max value need
+ * the overflow arithmetic, and only for their last digit. */
+template<class U>
+C4_ALWAYS_INLINE errc _read_dec_checked(csubstr s, U *C4_RESTRICT v, U max_val)
+{
+    C4_STATIC_ASSERT(is_uint<U>::value);
+    // this is std::numeric_limits<U>::digits10, which is not
+    // available for the 128 bit integers in strict ANSI mode
+    enum : size_t { safe_digits = (sizeof(U) * CHAR_BIT * 643u) / 2136u };
+    if(C4_LIKELY(s.len <= safe_digits))
+    {
+        // cannot overflow U, but may still overflow max_val
+        U tmp;
+        if(C4_UNLIKELY( ! read_dec(s, &tmp)))
+            return errc::invalid_argument;
+        if(C4_UNLIKELY(tmp > max_val))
+            return errc::result_out_of_range;
+        *v = tmp;
+        return errc::ok;
+    }
+    else if(s.len == safe_digits + 1u)
+    {
+        U hi;
+        if(C4_UNLIKELY( ! read_dec(s.first(safe_digits), &hi)))
+            return errc::invalid_argument;
+        const char c = s.str[safe_digits];
+        if(C4_UNLIKELY(c < '0' || c > '9'))
+            return errc::invalid_argument;
+        const U digit = static_cast<U>(c - '0');
+        if(C4_UNLIKELY(hi > static_cast<U>(max_val - digit) / U(10)))
+            return errc::result_out_of_range;
+        *v = static_cast<U>(hi * U(10) + digit);
+        return errc::ok;
+    }
+    // too many digits. Still need to tell apart invalid characters.
+    uint64_t dummy;
+    return read_dec(s, &dummy) ? errc::result_out_of_range : errc::invalid_argument;
+}
+
+/** read a magnitude in a power-of-two radix, failing if it is
+ * larger than @p max_val. */
+template<class U, unsigned bits_per_digit, bool (*reader)(csubstr, U*)>
+C4_ALWAYS_INLINE errc _read_pow2_checked(csubstr s, U *C4_RESTRICT v, U max_val)
+{
+    C4_STATIC_ASSERT(is_uint<U>::value);
+    enum : size_t {
+        num_bits = sizeof(U) * CHAR_BIT,
+        max_digits = (num_bits + bits_per_digit - 1u) / bits_per_digit,
+        // when the bits do not divide evenly, the first digit has fewer bits
+        first_digit_bits = num_bits - (max_digits - 1u) * bits_per_digit,
+    };
+    // leading zeroes do not count
+    size_t fno = s.first_not_of('0');
+    s = (fno != csubstr::npos) ? s.sub(fno) : s.last(1);
+    U tmp;
+    if(C4_UNLIKELY( ! reader(s, &tmp)))
+        return errc::invalid_argument;
+    if(C4_UNLIKELY(s.len > max_digits))
+        return errc::result_out_of_range;
+    if C4_IF_CONSTEXPR (first_digit_bits != bits_per_digit)
+    {
+        // the only digits are 0-7 in this case (octal), so the
+        // digit value is the character offset
+        if(s.len == max_digits && (static_cast<unsigned>(s.str[0] - '0') >> first_digit_bits) != 0u)
+            return errc::result_out_of_range;
+    }
+    if(C4_UNLIKELY(tmp > max_val))
+        return errc::result_out_of_range;
+    *v = tmp;
+    return errc::ok;
+}
+
+/** read the digits of a power-of-two radix in [digits,digits_end[,
+ * which were already checked to be valid. */
+template<class U, unsigned bits_per_digit, bool (*reader)(csubstr, U*), bool checked>
+C4_ALWAYS_INLINE errc _read_pow2_span(const char *C4_RESTRICT digits, const char *C4_RESTRICT digits_end, U *C4_RESTRICT mag, U max_val) noexcept
+{
+    if(C4_UNLIKELY(digits_end == digits))
+        return errc::invalid_argument;
+    const csubstr span(digits, static_cast<size_t>(digits_end - digits));
+    if C4_IF_CONSTEXPR (checked)
+        return _read_pow2_checked<U, bits_per_digit, reader>(span, mag, max_val);
+    C4_UNUSED(max_val);
+    return reader(span, mag) ? errc::ok : errc::invalid_argument;
+}
+
+/** read an integer from the start of [s,end[ in a single pass: the
+ * end of the number is found while it is converted, so the string is
+ * not delimited first. On return, @p s points at the character where
+ * the reading stopped: the end of the number, or the offending
+ * character. When @p checked is true, values out of the type's range
+ * fail with errc::result_out_of_range; otherwise, they wrap around as
+ * in atoi(). The value is written only on success. */
+template<class T, bool allow_minus, bool checked>
+C4_ALWAYS_INLINE errc _read_int_prefix(const char *& s, const char *C4_RESTRICT end, T *C4_RESTRICT v) noexcept
+{
+    using U = typename make_uint<T>::type;
+    bool neg = false;
+    if C4_IF_CONSTEXPR (allow_minus)
+    {
+        if(s < end && *s == '-')
+        {
+            neg = true;
+            ++s;
+        }
+    }
+    // the magnitude of the minimum value is one more than the maximum
+    const U max_val = is_sint<T>::value ?
+        static_cast<U>(static_cast<U>(static_cast<U>(_int_min<T>()) - 1u) + static_cast<U>(neg)) :
+        static_cast<U>(~U(0));
+    U mag;
+    if(C4_UNLIKELY(end - s > 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X' || s[1] == 'b' || s[1] == 'B' || s[1] == 'o' || s[1] == 'O')))
+    {
+        const char pfx = static_cast<char>(s[1] | 0x20);
+        const char *C4_RESTRICT digits = s + 2;
+        s = digits;
+        errc err;
+        if(pfx == 'x')
+        {
+            while(s < end && csubstr::_is_hex_char(*s))
+                ++s;
+            err = _read_pow2_span<U, 4u, &read_hex<U>, checked>(digits, s, &mag, max_val);
+        }
+        else if(pfx == 'b')
+        {
+            while(s < end && (*s == '0' || *s == '1'))
+                ++s;
+            err = _read_pow2_span<U, 1u, &read_bin<U>, checked>(digits, s, &mag, max_val);
+        }
+        else
+        {
+            while(s < end && csubstr::_is_oct_char(*s))
+                ++s;
+            err = _read_pow2_span<U, 3u, &read_oct<U>, checked>(digits, s, &mag, max_val);
+        }
+        if(C4_UNLIKELY(err != errc::ok))
+            return err;
+    }
+    else
+    {
+        const char *C4_RESTRICT digits = s;
+        s = _read_dec_prefix(s, end, &mag);
+        if(C4_UNLIKELY(s == digits))
+            return errc::invalid_argument;
+        if C4_IF_CONSTEXPR (checked)
+        {
+            // cannot have overflowed unless there are many digits
+            enum : size_t { safe_digits = (sizeof(U) * CHAR_BIT * 643u) / 2136u };
+            if(C4_UNLIKELY(mag > max_val || static_cast<size_t>(s - digits) > safe_digits))
+            {
+                csubstr dec(digits, static_cast<size_t>(s - digits));
+                const size_t fno = dec.first_not_of('0');
+                dec = (fno != csubstr::npos) ? dec.sub(fno) : dec.last(1);
+                const errc err = _read_dec_checked(dec, &mag, max_val);
+                if(C4_UNLIKELY(err != errc::ok))
+                    return err;
+            }
+        }
+    }
+    *v = static_cast<T>(neg ? static_cast<U>(U(0) - mag) : mag);
+    return errc::ok;
+}
+
+/** read an integer from the start of a string, skipping leading
+ * whitespace. The number must be followed by the end of the string
+ * or by a delimiter (see csubstr::_is_delim_char()). The value is
+ * not modified on failure.
+ * @see _read_int_prefix() */
+template<class T, bool allow_minus=is_sint<T>::value, bool checked=false>
+C4_ALWAYS_INLINE parse_result _atoi_first_checked(csubstr str, T *C4_RESTRICT v) noexcept
+{
+    const char *C4_RESTRICT end = str.str + str.len;
+    const char *s = _skip_first_space(str.str, end);
+    T val = 0;
+    errc err = _read_int_prefix<T, allow_minus, checked>(s, end, &val);
+    if(C4_UNLIKELY(s < end && !csubstr::_is_delim_char(*s)))
+        err = errc::invalid_argument;
+    else if(C4_LIKELY(err == errc::ok))
+        *v = val;
+    return parse_result{static_cast<size_t>(s - str.str), err};
+}
+
+/** read an integer which must span the whole string. The value is
+ * not modified on failure.
+ * @see _read_int_prefix() */
+template<class T, bool allow_minus=is_sint<T>::value, bool checked=false>
+C4_ALWAYS_INLINE parse_result _atoi_checked(csubstr str, T *C4_RESTRICT v) noexcept
+{
+    const char *C4_RESTRICT end = str.str + str.len;
+    const char *s = str.str;
+    T val = 0;
+    errc err = _read_int_prefix<T, allow_minus, checked>(s, end, &val);
+    if(C4_UNLIKELY(s != end))
+        err = errc::invalid_argument;
+    else if(C4_LIKELY(err == errc::ok))
+        *v = val;
+    return parse_result{static_cast<size_t>(s - str.str), err};
+}
+
+/** read an integer from the start of a string in a single pass,
+ * without overflow detection.
+ * @return the number of characters read, including the leading
+ * whitespace, or csubstr::npos if no number could be read
+ * @see _atoi_first_checked() */
+template<class T, bool allow_minus=is_sint<T>::value>
+C4_ALWAYS_INLINE size_t _atoi_first(csubstr str, T *C4_RESTRICT v) noexcept
+{
+    return _atoi_first_checked<T, allow_minus, false>(str, v).first();
+}
+
+} // namespace detail
+
+
 /** Select the next range of characters in the string that can be parsed
- * as a signed integral value, and convert it using atoi(). Leading
- * whitespace (space, newline, tabs) is skipped.
+ * as a signed integral value, and convert it as atoi() would. Leading
+ * whitespace (space, newline, tabs) is skipped. The end of the number
+ * is found while it is being converted, in a single pass.
  * @return the number of characters read for conversion, or csubstr::npos if the conversion failed
  * @see atoi() if the string is already trimmed to the value to read.
  * @see csubstr::first_int_span() */
 template<class T>
 inline size_t atoi_first(csubstr str, T * C4_RESTRICT v)
 {
-    csubstr trimmed = str.first_int_span();
-    if(trimmed.len == 0)
-        return csubstr::npos;
-    if(atoi(trimmed, v))
-        return static_cast<size_t>(trimmed.end() - str.begin());
-    return csubstr::npos;
+    C4_STATIC_ASSERT(detail::is_sint<T>::value);
+    return detail::_atoi_first(str, v);
 }
 
 
@@ -882,7 +1825,7 @@ inline size_t atoi_first(csubstr str, T * C4_RESTRICT v)
 template<class T>
 bool atou(csubstr str, T * C4_RESTRICT v)
 {
-    C4_STATIC_ASSERT(std::is_integral<T>::value);
+    C4_STATIC_ASSERT(detail::is_int<T>::value);
 
     if(C4_UNLIKELY(str.len == 0 || str.front() == '-'))
         return false;
@@ -938,20 +1881,142 @@ bool atou(csubstr str, T * C4_RESTRICT v)
 
 
 /** Select the next range of characters in the string that can be parsed
- * as an unsigned integral value, and convert it using atou(). Leading
- * whitespace (space, newline, tabs) is skipped.
- * @return the number of characters read for conversion, or csubstr::npos if the conversion faileds
+ * as an unsigned integral value, and convert it as atou() would. Leading
+ * whitespace (space, newline, tabs) is skipped. The end of the number
+ * is found while it is being converted, in a single pass.
+ * @return the number of characters read for conversion, or csubstr::npos if the conversion failed
  * @see atou() if the string is already trimmed to the value to read.
  * @see csubstr::first_uint_span() */
 template<class T>
 inline size_t atou_first(csubstr str, T *v)
 {
-    csubstr trimmed = str.first_uint_span();
-    if(trimmed.len == 0)
-        return csubstr::npos;
-    if(atou(trimmed, v))
-        return static_cast<size_t>(trimmed.end() - str.begin());
-    return csubstr::npos;
+    C4_STATIC_ASSERT(detail::is_int<T>::value);
+    return detail::_atoi_first<T, false>(str, v);
+}
+
+
+//-----------------------------------------------------------------------------
+
+namespace detail {
+
+/** read an unsigned magnitude with an optional radix prefix, failing
+ * if it is larger than @p max_val. */
+template<class U>
+errc _atou_checked(csubstr str, U *C4_RESTRICT v, U max_val)
+{
+    if(C4_UNLIKELY(str.len == 0))
+        return errc::invalid_argument;
+    if(str.str[0] == '0' && str.len > 1)
+    {
+        const char pfx = str.str[1];
+        if(pfx == 'x' || pfx == 'X') // hexadecimal
+        {
+            if(C4_UNLIKELY(str.len <= 2))
+                return errc::invalid_argument;
+            return _read_pow2_checked<U, 4u, &read_hex<U>>(str.sub(2), v, max_val);
+        }
+        else if(pfx == 'b' || pfx == 'B') // binary
+        {
+            if(C4_UNLIKELY(str.len <= 2))
+                return errc::invalid_argument;
+            return _read_pow2_checked<U, 1u, &read_bin<U>>(str.sub(2), v, max_val);
+        }
+        else if(pfx == 'o' || pfx == 'O') // octal
+        {
+            if(C4_UNLIKELY(str.len <= 2))
+                return errc::invalid_argument;
+            return _read_pow2_checked<U, 3u, &read_oct<U>>(str.sub(2), v, max_val);
+        }
+        // we know the first character is 0
+        size_t fno = str.first_not_of('0');
+        if(fno == csubstr::npos)
+        {
+            *v = 0;
+            return errc::ok;
+        }
+        str = str.sub(fno);
+    }
+    return _read_dec_checked(str, v, max_val);
+}
+
+} // namespace detail
+
+
+/** Like c4::atoi(), but detect overflow: if the value does not fit in
+ * the type, errc::result_out_of_range is returned. The digit count
+ * is compared first, so that the overflow arithmetic is only needed
+ * for numbers with as many digits as the type's range.
+ * @return errc::ok if the conversion was successful,
+ * errc::invalid_argument if the string is not a valid integer, or
+ * errc::result_out_of_range if the integer is valid but out of
+ * range.
+ * @see atoi() for the unchecked version */
+template<class T>
+errc atoi_checked(csubstr str, T * C4_RESTRICT v)
+{
+    C4_STATIC_ASSERT(std::is_integral<T>::value);
+    C4_STATIC_ASSERT(std::is_signed<T>::value);
+    using U = typename std::make_unsigned<T>::type;
+    U max_val = static_cast<U>(std::numeric_limits<T>::max());
+    bool neg = false;
+    if(str.len > 0 && str.str[0] == '-')
+    {
+        str = str.sub(1);
+        max_val = static_cast<U>(max_val + 1u); // we can go up to -min
+        neg = true;
+    }
+    U mag;
+    const errc ret = detail::_atou_checked(str, &mag, max_val);
+    if(C4_LIKELY(ret == errc::ok))
+        *v = static_cast<T>(neg ? static_cast<U>(U(0) - mag) : mag);
+    return ret;
+}
+
+/** Like c4::atou(), but detect overflow: if the value does not fit in
+ * the type, errc::result_out_of_range is returned.
+ * @return errc::ok if the conversion was successful,
+ * errc::invalid_argument if the string is not a valid integer, or
+ * errc::result_out_of_range if the integer is valid but out of
+ * range.
+ * @see atou() for the unchecked version */
+template<class T>
+errc atou_checked(csubstr str, T * C4_RESTRICT v)
+{
+    C4_STATIC_ASSERT(std::is_integral<T>::value);
+    C4_STATIC_ASSERT(std::is_unsigned<T>::value);
+    if(C4_UNLIKELY(str.len > 0 && str.str[0] == '-'))
+        return errc::invalid_argument;
+    return detail::_atou_checked(str, v, std::numeric_limits<T>::max());
+}
+
+/** dispatch to atoi_checked() or atou_checked() according to the signedness of T */
+template<class T>
+C4_ALWAYS_INLINE typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, errc>::type
+atox_checked(csubstr str, T * C4_RESTRICT v)
+{
+    return atoi_checked(str, v);
+}
+
+/** dispatch to atoi_checked() or atou_checked() according to the signedness of T */
+template<class T>
+C4_ALWAYS_INLINE typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value, errc>::type
+atox_checked(csubstr str, T * C4_RESTRICT v)
+{
+    return atou_checked(str, v);
+}
+
+/** Like c4::atoi_first()/c4::atou_first(), but detect overflow.
+ * @return the number of characters read for conversion, or
+ * csubstr::npos if the conversion failed, in which case the reason
+ * is written to @p err (if it is not null). */
+template<class T>
+size_t atox_first_checked(csubstr str, T * C4_RESTRICT v, errc *err=nullptr)
+{
+    C4_STATIC_ASSERT(std::is_integral<T>::value);
+    const parse_result ret = detail::_atoi_first_checked<T, std::is_signed<T>::value, true>(str, v);
+    if(err)
+        *err = ret.err;
+    return ret.first();
 }
 
 
@@ -987,10 +2052,10 @@ void get_real_format_str(char (& C4_RESTRICT fmt)[N], int precision, RealFormat_
 }
 
 
-/** @todo we're depending on snprintf()/sscanf() for converting to/from
- * floating point numbers. Apparently, this increases the binary size
- * by a considerable amount. There are some lightweight printf
- * implementations:
+/** @todo we're depending on snprintf() for converting floating
+ * point numbers with a precision. Apparently, this increases the
+ * binary size by a considerable amount. There are some lightweight
+ * printf implementations:
  *
  * @see http://www.sparetimelabs.com/tinyprintf/tinyprintf.php (BSD)
  * @see https://github.com/weiss/c99-snprintf
@@ -1027,45 +2092,6 @@ size_t print_one(substr str, const char* full_fmt, T v)
 #endif
 }
 
-#if !C4CORE_HAVE_STD_FROMCHARS && !defined(C4CORE_HAVE_FAST_FLOAT)
-/** scans a string using the given type format, while at the same time
- * allowing non-null-terminated strings AND guaranteeing that the given
- * string length is strictly respected, so that no buffer overflows
- * might occur. */
-template<typename T>
-inline size_t scan_one(csubstr str, const char *type_fmt, T *v)
-{
-    /* snscanf() is absolutely needed here as we must be sure that
-     * str.len is strictly respected, because substr is
-     * generally not null-terminated.
-     *
-     * Alas, there is no snscanf().
-     *
-     * So we fake it by using a dynamic format with an explicit
-     * field size set to the length of the given span.
-     * This trick is taken from:
-     * https://stackoverflow.com/a/18368910/5875572 */
-
-    /* this is the actual format we'll use for scanning */
-    char fmt[16];
-
-    /* write the length into it. Eg "%12f".
-     * Also, get the number of characters read from the string.
-     * So the final format ends up as "%12f%n"*/
-    int iret = std::snprintf(fmt, sizeof(fmt), "%%" "%zu" "%s" "%%n", str.len, type_fmt);
-    /* no nasty surprises, please! */
-    C4_ASSERT(iret >= 0 && size_t(iret) < C4_COUNTOF(fmt));
-
-    /* now we scan with confidence that the span length is respected */
-    int num_chars;
-    iret = std::sscanf(str.str, fmt, v, &num_chars);
-    /* scanf returns the number of successful conversions */
-    if(iret != 1) return csubstr::npos;
-    C4_ASSERT(num_chars >= 0);
-    return (size_t)(num_chars);
-}
-#endif
-
 
 #if C4CORE_HAVE_STD_TOCHARS
 template<class T>
@@ -1112,12 +2138,376 @@ size_t rtoa(substr buf, T v, int precision=-1, RealFormat_e formatting=FTOA_FLEX
 #undef _c4append
 
 
+namespace detail {
+/** write the shortest string which reads back to the same
+ * value. Locale-independent, and with the same result on every
+ * platform. For FTOA_FLEX, the scientific form is chosen as in
+ * printf's %g with default precision.
+ * @p formatting must be FTOA_FLEX or FTOA_SCIENT
+ * @return the number of characters required. Nothing is written
+ * if this is larger than the buffer size. */
+C4CORE_EXPORT size_t ftoa_shortest(substr buf, float v, RealFormat_e formatting) noexcept;
+/** @copydoc ftoa_shortest() */
+C4CORE_EXPORT size_t dtoa_shortest(substr buf, double v, RealFormat_e formatting) noexcept;
+/** write with FTOA_FLOAT and a fixed number of decimals, as
+ * printf("%.*f") would, but from exact integer arithmetic.
+ * @return the number of characters required, or csubstr::npos if
+ * the value is too large for the integer path (in which case
+ * nothing is written) */
+C4CORE_EXPORT size_t ftoa_fixed(substr buf, float v, int precision) noexcept;
+/** @copydoc ftoa_fixed() */
+C4CORE_EXPORT size_t dtoa_fixed(substr buf, double v, int precision) noexcept;
+/** read a real number with the same grammar and semantics as
+ * scanf("%f"), but strictly within the bounds of the string, and
+ * without locale or libc stdio: leading whitespace is skipped, and
+ * then the longest prefix forming a decimal or hexadecimal number,
+ * an infinity or a nan is read. The result is correctly rounded.
+ * @return the number of characters consumed, including the leading
+ * whitespace, or csubstr::npos if no number could be read */
+C4CORE_EXPORT size_t scan_real(csubstr str, float *C4_RESTRICT v) noexcept;
+/** @copydoc scan_real(csubstr, float*) */
+C4CORE_EXPORT size_t scan_real(csubstr str, double *C4_RESTRICT v) noexcept;
+} // namespace detail
+
+
+namespace detail {
+
+/** the bit layout of the IEEE 754 binary types */
+template<class T> struct _real_bits;
+template<> struct _real_bits<float>
+{
+    using bits_type = uint32_t;
+    /** hexa_digits is the number of hexadecimal digits for the mantissa */
+    enum : int32_t { mantissa_bits = 23, exponent_bits = 8, bias = 127, hexa_digits = 6 };
+};
+template<> struct _real_bits<double>
+{
+    using bits_type = uint64_t;
+    /** hexa_digits is the number of hexadecimal digits for the mantissa */
+    enum : int32_t { mantissa_bits = 52, exponent_bits = 11, bias = 1023, hexa_digits = 13 };
+};
+
+/** write a real in hexadecimal format, like printf's %a:
+ * [-]0xh.hhhp[+-]d, where the leading digit is 1 for normals, and 0
+ * for subnormals and zero. The mantissa bits are written directly as
+ * hexadecimal digits, eight at a time. With a negative @p precision
+ * the value is exact, and trailing zeroes are removed; otherwise it
+ * is rounded to @p precision digits, ties to even. A nan whose
+ * mantissa is not that of the default quiet nan is written as
+ * nan(0x...) with its mantissa bits, so that the payload is kept.
+ * @return the number of characters required. Nothing is written if
+ * this is larger than the buffer size. */
+template<class T>
+size_t _write_hexa(substr buf, T v, int precision) noexcept
+{
+    using traits = _real_bits<T>;
+    using U = typename traits::bits_type;
+    enum : int32_t {
+        mantissa_bits = traits::mantissa_bits,
+        max_biased_exponent = (1 << traits::exponent_bits) - 1,
+    };
+    U bits;
+    memcpy(&bits, &v, sizeof(bits));
+    const bool negative = (bits >> ((int32_t)mantissa_bits + (int32_t)traits::exponent_bits)) != 0u;
+    const U mantissa = bits & static_cast<U>((U(1) << mantissa_bits) - 1u);
+    const int32_t biased = static_cast<int32_t>((bits >> mantissa_bits) & static_cast<U>(max_biased_exponent));
+    char *C4_RESTRICT str = buf.str;
+    size_t pos = negative;
+    if(C4_UNLIKELY(biased == max_biased_exponent))
+    {
+        const bool has_payload = mantissa != 0u && mantissa != (U(1) << (mantissa_bits - 1));
+        const unsigned payload_digits = has_payload ? (_bitwidth(mantissa) + 3u) / 4u : 0u;
+        const size_t len = pos + 3u + (has_payload ? 4u + payload_digits : 0u);
+        if(C4_UNLIKELY(len > buf.len))
+            return len;
+        if(negative)
+            str[0] = '-';
+        memcpy(str + pos, mantissa ? "nan(0x" : "inf", has_payload ? 6u : 3u);
+        if(has_payload)
+        {
+            _write_pow2_unchecked<4u>(str + pos + 6u, mantissa, payload_digits);
+            str[len - 1u] = ')';
+        }
+        return len;
+    }
+    char lead = biased ? '1' : '0';
+    const int32_t exp2 = biased ? biased - traits::bias : (mantissa ? 1 - traits::bias : 0);
+    // align the mantissa to a whole number of digits
+    U frac = static_cast<U>(mantissa << (4 * traits::hexa_digits - mantissa_bits));
+    unsigned num_digits = traits::hexa_digits;
+    unsigned num_zeros = 0; // to pad on the right
+    if(precision < 0)
+    {
+        if(frac == 0u)
+            num_digits = 0;
+        else
+        {
+            for( ; (frac & 0xfu) == 0u; frac >>= 4u)
+                --num_digits;
+        }
+    }
+    else if(static_cast<unsigned>(precision) < num_digits)
+    {
+        const unsigned prec = static_cast<unsigned>(precision);
+        const unsigned drop = 4u * (num_digits - prec);
+        const U rem = frac & static_cast<U>((U(1) << drop) - 1u);
+        const U halfway = static_cast<U>(U(1) << (drop - 1u));
+        frac = static_cast<U>(frac >> drop);
+        const bool odd = prec ? (frac & 1u) : (lead & 1); // '1' is odd
+        if(rem > halfway || (rem == halfway && odd))
+        {
+            ++frac;
+            if(frac >> (4u * prec)) // carry into the leading digit
+            {
+                frac = 0;
+                ++lead;
+            }
+        }
+        num_digits = prec;
+    }
+    else
+    {
+        num_zeros = static_cast<unsigned>(precision) - num_digits;
+    }
+    const uint32_t exp_abs = static_cast<uint32_t>(exp2 < 0 ? -exp2 : exp2);
+    const unsigned exp_digits = digits_dec(exp_abs);
+    const size_t frac_len = num_digits + num_zeros;
+    const size_t len = pos + 3u + (frac_len ? 1u + frac_len : 0u) + 2u + exp_digits;
+    if(C4_UNLIKELY(len > buf.len))
+        return len;
+    if(negative)
+        str[0] = '-';
+    str[pos] = '0';
+    str[pos + 1u] = 'x';
+    str[pos + 2u] = lead;
+    pos += 3u;
+    if(frac_len)
+    {
+        str[pos++] = '.';
+        if(num_digits)
+            _write_pow2_unchecked<4u>(str + pos, frac, num_digits);
+        memset(str + pos + num_digits, '0', num_zeros);
+        pos += frac_len;
+    }
+    str[pos] = 'p';
+    str[pos + 1u] = exp2 < 0 ? '-' : '+';
+    write_dec_unchecked(buf.sub(pos + 2u), exp_abs, exp_digits);
+    return len;
+}
+
+/** round m * 2^exp2 to the nearest value of T, ties to even
+ * @param sticky whether nonzero bits below m were dropped
+ * @return the bits of the result, without the sign */
+template<class T>
+C4_ALWAYS_INLINE typename _real_bits<T>::bits_type _hexa_round(uint64_t m, int64_t exp2, bool sticky) noexcept
+{
+    using traits = _real_bits<T>;
+    using U = typename traits::bits_type;
+    enum : int32_t {
+        mantissa_bits = traits::mantissa_bits,
+        min_exponent = 1 - traits::bias,
+    };
+    if(m == 0u)
+        return 0;
+    const int64_t e = exp2 + static_cast<int64_t>(_bitwidth(m)) - 1; // exponent of the leading bit
+    if(C4_UNLIKELY(e > traits::bias))
+        return static_cast<U>(static_cast<U>((1 << traits::exponent_bits) - 1) << mantissa_bits);
+    const bool subnormal = e < min_exponent;
+    const int64_t shift = (subnormal ? static_cast<int64_t>(min_exponent) : e) - mantissa_bits - exp2; // the bits to drop
+    uint64_t q;
+    if(shift <= 0)
+    {
+        q = m << -shift; // exact
+    }
+    else if(shift > 64)
+    {
+        q = 0; // less than half of the smallest subnormal
+    }
+    else
+    {
+        const uint64_t rem = shift == 64 ? m : m & ((UINT64_C(1) << shift) - 1u);
+        const uint64_t halfway = UINT64_C(1) << (shift - 1);
+        q = shift == 64 ? 0u : m >> shift;
+        q += rem > halfway || (rem == halfway && (sticky || (q & 1u)));
+    }
+    // for normals, q has the implicit bit, which adds one to the
+    // exponent; a carry from rounding also goes to the exponent
+    const uint64_t biased = subnormal ? 0u : static_cast<uint64_t>(e + traits::bias - 1);
+    return static_cast<U>((biased << mantissa_bits) + q);
+}
+
+/** whether the real number at the start of [str,end) should be read
+ * with _read_hexa(): it is hexadecimal, or it is a nan, whose
+ * payload the other backends do not keep */
+C4_ALWAYS_INLINE bool _is_hexa_start(const char *C4_RESTRICT str, const char *C4_RESTRICT end) noexcept
+{
+    str += (str < end && *str == '-');
+    return end - str >= 2 && ((str[0] == '0' && (str[1] | 0x20) == 'x') || (str[0] | 0x20) == 'n');
+}
+
+/** read a real number written by _write_hexa() at the start of
+ * [str,end): [-]0xh.hhhp[+-]d, where the point, the fraction and the
+ * exponent are optional, and the prefix and exponent letter may be
+ * upper case. Also read [-]inf, [-]infinity and [-]nan, with an
+ * optional (0x...) payload for the nan. The result is correctly
+ * rounded. The digits are found and converted eight at a time,
+ * with _read_hex_prefix().
+ * @return a pointer to the end of the number, or nullptr if no
+ * number could be read, in which case the value is not modified */
+template<class T>
+const char* _read_hexa(const char *C4_RESTRICT str, const char *C4_RESTRICT end, T *C4_RESTRICT v) noexcept
+{
+    using traits = _real_bits<T>;
+    using U = typename traits::bits_type;
+    enum : int32_t {
+        mantissa_bits = traits::mantissa_bits,
+        max_biased_exponent = (1 << traits::exponent_bits) - 1,
+    };
+    const char *C4_RESTRICT s = str;
+    const bool negative = (s < end && *s == '-');
+    s += negative;
+    U bits;
+    if(end - s >= 2 && s[0] == '0' && (s[1] | 0x20) == 'x')
+    {
+        s += 2;
+        const char *C4_RESTRICT int_beg = s;
+        while(s < end && *s == '0')
+            ++s;
+        const char *C4_RESTRICT sig = s; // the first significant integer digit
+        uint64_t ipart = 0;
+        uint64_t fpart = 0;
+        s = _read_hex_prefix(s, end, &ipart);
+        const char *C4_RESTRICT int_end = s;
+        const char *C4_RESTRICT frac_beg = s;
+        const char *C4_RESTRICT frac_end = s;
+        if(s < end && *s == '.')
+        {
+            frac_beg = ++s;
+            s = _read_hex_prefix(s, end, &fpart);
+            frac_end = s;
+        }
+        if(C4_UNLIKELY(int_end == int_beg && frac_end == frac_beg))
+            return nullptr;
+        int64_t exp2 = 0;
+        if(s < end && (*s | 0x20) == 'p')
+        {
+            const char *C4_RESTRICT e = s + 1;
+            const bool eneg = e < end && *e == '-';
+            e += (e < end && (*e == '-' || *e == '+'));
+            const char *C4_RESTRICT edigits = e;
+            for( ; e < end && *e >= '0' && *e <= '9'; ++e)
+            {
+                if(exp2 < 100000) // saturate: the result is zero or inf anyway
+                    exp2 = 10 * exp2 + (*e - '0');
+            }
+            if(e > edigits) // otherwise the p is not part of the number
+            {
+                exp2 = eneg ? -exp2 : exp2;
+                s = e;
+            }
+            else
+            {
+                exp2 = 0;
+            }
+        }
+        const size_t num_int = static_cast<size_t>(int_end - sig);
+        const size_t num_frac = static_cast<size_t>(frac_end - frac_beg);
+        exp2 -= 4 * static_cast<int64_t>(num_frac);
+        uint64_t m = 0;
+        bool sticky = false;
+        if(C4_LIKELY(num_int + num_frac <= 16u))
+        {
+            m = num_int ? ((ipart << (4u * num_frac)) | fpart) : fpart;
+        }
+        else
+        {
+            // keep the first 16 significant digits
+            for(const char *C4_RESTRICT c = sig; c < frac_end; ++c)
+            {
+                if(c == int_end)
+                    c = frac_beg;
+                if(c == frac_end)
+                    break;
+                const uint32_t d = static_cast<uint32_t>(*c <= '9' ? *c - '0' : (*c | 0x20) - 'a' + 10);
+                if((m >> 60u) == 0u)
+                {
+                    m = (m << 4u) | d;
+                }
+                else
+                {
+                    sticky |= d != 0u;
+                    exp2 += 4;
+                }
+            }
+        }
+        bits = _hexa_round<T>(m, exp2, sticky);
+    }
+    else if(end - s >= 3 && (s[0] | 0x20) == 'i' && (s[1] | 0x20) == 'n' && (s[2] | 0x20) == 'f')
+    {
+        s += 3;
+        if(end - s >= 5 && (s[0] | 0x20) == 'i' && (s[1] | 0x20) == 'n' && (s[2] | 0x20) == 'i' && (s[3] | 0x20) == 't' && (s[4] | 0x20) == 'y')
+            s += 5;
+        bits = static_cast<U>(static_cast<U>(max_biased_exponent) << mantissa_bits);
+    }
+    else if(end - s >= 3 && (s[0] | 0x20) == 'n' && (s[1] | 0x20) == 'a' && (s[2] | 0x20) == 'n')
+    {
+        s += 3;
+        U payload = static_cast<U>(U(1) << (mantissa_bits - 1)); // quiet
+        if(s < end && *s == '(')
+        {
+            const char *C4_RESTRICT p = s + 1;
+            while(p < end && ((*p >= '0' && *p <= '9') || ((*p | 0x20) >= 'a' && (*p | 0x20) <= 'z') || *p == '_'))
+                ++p;
+            if(p < end && *p == ')')
+            {
+                const csubstr seq(s + 1, static_cast<size_t>(p - s - 1));
+                uint64_t n;
+                if(seq.len > 2u && seq.len <= 18u && seq.str[0] == '0' && (seq.str[1] | 0x20) == 'x' && read_hex(seq.sub(2), &n))
+                {
+                    n &= (UINT64_C(1) << mantissa_bits) - 1u;
+                    if(n)
+                        payload = static_cast<U>(n);
+                }
+                s = p + 1;
+            }
+        }
+        bits = static_cast<U>((static_cast<U>(max_biased_exponent) << mantissa_bits) | payload);
+    }
+    else
+    {
+        return nullptr;
+    }
+    if(negative)
+        bits |= static_cast<U>(U(1) << ((int32_t)mantissa_bits + (int32_t)traits::exponent_bits));
+    memcpy(v, &bits, sizeof(bits));
+    return s;
+}
+
+} // namespace detail
+
+
 /** Convert a single-precision real number to string.
  * The string will in general be NOT null-terminated.
  * For FTOA_FLEX, \p precision is the number of significand digits. Otherwise
- * \p precision is the number of decimals. */
+ * \p precision is the number of decimals. With FTOA_FLEX or FTOA_SCIENT
+ * and a negative \p precision, the shortest string which reads back
+ * to the same value is written. FTOA_HEXA is written natively from
+ * the bits of the value (see detail::_write_hexa()), and it is exact
+ * with a negative \p precision.
+ *
+ * @return the number of characters written. */
 inline size_t ftoa(substr str, float v, int precision=-1, RealFormat_e formatting=FTOA_FLEX)
 {
+    if(precision < 0 && (formatting == FTOA_FLEX || formatting == FTOA_SCIENT))
+        return detail::ftoa_shortest(str, v, formatting);
+    if(formatting == FTOA_HEXA)
+        return detail::_write_hexa(str, v, precision);
+    if(formatting == FTOA_FLOAT && precision >= 0)
+    {
+        const size_t ret = detail::ftoa_fixed(str, v, precision);
+        if(C4_LIKELY(ret != csubstr::npos))
+            return ret;
+    }
 #if C4CORE_HAVE_STD_TOCHARS
     return detail::rtoa(str, v, precision, formatting);
 #else
@@ -1131,12 +2521,26 @@ inline size_t ftoa(substr str, float v, int precision=-1, RealFormat_e formattin
 /** Convert a double-precision real number to string.
  * The string will in general be NOT null-terminated.
  * For FTOA_FLEX, \p precision is the number of significand digits. Otherwise
- * \p precision is the number of decimals.
+ * \p precision is the number of decimals. With FTOA_FLEX or FTOA_SCIENT
+ * and a negative \p precision, the shortest string which reads back
+ * to the same value is written. FTOA_HEXA is written natively from
+ * the bits of the value (see detail::_write_hexa()), and it is exact
+ * with a negative \p precision.
  *
  * @return the number of characters written.
  */
 inline size_t dtoa(substr str, double v, int precision=-1, RealFormat_e formatting=FTOA_FLEX)
 {
+    if(precision < 0 && (formatting == FTOA_FLEX || formatting == FTOA_SCIENT))
+        return detail::dtoa_shortest(str, v, formatting);
+    if(formatting == FTOA_HEXA)
+        return detail::_write_hexa(str, v, precision);
+    if(formatting == FTOA_FLOAT && precision >= 0)
+    {
+        const size_t ret = detail::dtoa_fixed(str, v, precision);
+        if(C4_LIKELY(ret != csubstr::npos))
+            return ret;
+    }
 #if C4CORE_HAVE_STD_TOCHARS
     return detail::rtoa(str, v, precision, formatting);
 #else
@@ -1147,15 +2551,138 @@ inline size_t dtoa(substr str, double v, int precision=-1, RealFormat_e formatti
 }
 
 
-/** Convert a string to a single precision real number.
- * The input string must be trimmed to the value, ie
- * no leading or trailing whitespace can be present.
- * @return true iff the conversion succeeded
- * @see atof_first() if the string is not trimmed
- */
-inline bool atof(csubstr str, float * C4_RESTRICT v)
-{
-    C4_ASSERT(str.triml(" \r\t\n").len == str.len);
+namespace detail {
+
+/** the exact powers of ten used by _atof_plain() */
+C4_INLINE_CONSTEXPR const float exact_pow10_f[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f,
+};
+/** @copydoc exact_pow10_f */
+C4_INLINE_CONSTEXPR const double exact_pow10_d[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+template<class T> struct _plain_dec;
+template<> struct _plain_dec<float>
+{
+    /** the largest exact mantissa, 2^24, and power of ten. The
+     * longest string taking the fast path has 8 characters (digits
+     * and point), as longer ones rarely fit in the mantissa */
+    enum : uint64_t { max_mantissa = UINT64_C(1) << 24u, max_decimals = 10, max_len = 8 };
+    static C4_ALWAYS_INLINE float pow10(size_t e) noexcept { return exact_pow10_f[e]; }
+};
+template<> struct _plain_dec<double>
+{
+    /** the largest exact mantissa, 2^53, and power of ten. The
+     * longest string taking the fast path has 16 characters (digits
+     * and point), as longer ones rarely fit in the mantissa */
+    enum : uint64_t { max_mantissa = UINT64_C(1) << 53u, max_decimals = 22, max_len = 16 };
+    static C4_ALWAYS_INLINE double pow10(size_t e) noexcept { return exact_pow10_d[e]; }
+};
+
+/** Clinger's fast path for short plain decimals such as 123.45 or
+ * -0.5: an optional minus sign and a few digits with an optional
+ * point, but no exponent. If the digits fit exactly in the
+ * mantissa of T and the power of ten is also exact, then a single
+ * division gives the correctly rounded result. Up to eight
+ * characters are loaded in one word, where the point is found and
+ * removed and the digits are validated and converted together; longer
+ * strings are read eight digits at a time with _read_dec_prefix().
+ * @return false if the string does not have this shape or the
+ * result would not be exact, in which case the value is not
+ * modified */
+template<class T>
+C4_ALWAYS_INLINE bool _atof_plain(csubstr str, T *C4_RESTRICT v) noexcept
+{
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD != 0
+    // with excess precision the division would round twice
+    C4_UNUSED(str);
+    C4_UNUSED(v);
+    return false;
+#else
+    C4_STATIC_ASSERT(_plain_dec<T>::max_len - 1u <= _plain_dec<T>::max_decimals);
+    C4_STATIC_ASSERT(_plain_dec<T>::max_len <= 19u); // no overflow
+    const char *C4_RESTRICT s = str.str;
+    const char *C4_RESTRICT end = str.str + str.len;
+    const bool neg = (s < end && *s == '-');
+    s += neg;
+    // the digits, and the point if there is one
+    const size_t len = static_cast<size_t>(end - s);
+    uint64_t mantissa;
+    size_t num_decimals = 0;
+    if(C4_LIKELY(len - 1u < 8u))
+    {
+        const uint64_t chunk = _swar_load_upto8(s, len);
+        const uint64_t nondec = _swar_nondec8(chunk) & (~UINT64_C(0) >> (64u - 8u * len));
+        uint64_t digits = chunk;
+        size_t num_digits = len;
+        if(nondec)
+        {
+            // the only non-digit must be the point
+            const unsigned pos = (_bitwidth(nondec & (~nondec + 1u)) - 1u) >> 3u;
+            const uint64_t below = (UINT64_C(1) << (8u * pos)) - 1u;
+            if((nondec & ~(below | (UINT64_C(0xff) << (8u * pos)))) != 0u
+               || ((chunk >> (8u * pos)) & 0xffu) != static_cast<uint8_t>('.')
+               || len == 1u)
+                return false;
+            // remove the point
+            digits = (chunk & below) | (((chunk >> (8u * pos)) >> 8u) << (8u * pos));
+            --num_digits;
+            num_decimals = num_digits - pos;
+        }
+        // move the digits to the top, and fill the bottom with zeroes
+        digits = (digits << (64u - 8u * num_digits)) | ((UINT64_C(0x3030303030303030) >> (8u * num_digits - 1u)) >> 1u);
+        mantissa = _swar_parse_dec8(digits);
+    }
+    else
+    {
+        if(len - 1u >= _plain_dec<T>::max_len)
+            return false;
+        const char *C4_RESTRICT point = _read_dec_prefix(s, end, &mantissa);
+        if(point != end)
+        {
+            if(*point != '.')
+                return false;
+            const char *C4_RESTRICT decimals = point + 1;
+            uint64_t fpart;
+            const char *C4_RESTRICT fend = _read_dec_prefix(decimals, end, &fpart);
+            if(fend != end)
+                return false;
+            num_decimals = static_cast<size_t>(fend - decimals);
+            mantissa = mantissa * powers_of_10_u64[num_decimals] + fpart;
+        }
+    }
+    if(C4_UNLIKELY(mantissa > _plain_dec<T>::max_mantissa))
+        return false;
+    T val = static_cast<T>(mantissa);
+    if(num_decimals)
+        val = val / _plain_dec<T>::pow10(num_decimals);
+    *v = neg ? -val : val;
+    return true;
+#endif
+}
+
+} // namespace detail
+
+
+/** Convert a string to a single precision real number.
+ * The input string must be trimmed to the value, ie
+ * no leading or trailing whitespace can be present.
+ * Short plain decimals (eg 123.45) are converted directly with
+ * Clinger's fast path. Hexadecimal reals (eg 0x1.8p+1) and nans
+ * (with an optional payload, eg nan(0x1)) are read exactly with
+ * detail::_read_hexa(). Other strings use the general backend.
+ * @return true iff the conversion succeeded
+ * @see atof_first() if the string is not trimmed
+ */
+inline bool atof(csubstr str, float * C4_RESTRICT v)
+{
+    C4_ASSERT(str.triml(" \r\t\n").len == str.len);
+    if(detail::_atof_plain(str, v))
+        return true;
+    if(detail::_is_hexa_start(str.str, str.str + str.len))
+        return detail::_read_hexa(str.str, str.str + str.len, v) == str.str + str.len;
 #if C4CORE_HAVE_FAST_FLOAT
     fast_float::from_chars_result result;
     result = fast_float::from_chars(str.str, str.str + str.len, *v);
@@ -1165,7 +2692,7 @@ inline bool atof(csubstr str, float * C4_RESTRICT v)
     result = std::from_chars(str.str, str.str + str.len, *v);
     return result.ec == std::errc();
 #else
-    size_t ret = detail::scan_one(str, "f", v);
+    size_t ret = detail::scan_real(str, v);
     return ret != csubstr::npos;
 #endif
 }
@@ -1174,12 +2701,20 @@ inline bool atof(csubstr str, float * C4_RESTRICT v)
 /** Convert a string to a double precision real number.
  * The input string must be trimmed to the value, ie
  * no leading or trailing whitespace can be present.
+ * Short plain decimals (eg 123.45) are converted directly with
+ * Clinger's fast path. Hexadecimal reals (eg 0x1.8p+1) and nans
+ * (with an optional payload, eg nan(0x1)) are read exactly with
+ * detail::_read_hexa(). Other strings use the general backend.
  * @return true iff the conversion succeeded
  * @see atod_first() if the string is not trimmed
  */
 inline bool atod(csubstr str, double * C4_RESTRICT v)
 {
     C4_ASSERT(str.triml(" \r\t\n").len == str.len);
+    if(detail::_atof_plain(str, v))
+        return true;
+    if(detail::_is_hexa_start(str.str, str.str + str.len))
+        return detail::_read_hexa(str.str, str.str + str.len, v) == str.str + str.len;
 #if C4CORE_HAVE_FAST_FLOAT
     fast_float::from_chars_result result;
     result = fast_float::from_chars(str.str, str.str + str.len, *v);
@@ -1189,39 +2724,412 @@ inline bool atod(csubstr str, double * C4_RESTRICT v)
     result = std::from_chars(str.str, str.str + str.len, *v);
     return result.ec == std::errc();
 #else
-    size_t ret = detail::scan_one(str, "lf", v);
+    size_t ret = detail::scan_real(str, v);
     return ret != csubstr::npos;
 #endif
 }
 
 
+namespace detail {
+
+/** read a real number from the start of [s,end[ in a single pass,
+ * with the same backend as atof()/atod(). On return, @p s points at
+ * the character where the reading stopped: the end of the number,
+ * or the start of the string if it does not begin with a number. The
+ * value is written only on success. */
+template<class T>
+C4_ALWAYS_INLINE errc _read_real_prefix(const char *& s, const char *C4_RESTRICT end, T *C4_RESTRICT v) noexcept
+{
+    if(C4_UNLIKELY(s == end))
+        return errc::invalid_argument;
+    if(_is_hexa_start(s, end))
+    {
+        const char *C4_RESTRICT ret = _read_hexa(s, end, v);
+        if(C4_UNLIKELY(ret == nullptr))
+            return errc::invalid_argument;
+        s = ret;
+        return errc::ok;
+    }
+#if C4CORE_HAVE_FAST_FLOAT
+    // overflow is not an error here: it reads as inf, as with strtod()
+    fast_float::from_chars_result result = fast_float::from_chars(s, end, *v);
+    if(C4_UNLIKELY(result.ec != std::errc()))
+        return errc::invalid_argument;
+    s = result.ptr;
+    return errc::ok;
+#elif C4CORE_HAVE_STD_FROMCHARS
+    T val;
+    std::from_chars_result result = std::from_chars(s, end, val);
+    if(C4_UNLIKELY(result.ec != std::errc()))
+    {
+        if(result.ec != std::errc::result_out_of_range)
+            return errc::invalid_argument;
+        s = result.ptr;
+        return errc::result_out_of_range;
+    }
+    *v = val;
+    s = result.ptr;
+    return errc::ok;
+#else
+    const size_t len = scan_real(csubstr(s, static_cast<size_t>(end - s)), v);
+    if(C4_UNLIKELY(len == csubstr::npos))
+        return errc::invalid_argument;
+    s += len;
+    return errc::ok;
+#endif
+}
+
+/** read a real number from the start of a string, skipping leading
+ * whitespace. The number must be followed by the end of the string
+ * or by a delimiter (see csubstr::_is_delim_char()). The value is
+ * not modified on failure.
+ * @see _read_real_prefix() */
+template<class T>
+inline parse_result _atof_first_checked(csubstr str, T *C4_RESTRICT v) noexcept
+{
+    const char *C4_RESTRICT end = str.str + str.len;
+    const char *s = _skip_first_space(str.str, end);
+    T val;
+    errc err = _read_real_prefix(s, end, &val);
+    if(C4_UNLIKELY(s < end && !csubstr::_is_delim_char(*s)))
+        err = errc::invalid_argument;
+    else if(C4_LIKELY(err == errc::ok))
+        *v = val;
+    return parse_result{static_cast<size_t>(s - str.str), err};
+}
+
+/** read a real number which must span the whole string. The value is
+ * not modified on failure.
+ * @see _read_real_prefix() */
+template<class T>
+inline parse_result _atof_checked(csubstr str, T *C4_RESTRICT v) noexcept
+{
+    if(_atof_plain(str, v))
+        return parse_result{str.len, errc::ok};
+    const char *C4_RESTRICT end = str.str + str.len;
+    const char *s = str.str;
+    T val;
+    errc err = _read_real_prefix(s, end, &val);
+    if(C4_UNLIKELY(s != end))
+        err = errc::invalid_argument;
+    else if(C4_LIKELY(err == errc::ok))
+        *v = val;
+    return parse_result{static_cast<size_t>(s - str.str), err};
+}
+
+/** read a real number from the start of a string in a single pass.
+ * @return the number of characters read, including the leading
+ * whitespace, or csubstr::npos if no number could be read
+ * @see _atof_first_checked() */
+template<class T>
+C4_ALWAYS_INLINE size_t _atof_first(csubstr str, T *C4_RESTRICT v) noexcept
+{
+    return _atof_first_checked(str, v).first();
+}
+
+} // namespace detail
+
+
 /** Convert a string to a single precision real number.
  * Leading whitespace is skipped until valid characters are found.
+ * The end of the number is found while it is being converted, in a
+ * single pass; it must be followed by the end of the string or by a
+ * delimiter.
  * @return the number of characters read from the string, or npos if
  * conversion was not successful or if the string was empty */
 inline size_t atof_first(csubstr str, float * C4_RESTRICT v)
 {
-    csubstr trimmed = str.first_real_span();
-    if(trimmed.len == 0)
-        return csubstr::npos;
-    if(atof(trimmed, v))
-        return static_cast<size_t>(trimmed.end() - str.begin());
-    return csubstr::npos;
+    return detail::_atof_first(str, v);
 }
 
 
 /** Convert a string to a double precision real number.
  * Leading whitespace is skipped until valid characters are found.
+ * The end of the number is found while it is being converted, in a
+ * single pass; it must be followed by the end of the string or by a
+ * delimiter.
  * @return the number of characters read from the string, or npos if
  * conversion was not successful or if the string was empty */
 inline size_t atod_first(csubstr str, double * C4_RESTRICT v)
 {
-    csubstr trimmed = str.first_real_span();
-    if(trimmed.len == 0)
-        return csubstr::npos;
-    if(atod(trimmed, v))
-        return static_cast<size_t>(trimmed.end() - str.begin());
-    return csubstr::npos;
+    return detail::_atof_first(str, v);
+}
+
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+// 16 bit real types
+
+namespace detail {
+
+/** round a double to the nearest value of the 16 bit real type T,
+ * ties to even. Floats widen to double without loss, so this also
+ * rounds floats only once.
+ * @param tie is set to true if the value was exactly halfway between
+ * two values of T
+ * @return the bits of the result */
+template<class T>
+C4_ALWAYS_INLINE uint16_t _real16_from_double(double v, bool *C4_RESTRICT tie) noexcept
+{
+    enum : int32_t {
+        mantissa_bits = T::mantissa_bits,
+        max_biased_exponent = (1 << T::exponent_bits) - 1,
+    };
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    const uint32_t sign = static_cast<uint32_t>(bits >> 48u) & 0x8000u;
+    const int32_t exponent = static_cast<int32_t>((bits >> 52u) & 0x7ffu);
+    const uint64_t mantissa = bits & ((UINT64_C(1) << 52u) - 1u);
+    *tie = false;
+    if(C4_UNLIKELY(exponent == 0x7ff))
+    {
+        // inf, or nan, which is made quiet so that it stays a nan
+        const uint32_t payload = mantissa ? (1u << (mantissa_bits - 1)) | static_cast<uint32_t>(mantissa >> (52 - mantissa_bits)) : 0u;
+        return static_cast<uint16_t>(sign | (static_cast<uint32_t>(max_biased_exponent) << mantissa_bits) | payload);
+    }
+    int32_t biased = exponent - 1023 + T::bias;
+    if(C4_UNLIKELY(biased >= max_biased_exponent))
+        return static_cast<uint16_t>(sign | (static_cast<uint32_t>(max_biased_exponent) << mantissa_bits));
+    int32_t shift = 52 - mantissa_bits;
+    if(biased <= 0)
+    {
+        // subnormal in T
+        shift += 1 - biased;
+        if(shift > 53) // less than half of the smallest subnormal
+            return static_cast<uint16_t>(sign);
+        biased = 1;
+    }
+    const uint64_t significand = mantissa | (UINT64_C(1) << 52u);
+    const uint64_t q = significand >> shift;
+    const uint64_t rem = significand & ((UINT64_C(1) << shift) - 1u);
+    const uint64_t halfway = UINT64_C(1) << (shift - 1);
+    *tie = (rem == halfway);
+    const uint32_t up = rem > halfway || (rem == halfway && (q & 1u));
+    // for normals, q has the implicit bit, which adds one to the
+    // exponent; a carry from rounding also goes to the exponent
+    return static_cast<uint16_t>(sign | ((static_cast<uint32_t>(biased - 1) << mantissa_bits) + static_cast<uint32_t>(q) + up));
+}
+
+/** widen the bits of the 16 bit real type T to float. This is exact. */
+template<class T>
+C4_ALWAYS_INLINE float _real16_to_float(uint16_t v) noexcept
+{
+    enum : int32_t {
+        mantissa_bits = T::mantissa_bits,
+        max_biased_exponent = (1 << T::exponent_bits) - 1,
+    };
+    uint32_t bits;
+    if C4_IF_CONSTEXPR (T::exponent_bits == 8)
+    {
+        // the same exponent as float: only the mantissa is shorter
+        bits = static_cast<uint32_t>(v) << 16u;
+    }
+    else
+    {
+        const uint32_t sign = static_cast<uint32_t>(v & 0x8000u) << 16u;
+        const int32_t exponent = (v >> mantissa_bits) & max_biased_exponent;
+        const uint32_t mantissa = v & ((1u << mantissa_bits) - 1u);
+        if(exponent == max_biased_exponent)
+        {
+            bits = sign | UINT32_C(0x7f800000) | (mantissa << (23 - mantissa_bits));
+        }
+        else if(exponent)
+        {
+            bits = sign | (static_cast<uint32_t>(exponent - T::bias + 127) << 23u) | (mantissa << (23 - mantissa_bits));
+        }
+        else if(mantissa)
+        {
+            // subnormal in T, but normal in float
+            const unsigned width = _bitwidth(mantissa);
+            const int32_t e = static_cast<int32_t>(width) - T::bias - mantissa_bits;
+            bits = sign | (static_cast<uint32_t>(e + 127) << 23u) | ((mantissa << (24u - width)) & UINT32_C(0x7fffff));
+        }
+        else
+        {
+            bits = sign;
+        }
+    }
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+} // namespace detail
+
+
+/** IEEE 754 binary16 (half precision) real number: 1 sign bit, 5
+ * exponent bits and 10 mantissa bits. This is a storage type only:
+ * it has no arithmetic, but it can be converted to and from float
+ * and double, and to and from strings with the charconv functions.
+ * @see bfloat16 */
+struct half
+{
+    enum : int32_t { mantissa_bits = 10, exponent_bits = 5, bias = 15 };
+
+    uint16_t bits;
+
+    half() = default;
+    /** round to the nearest half, ties to even */
+    explicit half(float v) noexcept { bool tie; bits = detail::_real16_from_double<half>(v, &tie); }
+    /** round to the nearest half, ties to even */
+    explicit half(double v) noexcept { bool tie; bits = detail::_real16_from_double<half>(v, &tie); }
+    /** widen to float, which is exact */
+    explicit operator float() const noexcept { return detail::_real16_to_float<half>(bits); }
+
+    static half from_bits(uint16_t b) noexcept { half h; h.bits = b; return h; }
+};
+
+
+/** bfloat16 (brain floating point) real number: 1 sign bit, 8
+ * exponent bits and 7 mantissa bits, ie the upper half of a
+ * float. This is a storage type only: it has no arithmetic, but it
+ * can be converted to and from float and double, and to and from
+ * strings with the charconv functions.
+ * @see half */
+struct bfloat16
+{
+    enum : int32_t { mantissa_bits = 7, exponent_bits = 8, bias = 127 };
+
+    uint16_t bits;
+
+    bfloat16() = default;
+    /** round to the nearest bfloat16, ties to even */
+    explicit bfloat16(float v) noexcept { bool tie; bits = detail::_real16_from_double<bfloat16>(v, &tie); }
+    /** round to the nearest bfloat16, ties to even */
+    explicit bfloat16(double v) noexcept { bool tie; bits = detail::_real16_from_double<bfloat16>(v, &tie); }
+    /** widen to float, which is exact */
+    explicit operator float() const noexcept { return detail::_real16_to_float<bfloat16>(bits); }
+
+    static bfloat16 from_bits(uint16_t b) noexcept { bfloat16 h; h.bits = b; return h; }
+};
+
+
+namespace detail {
+
+/** @copydoc ftoa_shortest(substr, float, RealFormat_e)
+ * The digits are found from the bits of the half, so they are the
+ * shortest for the half, not for the widened float. */
+C4CORE_EXPORT size_t ftoa_shortest(substr buf, half v, RealFormat_e formatting) noexcept;
+/** @copydoc ftoa_shortest(substr, half, RealFormat_e) */
+C4CORE_EXPORT size_t ftoa_shortest(substr buf, bfloat16 v, RealFormat_e formatting) noexcept;
+/** @copydoc scan_real(csubstr, float*) */
+C4CORE_EXPORT size_t scan_real(csubstr str, half *C4_RESTRICT v) noexcept;
+/** @copydoc scan_real(csubstr, float*) */
+C4CORE_EXPORT size_t scan_real(csubstr str, bfloat16 *C4_RESTRICT v) noexcept;
+
+template<class T>
+inline size_t _ftoa16(substr str, T v, int precision, RealFormat_e formatting)
+{
+    if(precision < 0 && (formatting == FTOA_FLEX || formatting == FTOA_SCIENT))
+        return ftoa_shortest(str, v, formatting);
+    // the float has exactly the same value
+    return ftoa(str, static_cast<float>(v), precision, formatting);
+}
+
+/** set the 16 bit real from a double which was read from @p str,
+ * rounding it only once. The double is correctly rounded, so it is
+ * on the same side of any midpoint between two values of T as the
+ * exact number in the string, unless it is the midpoint itself: in
+ * that case @p str is read again, exactly, with scan_real(). */
+template<class T>
+C4_ALWAYS_INLINE void _narrow_read(csubstr str, double d, T *C4_RESTRICT v) noexcept
+{
+    bool tie;
+    const uint16_t bits = _real16_from_double<T>(d, &tie);
+    if(C4_LIKELY(!tie))
+        v->bits = bits;
+    else
+        scan_real(str, v);
+}
+
+template<class T>
+inline parse_result _atof16_checked(csubstr str, T *C4_RESTRICT v) noexcept
+{
+    double d;
+    const parse_result ret = _atof_checked(str, &d);
+    if(C4_LIKELY(ret.err == errc::ok))
+        _narrow_read(str, d, v);
+    return ret;
+}
+
+template<class T>
+inline parse_result _atof16_first_checked(csubstr str, T *C4_RESTRICT v) noexcept
+{
+    double d;
+    const parse_result ret = _atof_first_checked(str, &d);
+    if(C4_LIKELY(ret.err == errc::ok))
+        _narrow_read(str.first(ret.consumed), d, v);
+    return ret;
+}
+
+template<class T>
+C4_ALWAYS_INLINE bool _atof16(csubstr str, T *C4_RESTRICT v)
+{
+    return _atof16_checked(str, v).ok();
+}
+
+template<class T>
+C4_ALWAYS_INLINE size_t _atof16_first(csubstr str, T *C4_RESTRICT v)
+{
+    return _atof16_first_checked(str, v).first();
+}
+
+} // namespace detail
+
+
+/** Convert a half precision real number to string. With FTOA_FLEX
+ * or FTOA_SCIENT and a negative @p precision, the shortest string
+ * which reads back to the same half is written. Otherwise, this is
+ * the same as ftoa() with the value widened to float.
+ * @return the number of characters written. */
+inline size_t ftoa(substr str, half v, int precision=-1, RealFormat_e formatting=FTOA_FLEX)
+{
+    return detail::_ftoa16(str, v, precision, formatting);
+}
+
+/** Convert a bfloat16 real number to string. With FTOA_FLEX or
+ * FTOA_SCIENT and a negative @p precision, the shortest string which
+ * reads back to the same bfloat16 is written. Otherwise, this is the
+ * same as ftoa() with the value widened to float.
+ * @return the number of characters written. */
+inline size_t ftoa(substr str, bfloat16 v, int precision=-1, RealFormat_e formatting=FTOA_FLEX)
+{
+    return detail::_ftoa16(str, v, precision, formatting);
+}
+
+/** Convert a string to a half precision real number, correctly
+ * rounded. The string must be trimmed to the value, as for atof().
+ * @return true iff the conversion succeeded */
+inline bool atof(csubstr str, half * C4_RESTRICT v)
+{
+    return detail::_atof16(str, v);
+}
+
+/** Convert a string to a bfloat16 real number, correctly
+ * rounded. The string must be trimmed to the value, as for atof().
+ * @return true iff the conversion succeeded */
+inline bool atof(csubstr str, bfloat16 * C4_RESTRICT v)
+{
+    return detail::_atof16(str, v);
+}
+
+/** Convert the first number in a string to a half precision real
+ * number, as atof_first() does for float.
+ * @return the number of characters read from the string, or npos if
+ * conversion was not successful or if the string was empty */
+inline size_t atof_first(csubstr str, half * C4_RESTRICT v)
+{
+    return detail::_atof16_first(str, v);
+}
+
+/** Convert the first number in a string to a bfloat16 real number,
+ * as atof_first() does for float.
+ * @return the number of characters read from the string, or npos if
+ * conversion was not successful or if the string was empty */
+inline size_t atof_first(csubstr str, bfloat16 * C4_RESTRICT v)
+{
+    return detail::_atof16_first(str, v);
 }
 
 
@@ -1240,6 +3148,8 @@ C4_ALWAYS_INLINE size_t xtoa(substr s,  int32_t v) { return itoa(s, v); }
 C4_ALWAYS_INLINE size_t xtoa(substr s,  int64_t v) { return itoa(s, v); }
 C4_ALWAYS_INLINE size_t xtoa(substr s,    float v) { return ftoa(s, v); }
 C4_ALWAYS_INLINE size_t xtoa(substr s,   double v) { return dtoa(s, v); }
+C4_ALWAYS_INLINE size_t xtoa(substr s,     half v) { return ftoa(s, v); }
+C4_ALWAYS_INLINE size_t xtoa(substr s, bfloat16 v) { return ftoa(s, v); }
 
 C4_ALWAYS_INLINE bool atox(csubstr s,  uint8_t *C4_RESTRICT v) { return atou(s, v); }
 C4_ALWAYS_INLINE bool atox(csubstr s, uint16_t *C4_RESTRICT v) { return atou(s, v); }
@@ -1251,6 +3161,8 @@ C4_ALWAYS_INLINE bool atox(csubstr s,  int32_t *C4_RESTRICT v) { return atoi(s,
 C4_ALWAYS_INLINE bool atox(csubstr s,  int64_t *C4_RESTRICT v) { return atoi(s, v); }
 C4_ALWAYS_INLINE bool atox(csubstr s,    float *C4_RESTRICT v) { return atof(s, v); }
 C4_ALWAYS_INLINE bool atox(csubstr s,   double *C4_RESTRICT v) { return atod(s, v); }
+C4_ALWAYS_INLINE bool atox(csubstr s,     half *C4_RESTRICT v) { return atof(s, v); }
+C4_ALWAYS_INLINE bool atox(csubstr s, bfloat16 *C4_RESTRICT v) { return atof(s, v); }
 
 C4_ALWAYS_INLINE size_t to_chars(substr buf,  uint8_t v) { return utoa(buf, v); }
 C4_ALWAYS_INLINE size_t to_chars(substr buf, uint16_t v) { return utoa(buf, v); }
@@ -1262,6 +3174,8 @@ C4_ALWAYS_INLINE size_t to_chars(substr buf,  int32_t v) { return itoa(buf, v);
 C4_ALWAYS_INLINE size_t to_chars(substr buf,  int64_t v) { return itoa(buf, v); }
 C4_ALWAYS_INLINE size_t to_chars(substr buf,    float v) { return ftoa(buf, v); }
 C4_ALWAYS_INLINE size_t to_chars(substr buf,   double v) { return dtoa(buf, v); }
+C4_ALWAYS_INLINE size_t to_chars(substr buf,     half v) { return ftoa(buf, v); }
+C4_ALWAYS_INLINE size_t to_chars(substr buf, bfloat16 v) { return ftoa(buf, v); }
 
 C4_ALWAYS_INLINE bool from_chars(csubstr buf,  uint8_t *C4_RESTRICT v) { return atou(buf, v); }
 C4_ALWAYS_INLINE bool from_chars(csubstr buf, uint16_t *C4_RESTRICT v) { return atou(buf, v); }
@@ -1273,6 +3187,8 @@ C4_ALWAYS_INLINE bool from_chars(csubstr buf,  int32_t *C4_RESTRICT v) { return
 C4_ALWAYS_INLINE bool from_chars(csubstr buf,  int64_t *C4_RESTRICT v) { return atoi(buf, v); }
 C4_ALWAYS_INLINE bool from_chars(csubstr buf,    float *C4_RESTRICT v) { return atof(buf, v); }
 C4_ALWAYS_INLINE bool from_chars(csubstr buf,   double *C4_RESTRICT v) { return atod(buf, v); }
+C4_ALWAYS_INLINE bool from_chars(csubstr buf,     half *C4_RESTRICT v) { return atof(buf, v); }
+C4_ALWAYS_INLINE bool from_chars(csubstr buf, bfloat16 *C4_RESTRICT v) { return atof(buf, v); }
 
 C4_ALWAYS_INLINE size_t from_chars_first(csubstr buf,  uint8_t *C4_RESTRICT v) { return atou_first(buf, v); }
 C4_ALWAYS_INLINE size_t from_chars_first(csubstr buf, uint16_t *C4_RESTRICT v) { return atou_first(buf, v); }
@@ -1284,6 +3200,311 @@ C4_ALWAYS_INLINE size_t from_chars_first(csubstr buf,  int32_t *C4_RESTRICT v) {
 C4_ALWAYS_INLINE size_t from_chars_first(csubstr buf,  int64_t *C4_RESTRICT v) { return atoi_first(buf, v); }
 C4_ALWAYS_INLINE size_t from_chars_first(csubstr buf,    float *C4_RESTRICT v) { return atof_first(buf, v); }
 C4_ALWAYS_INLINE size_t from_chars_first(csubstr buf,   double *C4_RESTRICT v) { return atod_first(buf, v); }
+C4_ALWAYS_INLINE size_t from_chars_first(csubstr buf,     half *C4_RESTRICT v) { return atof_first(buf, v); }
+C4_ALWAYS_INLINE size_t from_chars_first(csubstr buf, bfloat16 *C4_RESTRICT v) { return atof_first(buf, v); }
+
+
+//-----------------------------------------------------------------------------
+// conversions which tell where and why they fail
+
+/** Read an integral value spanning the whole string, as
+ * from_chars() does, but detect overflow: values out of the type's
+ * range fail with errc::result_out_of_range instead of wrapping
+ * around. The value is not modified on failure.
+ * @see parse_result */
+template<class T>
+C4_ALWAYS_INLINE typename std::enable_if<detail::is_int<T>::value, parse_result>::type
+from_chars_checked(csubstr buf, T *C4_RESTRICT v) noexcept
+{
+    return detail::_atoi_checked<T, detail::is_sint<T>::value, true>(buf, v);
+}
+/** Read the first integral value in the string, as
+ * from_chars_first() does, but detect overflow. The value is not
+ * modified on failure.
+ * @see parse_result */
+template<class T>
+C4_ALWAYS_INLINE typename std::enable_if<detail::is_int<T>::value, parse_result>::type
+from_chars_first_checked(csubstr buf, T *C4_RESTRICT v) noexcept
+{
+    return detail::_atoi_first_checked<T, detail::is_sint<T>::value, true>(buf, v);
+}
+
+/** Read a real value spanning the whole string, as from_chars()
+ * does. Values too large for the type read as infinity, as in
+ * from_chars(); errc::result_out_of_range is reported only by the
+ * std::from_chars() backend. The value is not modified on failure.
+ * @see parse_result */
+C4_ALWAYS_INLINE parse_result from_chars_checked(csubstr buf,    float *C4_RESTRICT v) noexcept { return detail::_atof_checked(buf, v); }
+C4_ALWAYS_INLINE parse_result from_chars_checked(csubstr buf,   double *C4_RESTRICT v) noexcept { return detail::_atof_checked(buf, v); }
+C4_ALWAYS_INLINE parse_result from_chars_checked(csubstr buf,     half *C4_RESTRICT v) noexcept { return detail::_atof16_checked(buf, v); }
+C4_ALWAYS_INLINE parse_result from_chars_checked(csubstr buf, bfloat16 *C4_RESTRICT v) noexcept { return detail::_atof16_checked(buf, v); }
+
+/** Read the first real value in the string, as from_chars_first()
+ * does. The value is not modified on failure.
+ * @see parse_result */
+C4_ALWAYS_INLINE parse_result from_chars_first_checked(csubstr buf,    float *C4_RESTRICT v) noexcept { return detail::_atof_first_checked(buf, v); }
+C4_ALWAYS_INLINE parse_result from_chars_first_checked(csubstr buf,   double *C4_RESTRICT v) noexcept { return detail::_atof_first_checked(buf, v); }
+C4_ALWAYS_INLINE parse_result from_chars_first_checked(csubstr buf,     half *C4_RESTRICT v) noexcept { return detail::_atof16_first_checked(buf, v); }
+C4_ALWAYS_INLINE parse_result from_chars_first_checked(csubstr buf, bfloat16 *C4_RESTRICT v) noexcept { return detail::_atof16_first_checked(buf, v); }
+
+
+//-----------------------------------------------------------------------------
+// 128 bit integers
+
+#if C4CORE_HAVE_INT128
+C4_ALWAYS_INLINE size_t xtoa(substr s, detail::u128 v) { return utoa(s, v); }
+C4_ALWAYS_INLINE size_t xtoa(substr s, detail::i128 v) { return itoa(s, v); }
+
+C4_ALWAYS_INLINE bool atox(csubstr s, detail::u128 *C4_RESTRICT v) { return atou(s, v); }
+C4_ALWAYS_INLINE bool atox(csubstr s, detail::i128 *C4_RESTRICT v) { return atoi(s, v); }
+
+C4_ALWAYS_INLINE size_t to_chars(substr buf, detail::u128 v) { return utoa(buf, v); }
+C4_ALWAYS_INLINE size_t to_chars(substr buf, detail::i128 v) { return itoa(buf, v); }
+
+C4_ALWAYS_INLINE bool from_chars(csubstr buf, detail::u128 *C4_RESTRICT v) { return atou(buf, v); }
+C4_ALWAYS_INLINE bool from_chars(csubstr buf, detail::i128 *C4_RESTRICT v) { return atoi(buf, v); }
+
+C4_ALWAYS_INLINE size_t from_chars_first(csubstr buf, detail::u128 *C4_RESTRICT v) { return atou_first(buf, v); }
+C4_ALWAYS_INLINE size_t from_chars_first(csubstr buf, detail::i128 *C4_RESTRICT v) { return atoi_first(buf, v); }
+#endif
+
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+// fixed point decimals
+
+/** a signed decimal number with a fixed number of decimals, stored
+ * exactly as an integer number of units of 10^-Scale: eg 12345.6789
+ * is held by a decimal<4> as 123456789. This is meant for values
+ * such as prices or meter readings, which are written in decimal
+ * and must not be rounded through a binary real. The range is that
+ * of int64_t, divided by 10^Scale.
+ *
+ * The string conversions are done with the integer kernels, so they
+ * cost about as much as those of an int64_t. The format is
+ * [-]digits[.digits], with no exponent. It is written with exactly
+ * Scale decimals; it is read with up to Scale decimals, and further
+ * decimals are accepted only if they are zeroes.
+ * @see fmt::real(decimal<Scale>, int) to write with another number
+ * of decimals, and fmt::zpad(decimal<Scale>, size_t) to pad the
+ * integral part with zeroes */
+template<unsigned Scale>
+struct decimal
+{
+    C4_STATIC_ASSERT(Scale <= 18u);
+    enum : unsigned { scale = Scale };
+
+    int64_t raw; ///< the value in units of 10^-Scale
+
+    decimal() = default;
+
+    static decimal from_raw(int64_t r) noexcept { decimal d; d.raw = r; return d; }
+
+    /** convert to the nearest double: this is correctly rounded when
+     * |raw| is at most 2^53 */
+    explicit operator double() const noexcept { return static_cast<double>(raw) / static_cast<double>(detail::powers_of_10_u64[Scale]); }
+
+    friend bool operator== (decimal a, decimal b) noexcept { return a.raw == b.raw; }
+    friend bool operator!= (decimal a, decimal b) noexcept { return a.raw != b.raw; }
+    friend bool operator<  (decimal a, decimal b) noexcept { return a.raw <  b.raw; }
+    friend bool operator>  (decimal a, decimal b) noexcept { return a.raw >  b.raw; }
+    friend bool operator<= (decimal a, decimal b) noexcept { return a.raw <= b.raw; }
+    friend bool operator>= (decimal a, decimal b) noexcept { return a.raw >= b.raw; }
+};
+
+
+namespace detail {
+
+/** read a decimal<Scale> at the start of [s,end), in units of
+ * 10^-Scale. The integral and fractional digits are each converted
+ * eight at a time with _read_dec_prefix(), and are then combined
+ * with one multiplication each. Only numbers with 19 significant
+ * digits need an overflow check. On return, @p s points at the
+ * character where the reading stopped: the end of the number, or
+ * the offending character. A number without digits or with nonzero
+ * decimals beyond Scale fails with errc::invalid_argument, and a
+ * number out of range fails with errc::result_out_of_range. The
+ * value is written only on success. */
+template<unsigned Scale>
+C4_ALWAYS_INLINE errc _read_decimal(const char *& s, const char *C4_RESTRICT end, int64_t *C4_RESTRICT raw) noexcept
+{
+    const bool neg = (s < end && *s == '-');
+    s += neg;
+    const char *C4_RESTRICT int_beg = s;
+    while(s < end && *s == '0') // leading zeroes do not count for the range
+        ++s;
+    const char *C4_RESTRICT sig = s;
+    uint64_t ipart;
+    s = _read_dec_prefix(s, end, &ipart);
+    const size_t num_int = static_cast<size_t>(s - sig);
+    bool has_digits = s > int_beg;
+    uint64_t fpart = 0;
+    if(s < end && *s == '.')
+    {
+        const char *C4_RESTRICT frac_beg = ++s;
+        s = _read_dec_prefix(s, end, &fpart);
+        size_t num_frac = static_cast<size_t>(s - frac_beg);
+        has_digits |= (num_frac > 0u);
+        if(C4_UNLIKELY(num_frac > Scale))
+        {
+            for(const char *C4_RESTRICT c = frac_beg + Scale; c < s; ++c)
+            {
+                if(*c != '0')
+                {
+                    s = c;
+                    return errc::invalid_argument;
+                }
+            }
+            _read_dec_prefix(frac_beg, frac_beg + Scale, &fpart);
+            num_frac = Scale;
+        }
+        fpart *= powers_of_10_u64[Scale - num_frac];
+    }
+    if(C4_UNLIKELY( ! has_digits))
+        return errc::invalid_argument;
+    uint64_t mag;
+    if(C4_LIKELY(num_int + Scale <= 18u)) // less than 10^18, so it fits
+    {
+        mag = ipart * powers_of_10_u64[Scale] + fpart;
+    }
+    else if(num_int + Scale == 19u) // less than 10^19, so it fits in uint64_t
+    {
+        mag = ipart * powers_of_10_u64[Scale] + fpart;
+        if(C4_UNLIKELY(mag > static_cast<uint64_t>(INT64_MAX) + neg)) // -INT64_MIN is fine
+            return errc::result_out_of_range;
+    }
+    else
+    {
+        return errc::result_out_of_range;
+    }
+    *raw = static_cast<int64_t>(neg ? UINT64_C(0) - mag : mag);
+    return errc::ok;
+}
+
+/** write a decimal from its @p raw value in units of 10^-scale, with
+ * @p scale decimals followed by @p num_zeros zeroes, and with at
+ * least @p num_int_digits digits in the integral part, padding it
+ * with zeroes on the left.
+ * @return the number of characters required. Nothing is written if
+ * the buffer is smaller. */
+C4_ALWAYS_INLINE size_t _write_decimal_raw(substr buf, int64_t raw, unsigned scale, unsigned num_zeros=0, size_t num_int_digits=0) noexcept
+{
+    C4_ASSERT(scale <= 18u);
+    const bool neg = raw < 0;
+    const uint64_t mag = neg ? UINT64_C(0) - static_cast<uint64_t>(raw) : static_cast<uint64_t>(raw);
+    const uint64_t ipart = mag / powers_of_10_u64[scale];
+    const uint64_t fpart = mag - ipart * powers_of_10_u64[scale];
+    const unsigned int_digits = _digits_dec(ipart);
+    const size_t int_len = int_digits > num_int_digits ? int_digits : num_int_digits;
+    const size_t frac_len = scale + num_zeros;
+    const size_t len = neg + int_len + (frac_len ? 1u + frac_len : 0u);
+    if(C4_UNLIKELY(len > buf.len))
+        return len;
+    char *C4_RESTRICT str = buf.str;
+    if(neg)
+        *str++ = '-';
+    if(int_len > int_digits)
+        memset(str, '0', int_len - int_digits);
+    _write_dec_unchecked(buf.sub(neg + int_len - int_digits), ipart, int_digits);
+    if(frac_len)
+    {
+        str += int_len;
+        *str++ = '.';
+        if(scale)
+        {
+            const unsigned frac_digits = _digits_dec(fpart);
+            memset(str, '0', scale - frac_digits);
+            _write_dec_unchecked(buf.sub(neg + int_len + 1u + scale - frac_digits), fpart, frac_digits);
+        }
+        memset(str + scale, '0', num_zeros);
+    }
+    return len;
+}
+
+/** round a raw decimal value to drop its last @p num_digits digits,
+ * to nearest, ties to even. The result is in units of
+ * 10^num_digits of the original units. */
+C4_ALWAYS_INLINE int64_t _round_decimal_raw(int64_t raw, unsigned num_digits) noexcept
+{
+    C4_ASSERT(num_digits <= 18u);
+    if(num_digits == 0u)
+        return raw;
+    const bool neg = raw < 0;
+    const uint64_t mag = neg ? UINT64_C(0) - static_cast<uint64_t>(raw) : static_cast<uint64_t>(raw);
+    const uint64_t div = powers_of_10_u64[num_digits];
+    uint64_t q = mag / div;
+    const uint64_t rem = mag - q * div;
+    const uint64_t halfway = div / 2u;
+    q += (rem > halfway || (rem == halfway && (q & 1u)));
+    return static_cast<int64_t>(neg ? UINT64_C(0) - q : q);
+}
+
+} // namespace detail
+
+
+template<unsigned Scale>
+C4_ALWAYS_INLINE size_t xtoa(substr s, decimal<Scale> v) { return detail::_write_decimal_raw(s, v.raw, Scale); }
+template<unsigned Scale>
+C4_ALWAYS_INLINE bool atox(csubstr s, decimal<Scale> *C4_RESTRICT v)
+{
+    int64_t raw;
+    const char *end = s.str;
+    if(C4_UNLIKELY(detail::_read_decimal<Scale>(end, s.str + s.len, &raw) != errc::ok || end != s.str + s.len))
+        return false;
+    v->raw = raw;
+    return true;
+}
+
+template<unsigned Scale>
+C4_ALWAYS_INLINE size_t to_chars(substr buf, decimal<Scale> v) { return detail::_write_decimal_raw(buf, v.raw, Scale); }
+template<unsigned Scale>
+C4_ALWAYS_INLINE bool from_chars(csubstr buf, decimal<Scale> *C4_RESTRICT v) { return atox(buf, v); }
+
+/** read a decimal spanning the whole string. A number with nonzero
+ * decimals beyond Scale is reported as errc::invalid_argument at the
+ * first such decimal, and a number out of range as
+ * errc::result_out_of_range at its end. The value is not modified on
+ * failure.
+ * @see parse_result */
+template<unsigned Scale>
+inline parse_result from_chars_checked(csubstr buf, decimal<Scale> *C4_RESTRICT v) noexcept
+{
+    const char *C4_RESTRICT end = buf.str + buf.len;
+    const char *s = buf.str;
+    int64_t raw;
+    errc err = detail::_read_decimal<Scale>(s, end, &raw);
+    if(C4_UNLIKELY(s != end))
+        err = errc::invalid_argument;
+    else if(C4_LIKELY(err == errc::ok))
+        v->raw = raw;
+    return parse_result{static_cast<size_t>(s - buf.str), err};
+}
+
+/** read the first decimal in the string, skipping leading
+ * whitespace. Failures are reported as in
+ * from_chars_checked(csubstr, decimal<Scale>*).
+ * @see parse_result */
+template<unsigned Scale>
+inline parse_result from_chars_first_checked(csubstr buf, decimal<Scale> *C4_RESTRICT v) noexcept
+{
+    const char *C4_RESTRICT end = buf.str + buf.len;
+    const char *s = detail::_skip_first_space(buf.str, end);
+    int64_t raw;
+    errc err = detail::_read_decimal<Scale>(s, end, &raw);
+    if(C4_UNLIKELY(s < end && !csubstr::_is_delim_char(*s)))
+        err = errc::invalid_argument;
+    else if(C4_LIKELY(err == errc::ok))
+        v->raw = raw;
+    return parse_result{static_cast<size_t>(s - buf.str), err};
+}
+
+/** read the first decimal in the string, skipping leading
+ * whitespace. As with the other types, the number must be followed
+ * by the end of the string or by a delimiter.
+ * @return the number of characters read, or csubstr::npos */
+template<unsigned Scale>
+C4_ALWAYS_INLINE size_t from_chars_first(csubstr buf, decimal<Scale> *C4_RESTRICT v) { return from_chars_first_checked(buf, v).first(); }
 
 
 //-----------------------------------------------------------------------------
@@ -1319,7 +3540,9 @@ template <class T> C4_ALWAYS_INLINE size_t xtoa(substr s, T *v) { return itoa(s,
 template <class T> C4_ALWAYS_INLINE bool   atox(csubstr s, T **v) { intptr_t tmp; bool ret = atox(s, &tmp); if(ret) { *v = (T*)tmp; } return ret; }
 template <class T> C4_ALWAYS_INLINE size_t to_chars(substr s, T *v) { return itoa(s, (intptr_t)v, (intptr_t)16); }
 template <class T> C4_ALWAYS_INLINE bool   from_chars(csubstr buf, T **v) { intptr_t tmp; bool ret = from_chars(buf, &tmp); if(ret) { *v = (T*)tmp; } return ret; }
-template <class T> C4_ALWAYS_INLINE size_t from_chars_first(csubstr buf, T **v) { intptr_t tmp; bool ret = from_chars_first(buf, &tmp); if(ret) { *v = (T*)tmp; } return ret; }
+template <class T> C4_ALWAYS_INLINE parse_result from_chars_checked(csubstr buf, T **v) { intptr_t tmp = 0; parse_result ret = from_chars_checked(buf, &tmp); if(ret.ok()) { *v = (T*)tmp; } return ret; }
+template <class T> C4_ALWAYS_INLINE parse_result from_chars_first_checked(csubstr buf, T **v) { intptr_t tmp = 0; parse_result ret = from_chars_first_checked(buf, &tmp); if(ret.ok()) { *v = (T*)tmp; } return ret; }
+template <class T> C4_ALWAYS_INLINE size_t from_chars_first(csubstr buf, T **v) { return from_chars_first_checked(buf, v).first(); }
 
 
 //-----------------------------------------------------------------------------
@@ -1348,7 +3571,9 @@ inline size_t to_chars(substr buf, bool v)
     return to_chars(buf, val);
 }
 
-inline bool from_chars(csubstr buf, bool * C4_RESTRICT v)
+namespace detail {
+/** read the words accepted for a bool, or the single digits 0 and 1 */
+inline bool _read_bool_word(csubstr buf, bool * C4_RESTRICT v) noexcept
 {
     if(buf == '0')
     {
@@ -1382,6 +3607,14 @@ inline bool from_chars(csubstr buf, bool * C4_RESTRICT v)
     {
         *v = true; return true;
     }
+    return false;
+}
+} // namespace detail
+
+inline bool from_chars(csubstr buf, bool * C4_RESTRICT v)
+{
+    if(detail::_read_bool_word(buf, v))
+        return true;
     // fallback to c-style int bools
     int val = 0;
     bool ret = from_chars(buf, &val);
@@ -1392,12 +3625,39 @@ inline bool from_chars(csubstr buf, bool * C4_RESTRICT v)
     return ret;
 }
 
+/** read a bool spanning the whole string, as from_chars() does. The
+ * c-style int bools are read with overflow detection.
+ * @see parse_result */
+inline parse_result from_chars_checked(csubstr buf, bool * C4_RESTRICT v) noexcept
+{
+    if(detail::_read_bool_word(buf, v))
+        return parse_result{buf.len, errc::ok};
+    int val = 0;
+    const parse_result ret = from_chars_checked(buf, &val);
+    if(C4_LIKELY(ret.err == errc::ok))
+        *v = (val != 0);
+    return ret;
+}
+
+/** read the first bool in the string, skipping leading
+ * whitespace. The value ends at the first delimiter (see
+ * csubstr::_is_delim_char()).
+ * @see parse_result */
+inline parse_result from_chars_first_checked(csubstr buf, bool * C4_RESTRICT v) noexcept
+{
+    const char *C4_RESTRICT end = buf.str + buf.len;
+    const char *C4_RESTRICT start = detail::_skip_first_space(buf.str, end);
+    const char *C4_RESTRICT s = start;
+    while(s < end && !csubstr::_is_delim_char(*s))
+        ++s;
+    parse_result ret = from_chars_checked(csubstr(start, static_cast<size_t>(s - start)), v);
+    ret.consumed += static_cast<size_t>(start - buf.str);
+    return ret;
+}
+
 inline size_t from_chars_first(csubstr buf, bool * C4_RESTRICT v)
 {
-    csubstr trimmed = buf.first_non_empty_span();
-    if(trimmed.len == 0 || !from_chars(buf, v))
-        return csubstr::npos;
-    return trimmed.len;
+    return from_chars_first_checked(buf, v).first();
 }
 
 
@@ -1429,6 +3689,28 @@ inline size_t from_chars_first(csubstr buf, char * C4_RESTRICT v)
     return 1;
 }
 
+/** extract a single character from a substring, which must have
+ * exactly one character
+ * @see parse_result */
+inline parse_result from_chars_checked(csubstr buf, char * C4_RESTRICT v) noexcept
+{
+    if(C4_UNLIKELY(buf.len != 1))
+        return parse_result{buf.len ? size_t(1) : size_t(0), errc::invalid_argument};
+    *v = buf.str[0];
+    return parse_result{1, errc::ok};
+}
+
+/** extract the first character of a substring. As with
+ * from_chars_first(), whitespace is not skipped.
+ * @see parse_result */
+inline parse_result from_chars_first_checked(csubstr buf, char * C4_RESTRICT v) noexcept
+{
+    if(C4_UNLIKELY(buf.len < 1))
+        return parse_result{0, errc::invalid_argument};
+    *v = buf.str[0];
+    return parse_result{1, errc::ok};
+}
+
 
 //-----------------------------------------------------------------------------
 // csubstr implementation
@@ -1456,6 +3738,24 @@ inline size_t from_chars_first(substr buf, csubstr * C4_RESTRICT v)
     return static_cast<size_t>(trimmed.end() - buf.begin());
 }
 
+inline parse_result from_chars_checked(csubstr buf, csubstr *C4_RESTRICT v) noexcept
+{
+    *v = buf;
+    return parse_result{buf.len, errc::ok};
+}
+
+/** select the first non-empty span of the string, skipping leading
+ * whitespace. The span ends at the first whitespace character.
+ * @see parse_result */
+inline parse_result from_chars_first_checked(csubstr buf, csubstr * C4_RESTRICT v) noexcept
+{
+    csubstr trimmed = buf.first_non_empty_span();
+    if(C4_UNLIKELY(trimmed.len == 0))
+        return parse_result{buf.len, errc::invalid_argument};
+    *v = trimmed;
+    return parse_result{static_cast<size_t>(trimmed.end() - buf.begin()), errc::ok};
+}
+
 
 //-----------------------------------------------------------------------------
 // substr
@@ -1494,6 +3794,45 @@ inline size_t from_chars_first(csubstr buf, substr * C4_RESTRICT v)
     return static_cast<size_t>(trimmed.end() - buf.begin());
 }
 
+/** copy the string to the substr. If it does not fit, the substr is
+ * filled and errc::result_out_of_range is returned with the number
+ * of characters copied.
+ * @see parse_result */
+inline parse_result from_chars_checked(csubstr buf, substr * C4_RESTRICT v) noexcept
+{
+    C4_ASSERT(!buf.overlaps(*v));
+    if(C4_LIKELY(buf.len <= v->len))
+    {
+        memcpy(v->str, buf.str, buf.len);
+        v->len = buf.len;
+        return parse_result{buf.len, errc::ok};
+    }
+    memcpy(v->str, buf.str, v->len);
+    return parse_result{v->len, errc::result_out_of_range};
+}
+
+/** copy the first non-empty span of the string to the substr,
+ * skipping leading whitespace. If it does not fit, the substr is
+ * filled and errc::result_out_of_range is returned with the position
+ * after the last character copied.
+ * @see parse_result */
+inline parse_result from_chars_first_checked(csubstr buf, substr * C4_RESTRICT v) noexcept
+{
+    csubstr trimmed = buf.first_non_empty_span();
+    C4_ASSERT(!trimmed.overlaps(*v));
+    if(C4_UNLIKELY(trimmed.len == 0))
+        return parse_result{buf.len, errc::invalid_argument};
+    const size_t pos = static_cast<size_t>(trimmed.str - buf.str);
+    if(C4_UNLIKELY(trimmed.len > v->len))
+    {
+        memcpy(v->str, trimmed.str, v->len);
+        return parse_result{pos + v->len, errc::result_out_of_range};
+    }
+    memcpy(v->str, trimmed.str, trimmed.len);
+    v->len = trimmed.len;
+    return parse_result{pos + trimmed.len, errc::ok};
+}
+
 
 //-----------------------------------------------------------------------------
 
@@ -1509,6 +3848,160 @@ inline size_t to_chars(substr buf, const char * C4_RESTRICT v)
     return to_chars(buf, to_csubstr(v));
 }
 
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+// maximum number of characters written by to_chars()
+
+/** An upper bound for the number of characters written by
+ * to_chars() for a type. When the bound does not depend on the value
+ * (eg for the numeric types), the specialization has a compile-time
+ * @c value, which can be used to size stack buffers:
+ *
+ * @code{.cpp}
+ * char buf[c4::max_chars<double>::value];
+ * size_t len = c4::to_chars(buf, 3.14); // always fits
+ * @endcode
+ *
+ * Every specialization provides @c bound(v), which gives the bound
+ * for a particular value: eg the length of a string, or the width of
+ * a fmt::left() field. This is used by catrs(), catseprs() and
+ * formatrs() to size the container once and serialize the arguments
+ * in a single pass.
+ *
+ * The primary template is empty: types without a specialization have
+ * no known bound. To provide a bound for your own type, specialize
+ * this template in the c4 namespace.
+ *
+ * @see c4::to_chars_bound() */
+template<class T, class Enable>
+struct max_chars
+{
+};
+
+namespace detail {
+/** a max_chars specialization for the types whose bound does not
+ * depend on the value */
+template<size_t N>
+struct _max_chars_fixed
+{
+    enum : size_t { value = N };
+    template<class T>
+    static constexpr size_t bound(T const&) noexcept { return N; }
+};
+} // namespace detail
+
+/** integers are written in decimal, with a minus sign if negative */
+template<class T>
+struct max_chars<T, typename std::enable_if<detail::is_int<T>::value
+                                            && !std::is_same<T, bool>::value
+                                            && !std::is_same<T, char>::value>::type>
+    : public detail::_max_chars_fixed<detail::is_sint<T>::value ?
+                                      // 643/2136 is a lower bound of log10(2)
+                                      1u + ((sizeof(T) * CHAR_BIT - 1u) * 643u) / 2136u + 1u :
+                                      ((sizeof(T) * CHAR_BIT) * 643u) / 2136u + 1u>
+{
+};
+
+/** a bool is written as 0 or 1 */
+template<> struct max_chars<bool> : public detail::_max_chars_fixed<1> {};
+/** a char is written as itself */
+template<> struct max_chars<char> : public detail::_max_chars_fixed<1> {};
+
+/** pointers are written as hexadecimal integers, eg -0x1234 */
+template<class T> struct max_chars<T*> : public detail::_max_chars_fixed<3u + 2u * sizeof(intptr_t)> {};
+
+namespace detail {
+/** the extreme digit counts of the real types: the digits of the
+ * integral part of the largest value, the decimals needed to write
+ * the smallest subnormal, and the significant digits needed for the
+ * shortest round trip */
+template<class T> struct _real_chars;
+template<> struct _real_chars<float>
+{
+    enum : size_t { int_digits = 39, min_exp10 = 45, max_digits10 = 9,
+        // -1.2345678e-38
+        shortest = 1 + max_digits10 + 1 + 4 };
+};
+template<> struct _real_chars<double>
+{
+    enum : size_t { int_digits = 309, min_exp10 = 324, max_digits10 = 17,
+        // -1.2345678901234567e-308
+        shortest = 1 + max_digits10 + 1 + 5 };
+};
+template<> struct _real_chars<half> : public _real_chars<float> {};
+template<> struct _real_chars<bfloat16> : public _real_chars<float> {};
+
+/** the bound for ftoa()/dtoa() with the given precision and format */
+template<class T>
+C4_CONSTEXPR14 size_t _real_chars_bound(int precision, RealFormat_e formatting) noexcept
+{
+    using rc = _real_chars<T>;
+    if(formatting == FTOA_FLOAT)
+    {
+        // -ddd.ddd
+        return precision < 0 ?
+            size_t(1) + rc::int_digits + 1u + rc::min_exp10 + rc::max_digits10 :
+            size_t(1) + rc::int_digits + 1u + static_cast<size_t>(precision);
+    }
+    else if(formatting == FTOA_HEXA)
+    {
+        // -0x1.hhhhp-1022 or -nan(0xhhhh)
+        return size_t(11) + (precision > 13 ? static_cast<size_t>(precision) : size_t(13));
+    }
+    // -d.ddde-308, or with FTOA_FLEX -0.0000ddd
+    return precision < 0 ? size_t(rc::shortest) : size_t(8) + static_cast<size_t>(precision);
+}
+} // namespace detail
+
+/** reals are written in the shortest form which reads back to the
+ * same value */
+template<> struct max_chars<float> : public detail::_max_chars_fixed<detail::_real_chars<float>::shortest> {};
+template<> struct max_chars<double> : public detail::_max_chars_fixed<detail::_real_chars<double>::shortest> {};
+template<> struct max_chars<half> : public detail::_max_chars_fixed<detail::_real_chars<half>::shortest> {};
+template<> struct max_chars<bfloat16> : public detail::_max_chars_fixed<detail::_real_chars<bfloat16>::shortest> {};
+
+/** a decimal has at most 19 integral digits, and always @p Scale
+ * decimals */
+template<unsigned Scale> struct max_chars<decimal<Scale>> : public detail::_max_chars_fixed<1u + 19u + 1u + Scale> {};
+
+/** strings are copied: the bound is their length */
+template<> struct max_chars<csubstr>
+{
+    static constexpr size_t bound(csubstr s) noexcept { return s.len; }
+};
+/** @copydoc max_chars<csubstr> */
+template<> struct max_chars<substr>
+{
+    static constexpr size_t bound(csubstr s) noexcept { return s.len; }
+};
+/** @copydoc max_chars<csubstr> */
+template<> struct max_chars<const char*>
+{
+    static size_t bound(const char *s) noexcept { return s ? strlen(s) : 0u; }
+};
+/** string literals have a known length */
+template<size_t N> struct max_chars<char[N]> : public detail::_max_chars_fixed<N - 1u> {};
+
+
+namespace detail {
+/** true if max_chars<T> has bound() */
+template<class T, class=void>
+struct has_max_chars : public std::false_type {};
+template<class T>
+struct has_max_chars<T, decltype((void)max_chars<T>::bound(std::declval<T const&>()))> : public std::true_type {};
+} // namespace detail
+
+/** an upper bound for the number of characters written by
+ * to_chars(buf, v)
+ * @see c4::max_chars */
+template<class T>
+C4_ALWAYS_INLINE size_t to_chars_bound(T const& v)
+{
+    return max_chars<typename std::remove_cv<T>::type>::bound(v);
+}
+
 } // namespace c4
 
 #ifdef _MSC_VER
@@ -2,6 +2,8 @@
 #define C4_DUMP_HPP_
 
 #include <c4/substr.hpp>
+#include <c4/format_string.hpp>
+#include <c4/format_args.hpp>
 
 namespace c4 {
 
@@ -84,6 +86,23 @@ struct DumpResults
 };
 
 
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+/** @name type-erased dump
+ * like c4::cat_dump(), c4::catsep_dump() and c4::format_dump(), but
+ * with type-erased arguments; these are compiled once into the
+ * library. When C4CORE_FORMAT_ERASED_ARGS is defined, the variadic
+ * versions taking the dump function as template argument call these.
+ * @see c4::make_format_args()
+ * @{ */
+C4CORE_EXPORT size_t vcat_dump(DumperPfn dumpfn, substr buf, format_args args);
+C4CORE_EXPORT size_t vcatsep_dump(DumperPfn dumpfn, substr buf, format_arg sep, format_args args);
+C4CORE_EXPORT size_t vformat_dump(DumperPfn dumpfn, substr buf, csubstr fmt, format_args args);
+/** @} */
+
+
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
@@ -119,11 +138,15 @@ size_t cat_dump(DumperFn &&dumpfn, substr buf, Arg const& C4_RESTRICT a, Args co
 template<DumperPfn dumpfn,class Arg, class... Args>
 size_t cat_dump(substr buf, Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
 {
+#ifdef C4CORE_FORMAT_ERASED_ARGS
+    return vcat_dump(dumpfn, buf, make_format_args(a, more...));
+#else
     size_t size_for_a = dump<dumpfn>(buf, a);
     if(C4_LIKELY(size_for_a > buf.len))
         buf = buf.first(0); // ensure no more calls
     size_t size_for_more = cat_dump<dumpfn>(buf, more...);
     return size_for_more > size_for_a ? size_for_more : size_for_a;
+#endif
 }
 
 
@@ -250,6 +273,9 @@ size_t catsep_dump(DumperFn &&dumpfn, substr buf, Sep const& C4_RESTRICT sep, Ar
 template<DumperPfn dumpfn, class Sep, class Arg, class... Args>
 size_t catsep_dump(substr buf, Sep const& C4_RESTRICT sep, Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
 {
+#ifdef C4CORE_FORMAT_ERASED_ARGS
+    return vcatsep_dump(dumpfn, buf, make_format_arg(sep), make_format_args(a, more...));
+#else
     size_t sz = dump<dumpfn>(buf, a);
     if(C4_UNLIKELY(sz > buf.len))
         buf = buf.first(0); // ensure no more calls
@@ -262,6 +288,7 @@ size_t catsep_dump(substr buf, Sep const& C4_RESTRICT sep, Arg const& C4_RESTRIC
     }
     size_t size_for_more = catsep_dump<dumpfn>(buf, sep, more...);
     return size_for_more > sz ? size_for_more : sz;
+#endif
 }
 
 
@@ -414,6 +441,9 @@ size_t format_dump(DumperFn &&dumpfn, substr buf, csubstr fmt, Arg const& C4_RES
 template<DumperPfn dumpfn, class Arg, class... Args>
 size_t format_dump(substr buf, csubstr fmt, Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
 {
+#ifdef C4CORE_FORMAT_ERASED_ARGS
+    return vformat_dump(dumpfn, buf, fmt, make_format_args(a, more...));
+#else
     // we can dump without using buf
     // but we'll only dump if the buffer is ok
     size_t pos = fmt.find("{}"); // @todo use _find_fmt()
@@ -431,6 +461,133 @@ size_t format_dump(substr buf, csubstr fmt, Arg const& C4_RESTRICT a, Args const
         buf.len = 0; // ensure no more calls to dump
     size_t size_for_more = format_dump<dumpfn>(buf, fmt, more...);
     return size_for_more > pos ? size_for_more : pos;
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+
+/// @cond dev
+namespace detail {
+
+template<class Fmt, size_t Pos, class DumperFn>
+C4_ALWAYS_INLINE size_t _format_dump_ct(DumperFn &&dumpfn, substr buf)
+{
+    using seg = _ct_fmt_seg<Fmt, Pos>;
+    if(seg::len > 0 && C4_LIKELY(buf.len > 0))
+        dumpfn(seg::get());
+    return 0u;
+}
+
+template<class Fmt, size_t Pos, class DumperFn, class Arg, class... Args>
+C4_ALWAYS_INLINE size_t _format_dump_ct(DumperFn &&dumpfn, substr buf, Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
+{
+    using seg = _ct_fmt_seg<Fmt, Pos>;
+    if(seg::len > 0 && C4_LIKELY(buf.len > 0))
+        dumpfn(seg::get()); // we can dump without using buf
+    size_t size_for_a = dump(dumpfn, buf, a);
+    if(C4_UNLIKELY(size_for_a > buf.len))
+        buf.len = 0; // ensure no more calls to dump
+    size_t size_for_more = _format_dump_ct<Fmt, seg::next>(dumpfn, buf, more...);
+    return size_for_more > size_for_a ? size_for_more : size_for_a;
+}
+
+} // namespace detail
+/// @endcond
+
+/** like c4::format_dump(), but using a compile-time format string
+ * created with C4_FMT(). The number of arguments must be equal to the
+ * number of placeholders. Take the function pointer as a function
+ * argument.
+ * @see C4_FMT() */
+template<class DumperFn, class Fmt, class... Args>
+C4_ALWAYS_INLINE typename std::enable_if<is_ct_fmt<Fmt>::value, size_t>::type
+format_dump(DumperFn &&dumpfn, substr buf, Fmt const&, Args const& C4_RESTRICT ...args)
+{
+    static_assert(ct_fmt_num_args<Fmt>::value == sizeof...(Args), "the number of arguments must match the number of {} in the format string");
+    return detail::_format_dump_ct<Fmt, 0>(dumpfn, buf, args...);
+}
+
+/** like c4::format_dump(), but using a compile-time format string
+ * created with C4_FMT(). The number of arguments must be equal to the
+ * number of placeholders. Take the function pointer as a template
+ * argument.
+ * @see C4_FMT() */
+template<DumperPfn dumpfn, class Fmt, class... Args>
+C4_ALWAYS_INLINE typename std::enable_if<is_ct_fmt<Fmt>::value, size_t>::type
+format_dump(substr buf, Fmt const&, Args const& C4_RESTRICT ...args)
+{
+    static_assert(ct_fmt_num_args<Fmt>::value == sizeof...(Args), "the number of arguments must match the number of {} in the format string");
+    return detail::_format_dump_ct<Fmt, 0>(dumpfn, buf, args...);
+}
+
+
+//-----------------------------------------------------------------------------
+
+/// @cond dev
+namespace detail {
+
+template<class DumperFn>
+inline size_t _dump_nth(DumperFn &&, substr, size_t)
+{
+    C4_NEVER_REACH();
+    return 0;
+}
+
+/** dump the n-th argument */
+template<class DumperFn, class Arg, class... Args>
+size_t _dump_nth(DumperFn &&dumpfn, substr buf, size_t n, Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
+{
+    if(n == 0)
+        return dump(dumpfn, buf, a);
+    return _dump_nth(dumpfn, buf, n - 1u, more...);
+}
+
+template<class DumperFn, size_t MaxSlots, class... Args>
+size_t _format_dump_compiled(DumperFn &&dumpfn, substr buf, basic_compiled_format<MaxSlots> const& cf, Args const& C4_RESTRICT ...args)
+{
+    size_t bufsize = 0;
+    const size_t last = cf.num_slots() - 1u;
+    for(size_t i = 0; i < last; ++i)
+    {
+        const csubstr lit = cf.literal(i);
+        if(lit.len > 0 && C4_LIKELY(buf.len > 0))
+            dumpfn(lit); // we can dump without using buf
+        const size_t arg = cf.slot(i).arg;
+        size_t size_for_arg = 0;
+        if(C4_LIKELY(arg < sizeof...(Args)))
+            size_for_arg = _dump_nth(dumpfn, buf, arg, args...);
+        else if(C4_LIKELY(buf.len > 0))
+            dumpfn(cf.placeholder(i));
+        if(C4_UNLIKELY(size_for_arg > buf.len))
+            buf.len = 0; // ensure no more calls to dump
+        bufsize = size_for_arg > bufsize ? size_for_arg : bufsize;
+    }
+    const csubstr lit = cf.literal(last);
+    if(lit.len > 0 && C4_LIKELY(buf.len > 0))
+        dumpfn(lit);
+    return bufsize;
+}
+
+} // namespace detail
+/// @endcond
+
+/** like c4::format_dump(), but using a compiled format. Take the
+ * function pointer as a function argument.
+ * @see c4::basic_compiled_format */
+template<class DumperFn, size_t MaxSlots, class... Args>
+C4_ALWAYS_INLINE size_t format_dump(DumperFn &&dumpfn, substr buf, basic_compiled_format<MaxSlots> const& cf, Args const& C4_RESTRICT ...args)
+{
+    return detail::_format_dump_compiled(dumpfn, buf, cf, args...);
+}
+
+/** like c4::format_dump(), but using a compiled format. Take the
+ * function pointer as a template argument.
+ * @see c4::basic_compiled_format */
+template<DumperPfn dumpfn, size_t MaxSlots, class... Args>
+C4_ALWAYS_INLINE size_t format_dump(substr buf, basic_compiled_format<MaxSlots> const& cf, Args const& C4_RESTRICT ...args)
+{
+    return detail::_format_dump_compiled(dumpfn, buf, cf, args...);
 }
 
 
@@ -573,6 +730,229 @@ C4_ALWAYS_INLINE DumpResults format_dump_resume(DumperFn &&dumpfn, substr buf, c
 }
 
 
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+/** a dumper which accumulates the characters in a fixed-size buffer,
+ * and hands them to the sink only when the buffer is full, or on
+ * flush(). This turns the many small dump calls made by each
+ * cat_dump() or format_dump() into few calls to the sink, which is
+ * worthwhile when each call to the sink is expensive, eg a call to
+ * fwrite() or to write().
+ *
+ * The records written with the member functions cat(), catsep() and
+ * format() are kept whole: when the buffer is full, only the records
+ * before the current one are handed to the sink, so each record
+ * reaches the sink in a single call. This makes it possible for
+ * several threads, each with its own dump_buffer, to share a sink
+ * such as a file descriptor opened with O_APPEND, without the records
+ * being interleaved. This holds only for records which fit in the
+ * buffer: a record larger than the buffer is handed to the sink in
+ * several calls.
+ *
+ * Strings larger than the buffer are not copied: the buffered
+ * characters are flushed, and the string is handed directly to the
+ * sink.
+ *
+ * @code{.cpp}
+ * char mem[4096];
+ * auto sink = [fd](c4::csubstr s){ ::write(fd, s.str, s.len); };
+ * c4::dump_buffer<decltype(sink)> out(c4::substr(mem, sizeof(mem)), sink);
+ * for(auto const& e : entries)
+ *     out.format("{}: {} {}\n", e.time, e.name, e.value);
+ * out.flush(); // also done by the destructor
+ * @endcode
+ *
+ * A dump_buffer can also be given as the dumper function to
+ * c4::cat_dump(), c4::catsep_dump() and c4::format_dump(); in that
+ * case, each dumped piece is a separate record.
+ *
+ * @tparam Sink a callable receiving a csubstr */
+template<class Sink>
+class dump_buffer
+{
+    substr m_buf;
+    size_t m_pos;    ///< the end of the buffered characters
+    size_t m_record; ///< the start of the current record
+    Sink m_sink;
+
+public:
+
+    dump_buffer(substr buf, Sink sink) : m_buf(buf), m_pos(0), m_record(0), m_sink(std::move(sink)) {}
+    ~dump_buffer() { flush(); }
+
+    dump_buffer(dump_buffer const&) = delete;
+    dump_buffer& operator= (dump_buffer const&) = delete;
+
+    /** the buffered characters, not yet handed to the sink */
+    csubstr buffered() const noexcept { return m_buf.first(m_pos); }
+    /** the capacity of the buffer */
+    size_t capacity() const noexcept { return m_buf.len; }
+    Sink      & sink()       noexcept { return m_sink; }
+    Sink const& sink() const noexcept { return m_sink; }
+
+    /** hand the buffered characters to the sink */
+    void flush()
+    {
+        if(m_pos)
+            m_sink(csubstr(m_buf.str, m_pos));
+        m_pos = 0;
+        m_record = 0;
+    }
+
+    /** append a string as a record. This is the dumper function
+     * interface, so that this object can be given to c4::cat_dump()
+     * and friends. */
+    void operator() (csubstr s)
+    {
+        _write(s);
+        m_record = m_pos;
+    }
+
+    /** serialize the arguments into the buffer, as a record
+     * @return 0 if all the arguments were written, or else the size
+     * needed by the largest argument which did not fit even in the
+     * empty buffer, and was skipped. */
+    template<class... Args>
+    size_t cat(Args const& C4_RESTRICT ...args)
+    {
+        size_t needed = 0;
+        _cat(&needed, args...);
+        m_record = m_pos;
+        return needed;
+    }
+
+    /** serialize the arguments into the buffer with a separator
+     * between each, as a record
+     * @return 0 if all the arguments were written, or the size needed
+     * by the largest argument which did not fit
+     * @see cat() */
+    template<class Sep, class... Args>
+    size_t catsep(Sep const& C4_RESTRICT sep, Args const& C4_RESTRICT ...args)
+    {
+        size_t needed = 0;
+        _catsep(&needed, sep, args...);
+        m_record = m_pos;
+        return needed;
+    }
+
+    /** serialize the arguments into the buffer using a format string
+     * with {} placeholders, as a record. This follows the rules of
+     * c4::format().
+     * @return 0 if all the arguments were written, or the size needed
+     * by the largest argument which did not fit
+     * @see cat() */
+    template<class... Args>
+    size_t format(csubstr fmt, Args const& C4_RESTRICT ...args)
+    {
+        size_t needed = 0;
+        _format(&needed, fmt, args...);
+        m_record = m_pos;
+        return needed;
+    }
+
+private:
+
+    /** make room for @p num characters, handing to the sink the
+     * records before the current one. If that is not enough, the
+     * current record is handed to the sink as well.
+     * @pre @p num fits in the empty buffer */
+    C4_NO_INLINE void _make_room(size_t num)
+    {
+        if(m_record)
+        {
+            m_sink(csubstr(m_buf.str, m_record));
+            m_pos -= m_record;
+            memmove(m_buf.str, m_buf.str + m_record, m_pos);
+            m_record = 0;
+        }
+        if(m_buf.len - m_pos < num)
+        {
+            if(m_pos)
+                m_sink(csubstr(m_buf.str, m_pos));
+            m_pos = 0;
+        }
+    }
+
+    C4_ALWAYS_INLINE void _write(csubstr s)
+    {
+        if(C4_UNLIKELY(m_buf.len - m_pos < s.len))
+        {
+            if(C4_UNLIKELY(s.len > m_buf.len))
+            {
+                flush();
+                m_sink(s); // too large: pass it through, without copying
+                return;
+            }
+            _make_room(s.len);
+        }
+        if(s.len)
+            memcpy(m_buf.str + m_pos, s.str, s.len);
+        m_pos += s.len;
+    }
+
+    C4_ALWAYS_INLINE void _write_arg(size_t *C4_RESTRICT, csubstr s) { _write(s); }
+    C4_ALWAYS_INLINE void _write_arg(size_t *C4_RESTRICT, substr s) { _write(s); }
+    template<size_t N>
+    C4_ALWAYS_INLINE void _write_arg(size_t *C4_RESTRICT, const char (&s)[N]) { _write(csubstr(s)); }
+
+    template<class Arg>
+    C4_ALWAYS_INLINE void _write_arg(size_t *C4_RESTRICT needed, Arg const& C4_RESTRICT a)
+    {
+        size_t num = to_chars(m_buf.sub(m_pos), a);
+        if(C4_UNLIKELY(num > m_buf.len - m_pos))
+        {
+            if(C4_UNLIKELY(num > m_buf.len))
+            {
+                *needed = num > *needed ? num : *needed;
+                return;
+            }
+            _make_room(num);
+            num = to_chars(m_buf.sub(m_pos), a);
+        }
+        m_pos += num;
+    }
+
+    C4_ALWAYS_INLINE void _cat(size_t *C4_RESTRICT) {}
+    template<class Arg, class... Args>
+    C4_ALWAYS_INLINE void _cat(size_t *C4_RESTRICT needed, Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
+    {
+        _write_arg(needed, a);
+        _cat(needed, more...);
+    }
+
+    template<class Sep>
+    C4_ALWAYS_INLINE void _catsep(size_t *C4_RESTRICT, Sep const& C4_RESTRICT) {}
+    template<class Sep, class Arg, class... Args>
+    C4_ALWAYS_INLINE void _catsep(size_t *C4_RESTRICT needed, Sep const& C4_RESTRICT sep, Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
+    {
+        _write_arg(needed, a);
+        if C4_IF_CONSTEXPR (sizeof...(more) > 0)
+            _write_arg(needed, sep);
+        _catsep(needed, sep, more...);
+    }
+
+    C4_ALWAYS_INLINE void _format(size_t *C4_RESTRICT, csubstr fmt)
+    {
+        _write(fmt);
+    }
+    template<class Arg, class... Args>
+    C4_ALWAYS_INLINE void _format(size_t *C4_RESTRICT needed, csubstr fmt, Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
+    {
+        const size_t pos = fmt.find("{}");
+        if(C4_UNLIKELY(pos == csubstr::npos))
+        {
+            _write(fmt);
+            return;
+        }
+        _write(fmt.first(pos));
+        _write_arg(needed, a);
+        _format(needed, fmt.sub(pos + 2), more...);
+    }
+};
+
+
 } // namespace c4
 
 
@@ -1,4 +1,5 @@
 #include "c4/format.hpp"
+#include "c4/dump.hpp"
 
 #include <memory> // for std::align
 
@@ -13,6 +14,185 @@
 namespace c4 {
 
 
+namespace detail {
+
+size_t _compile_format(csubstr fmt, compiled_format_slot *C4_RESTRICT slots, size_t max_slots, size_t *C4_RESTRICT num_args) noexcept
+{
+    C4_ASSERT(max_slots > 0);
+    size_t num_slots = 0;
+    size_t next_seq = 0; // the index of the next sequential placeholder
+    size_t nargs = 0;
+    size_t lit_pos = 0; // the start of the current literal segment
+    size_t pos = 0;
+    while(pos + 1 < fmt.len)
+    {
+        if(fmt.str[pos] != '{')
+        {
+            ++pos;
+            continue;
+        }
+        // find the closing bracket, accepting only digits in between
+        size_t close = pos + 1;
+        size_t idx = 0;
+        while(close < fmt.len && fmt.str[close] >= '0' && fmt.str[close] <= '9')
+        {
+            idx = 10u * idx + static_cast<size_t>(fmt.str[close] - '0');
+            ++close;
+        }
+        if(close >= fmt.len || fmt.str[close] != '}' || close - pos > 10u)
+        {
+            ++pos; // not a placeholder: this is part of the literal
+            continue;
+        }
+        if(close == pos + 1)
+            idx = next_seq++;
+        if(C4_UNLIKELY(num_slots + 1 >= max_slots))
+            return csubstr::npos;
+        slots[num_slots].lit_pos = lit_pos;
+        slots[num_slots].lit_len = pos - lit_pos;
+        slots[num_slots].arg = idx;
+        ++num_slots;
+        nargs = idx + 1 > nargs ? idx + 1 : nargs;
+        pos = close + 1;
+        lit_pos = pos;
+    }
+    slots[num_slots].lit_pos = lit_pos;
+    slots[num_slots].lit_len = fmt.len - lit_pos;
+    slots[num_slots].arg = csubstr::npos;
+    *num_args = nargs;
+    return num_slots + 1;
+}
+
+} // namespace detail
+
+
+//-----------------------------------------------------------------------------
+
+namespace {
+C4_ALWAYS_INLINE size_t _vwrite(substr *C4_RESTRICT buf, format_arg const& C4_RESTRICT arg)
+{
+    size_t num = arg.to_chars(*buf);
+    *buf = buf->len >= num ? buf->sub(num) : substr{};
+    return num;
+}
+C4_ALWAYS_INLINE size_t _vwrite(substr *C4_RESTRICT buf, csubstr s)
+{
+    size_t num = to_chars(*buf, s);
+    *buf = buf->len >= num ? buf->sub(num) : substr{};
+    return num;
+}
+} // namespace
+
+size_t vcat(substr buf, format_args args)
+{
+    size_t num = 0;
+    for(size_t i = 0; i < args.num; ++i)
+        num += _vwrite(&buf, args.args[i]);
+    return num;
+}
+
+size_t vcatsep(substr buf, format_arg sep, format_args args)
+{
+    size_t num = 0;
+    for(size_t i = 0; i < args.num; ++i)
+    {
+        if(i)
+            num += _vwrite(&buf, sep);
+        num += _vwrite(&buf, args.args[i]);
+    }
+    return num;
+}
+
+size_t vformat(substr buf, csubstr fmt, format_args args)
+{
+    size_t num = 0;
+    for(size_t i = 0; i < args.num; ++i)
+    {
+        const size_t pos = fmt.find("{}");
+        if(C4_UNLIKELY(pos == csubstr::npos))
+            break;
+        num += _vwrite(&buf, fmt.first(pos));
+        num += _vwrite(&buf, args.args[i]);
+        fmt = fmt.sub(pos + 2);
+    }
+    num += _vwrite(&buf, fmt);
+    return num;
+}
+
+
+//-----------------------------------------------------------------------------
+
+namespace {
+/** dump an argument, with the semantics of c4::dump(): strings are
+ * dumped directly, other arguments are first serialized to the
+ * buffer. After a failure, the buffer is emptied so that nothing
+ * more is dumped. */
+C4_ALWAYS_INLINE size_t _vdump(DumperPfn dumpfn, substr *C4_RESTRICT buf, format_arg const& C4_RESTRICT arg)
+{
+    if(arg.is_str())
+    {
+        if(buf->len)
+            dumpfn(arg.str());
+        return 0u;
+    }
+    size_t sz = arg.to_chars(*buf);
+    if(C4_LIKELY(sz <= buf->len))
+        dumpfn(buf->first(sz));
+    else
+        buf->len = 0;
+    return sz;
+}
+} // namespace
+
+size_t vcat_dump(DumperPfn dumpfn, substr buf, format_args args)
+{
+    size_t sz = 0;
+    for(size_t i = 0; i < args.num; ++i)
+    {
+        size_t szarg = _vdump(dumpfn, &buf, args.args[i]);
+        sz = szarg > sz ? szarg : sz;
+    }
+    return sz;
+}
+
+size_t vcatsep_dump(DumperPfn dumpfn, substr buf, format_arg sep, format_args args)
+{
+    size_t sz = 0;
+    for(size_t i = 0; i < args.num; ++i)
+    {
+        if(i)
+        {
+            size_t szsep = _vdump(dumpfn, &buf, sep);
+            sz = szsep > sz ? szsep : sz;
+        }
+        size_t szarg = _vdump(dumpfn, &buf, args.args[i]);
+        sz = szarg > sz ? szarg : sz;
+    }
+    return sz;
+}
+
+size_t vformat_dump(DumperPfn dumpfn, substr buf, csubstr fmt, format_args args)
+{
+    size_t sz = 0;
+    for(size_t i = 0; i < args.num; ++i)
+    {
+        const size_t pos = fmt.find("{}");
+        if(C4_UNLIKELY(pos == csubstr::npos))
+            break;
+        if(C4_LIKELY(buf.len > 0 && pos > 0))
+            dumpfn(fmt.first(pos)); // we can dump without using buf
+        fmt = fmt.sub(pos + 2);
+        size_t szarg = _vdump(dumpfn, &buf, args.args[i]);
+        sz = szarg > sz ? szarg : sz;
+    }
+    if(C4_LIKELY(buf.len > 0 && fmt.len > 0))
+        dumpfn(fmt);
+    return sz;
+}
+
+
+//-----------------------------------------------------------------------------
+
 size_t to_chars(substr buf, fmt::const_raw_wrapper r)
 {
     void * vptr = buf.str;
@@ -46,6 +226,17 @@ bool from_chars(csubstr buf, fmt::raw_wrapper *r)
     return true;
 }
 
+parse_result from_chars_checked(csubstr buf, fmt::raw_wrapper *r)
+{
+    void * vptr = (void*)buf.str;
+    size_t space = buf.len;
+    auto ptr = (decltype(buf.str)) std::align(r->alignment, r->len, vptr, space);
+    if(ptr == nullptr)
+        return parse_result{buf.len, errc::invalid_argument};
+    memcpy(r->buf, ptr, r->len);
+    return parse_result{static_cast<size_t>(ptr - buf.str) + r->len, errc::ok};
+}
+
 
 } // namespace c4
 
@@ -6,6 +6,9 @@
 
 #include "c4/charconv.hpp"
 #include "c4/blob.hpp"
+#include "c4/span.hpp"
+#include "c4/format_string.hpp"
+#include "c4/format_args.hpp"
 
 
 #ifdef _MSC_VER
@@ -56,6 +59,8 @@ inline size_t to_chars(substr buf, fmt::boolalpha_<T> fmt)
     return to_chars(buf, fmt.val ? "true" : "false");
 }
 
+template<class T> struct max_chars<fmt::boolalpha_<T>> : public detail::_max_chars_fixed<5> {};
+
 
 
 //-----------------------------------------------------------------------------
@@ -216,7 +221,7 @@ inline integral_<T> bin(T v)
 /** format an integral_ signed type */
 template<typename T>
 C4_ALWAYS_INLINE
-typename std::enable_if<std::is_signed<T>::value, size_t>::type
+typename std::enable_if<detail::is_sint<T>::value, size_t>::type
 to_chars(substr buf, fmt::integral_<T> fmt)
 {
     return itoa(buf, fmt.val, fmt.radix);
@@ -224,7 +229,7 @@ to_chars(substr buf, fmt::integral_<T> fmt)
 /** format an integral_ signed type, pad with zeroes */
 template<typename T>
 C4_ALWAYS_INLINE
-typename std::enable_if<std::is_signed<T>::value, size_t>::type
+typename std::enable_if<detail::is_sint<T>::value, size_t>::type
 to_chars(substr buf, fmt::integral_padded_<T> fmt)
 {
     return itoa(buf, fmt.val, fmt.radix, fmt.num_digits);
@@ -233,7 +238,7 @@ to_chars(substr buf, fmt::integral_padded_<T> fmt)
 /** format an integral_ unsigned type */
 template<typename T>
 C4_ALWAYS_INLINE
-typename std::enable_if<std::is_unsigned<T>::value, size_t>::type
+typename std::enable_if<detail::is_uint<T>::value, size_t>::type
 to_chars(substr buf, fmt::integral_<T> fmt)
 {
     return utoa(buf, fmt.val, fmt.radix);
@@ -241,12 +246,137 @@ to_chars(substr buf, fmt::integral_<T> fmt)
 /** format an integral_ unsigned type, pad with zeroes */
 template<typename T>
 C4_ALWAYS_INLINE
-typename std::enable_if<std::is_unsigned<T>::value, size_t>::type
+typename std::enable_if<detail::is_uint<T>::value, size_t>::type
 to_chars(substr buf, fmt::integral_padded_<T> fmt)
 {
     return utoa(buf, fmt.val, fmt.radix, fmt.num_digits);
 }
 
+namespace detail {
+/** the bound for itoa()/utoa() with the given radix, and padded to
+ * @p num_digits */
+template<class T>
+C4_CONSTEXPR14 size_t _integral_chars_bound(T radix, size_t num_digits) noexcept
+{
+    enum : size_t { num_bits = sizeof(T) * CHAR_BIT };
+    const size_t digits = radix == T(2) ? size_t(num_bits)
+        : radix == T(8) ? size_t((num_bits + 2u) / 3u)
+        : radix == T(16) ? size_t(num_bits / 4u)
+        : size_t((num_bits * 643u) / 2136u + 1u);
+    // the sign and the radix prefix, eg -0x
+    return 3u + (digits > num_digits ? digits : num_digits);
+}
+} // namespace detail
+
+template<class T>
+struct max_chars<fmt::integral_<T>>
+{
+    static C4_CONSTEXPR14 size_t bound(fmt::integral_<T> const& fmt) noexcept { return detail::_integral_chars_bound<T>(fmt.radix, 0u); }
+};
+template<class T>
+struct max_chars<fmt::integral_padded_<T>>
+{
+    static C4_CONSTEXPR14 size_t bound(fmt::integral_padded_<T> const& fmt) noexcept { return detail::_integral_chars_bound<T>(fmt.radix, fmt.num_digits); }
+};
+
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+// reading integral types with overflow detection
+
+namespace fmt {
+
+/** read an integral type, failing if the value is out of the type's
+ * range. The reason for a failure is written to @p err (if it is not
+ * null).
+ * @see atoi_checked(), atou_checked() */
+template<class T>
+struct overflow_checked_
+{
+    T *val;
+    errc *err;
+    overflow_checked_(T *v, errc *e=nullptr) : val(v), err(e) {}
+};
+
+/** mark a variable to be read with overflow detection
+ * @see atoi_checked(), atou_checked() */
+template<class T>
+overflow_checked_<T> overflow_checked(T &val, errc *err=nullptr)
+{
+    C4_STATIC_ASSERT(std::is_integral<T>::value);
+    return overflow_checked_<T>(&val, err);
+}
+
+} // namespace fmt
+
+/** read an integral type, failing if the value is out of the type's range */
+template<class T>
+inline bool from_chars(csubstr buf, fmt::overflow_checked_<T> *wrapper)
+{
+    const errc ret = atox_checked(buf, wrapper->val);
+    if(wrapper->err)
+        *wrapper->err = ret;
+    return ret == errc::ok;
+}
+/** read an integral type, failing if the value is out of the type's range */
+template<class T>
+inline bool from_chars(csubstr buf, fmt::overflow_checked_<T> wrapper)
+{
+    return from_chars(buf, &wrapper);
+}
+
+/** read an integral type, failing if the value is out of the type's range */
+template<class T>
+inline size_t from_chars_first(csubstr buf, fmt::overflow_checked_<T> *wrapper)
+{
+    return atox_first_checked(buf, wrapper->val, wrapper->err);
+}
+/** read an integral type, failing if the value is out of the type's range */
+template<class T>
+inline size_t from_chars_first(csubstr buf, fmt::overflow_checked_<T> wrapper)
+{
+    return from_chars_first(buf, &wrapper);
+}
+
+/** read an integral type, failing if the value is out of the type's
+ * range. The reason for a failure is also written to the wrapper's
+ * error (if it is not null).
+ * @see parse_result */
+template<class T>
+inline parse_result from_chars_checked(csubstr buf, fmt::overflow_checked_<T> *wrapper)
+{
+    const parse_result ret = from_chars_checked(buf, wrapper->val);
+    if(wrapper->err)
+        *wrapper->err = ret.err;
+    return ret;
+}
+/** @copydoc from_chars_checked(csubstr, fmt::overflow_checked_<T>*) */
+template<class T>
+inline parse_result from_chars_checked(csubstr buf, fmt::overflow_checked_<T> wrapper)
+{
+    return from_chars_checked(buf, &wrapper);
+}
+
+/** read the first integral type in the string, failing if the value
+ * is out of the type's range. The reason for a failure is also
+ * written to the wrapper's error (if it is not null).
+ * @see parse_result */
+template<class T>
+inline parse_result from_chars_first_checked(csubstr buf, fmt::overflow_checked_<T> *wrapper)
+{
+    const parse_result ret = from_chars_first_checked(buf, wrapper->val);
+    if(wrapper->err)
+        *wrapper->err = ret.err;
+    return ret;
+}
+/** @copydoc from_chars_first_checked(csubstr, fmt::overflow_checked_<T>*) */
+template<class T>
+inline parse_result from_chars_first_checked(csubstr buf, fmt::overflow_checked_<T> wrapper)
+{
+    return from_chars_first_checked(buf, &wrapper);
+}
+
 
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
@@ -274,6 +404,79 @@ real_<T> real(T val, int precision, RealFormat_e fmt=FTOA_FLOAT)
 
 inline size_t to_chars(substr buf, fmt::real_< float> fmt) { return ftoa(buf, fmt.val, fmt.precision, fmt.fmt); }
 inline size_t to_chars(substr buf, fmt::real_<double> fmt) { return dtoa(buf, fmt.val, fmt.precision, fmt.fmt); }
+inline size_t to_chars(substr buf, fmt::real_<    half> fmt) { return ftoa(buf, fmt.val, fmt.precision, fmt.fmt); }
+inline size_t to_chars(substr buf, fmt::real_<bfloat16> fmt) { return ftoa(buf, fmt.val, fmt.precision, fmt.fmt); }
+
+template<class T>
+struct max_chars<fmt::real_<T>>
+{
+    static C4_CONSTEXPR14 size_t bound(fmt::real_<T> const& fmt) noexcept { return detail::_real_chars_bound<T>(fmt.precision, fmt.fmt); }
+};
+
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+// formatting fixed point decimals
+
+namespace fmt {
+
+/** format a fixed point decimal with a number of decimals other than
+ * its scale, and pad its integral part with zeroes on the left
+ * @see c4::decimal */
+template<unsigned Scale>
+struct decimal_
+{
+    c4::decimal<Scale> val;
+    int precision;
+    size_t num_int_digits;
+    C4_ALWAYS_INLINE decimal_(c4::decimal<Scale> v, int prec, size_t nd) : val(v), precision(prec), num_int_digits(nd) {}
+};
+
+/** write the decimal with @p precision decimals. With fewer decimals
+ * than the scale, the value is rounded to nearest, ties to even (like
+ * printf()); with more, it is padded with zeroes. A negative
+ * precision keeps the scale. */
+template<unsigned Scale>
+C4_ALWAYS_INLINE decimal_<Scale> real(c4::decimal<Scale> val, int precision)
+{
+    return decimal_<Scale>(val, precision, 0u);
+}
+/** pad the integral part of the decimal with zeroes on the left */
+template<unsigned Scale>
+C4_ALWAYS_INLINE decimal_<Scale> zpad(c4::decimal<Scale> val, size_t num_int_digits)
+{
+    return decimal_<Scale>(val, -1, num_int_digits);
+}
+/** pad the integral part of the decimal with zeroes on the left */
+template<unsigned Scale>
+C4_ALWAYS_INLINE decimal_<Scale> zpad(decimal_<Scale> val, size_t num_int_digits)
+{
+    return decimal_<Scale>(val.val, val.precision, num_int_digits);
+}
+
+} // namespace fmt
+
+template<unsigned Scale>
+inline size_t to_chars(substr buf, fmt::decimal_<Scale> fmt)
+{
+    if(fmt.precision < 0 || static_cast<unsigned>(fmt.precision) == Scale)
+        return detail::_write_decimal_raw(buf, fmt.val.raw, Scale, 0u, fmt.num_int_digits);
+    else if(static_cast<unsigned>(fmt.precision) < Scale)
+        return detail::_write_decimal_raw(buf, detail::_round_decimal_raw(fmt.val.raw, Scale - static_cast<unsigned>(fmt.precision)), static_cast<unsigned>(fmt.precision), 0u, fmt.num_int_digits);
+    return detail::_write_decimal_raw(buf, fmt.val.raw, Scale, static_cast<unsigned>(fmt.precision) - Scale, fmt.num_int_digits);
+}
+
+template<unsigned Scale>
+struct max_chars<fmt::decimal_<Scale>>
+{
+    static C4_CONSTEXPR14 size_t bound(fmt::decimal_<Scale> const& fmt) noexcept
+    {
+        const size_t int_digits = fmt.num_int_digits > 19u ? fmt.num_int_digits : size_t(19);
+        const size_t frac_digits = fmt.precision > static_cast<int>(Scale) ? static_cast<size_t>(fmt.precision) : size_t(Scale);
+        return 1u + int_digits + 1u + frac_digits;
+    }
+};
 
 
 //-----------------------------------------------------------------------------
@@ -346,6 +549,13 @@ inline raw_wrapper raw(T & C4_RESTRICT data, size_t alignment=alignof(T))
 /** write a variable in raw binary format, using memcpy */
 C4CORE_EXPORT size_t to_chars(substr buf, fmt::const_raw_wrapper r);
 
+/** the data may need padding for its alignment */
+template<>
+struct max_chars<fmt::const_raw_wrapper>
+{
+    static C4_CONSTEXPR14 size_t bound(fmt::const_raw_wrapper const& r) noexcept { return r.len + r.alignment - 1u; }
+};
+
 /** read a variable in raw binary format, using memcpy */
 C4CORE_EXPORT bool from_chars(csubstr buf, fmt::raw_wrapper *r);
 /** read a variable in raw binary format, using memcpy */
@@ -365,6 +575,27 @@ inline size_t from_chars_first(csubstr buf, fmt::raw_wrapper r)
     return from_chars(buf, &r);
 }
 
+/** read a variable in raw binary format, using memcpy. If the string
+ * is too short for the aligned variable, errc::invalid_argument is
+ * returned with the string's length; otherwise the number of
+ * characters consumed includes the alignment padding. */
+C4CORE_EXPORT parse_result from_chars_checked(csubstr buf, fmt::raw_wrapper *r);
+/** @copydoc from_chars_checked(csubstr, fmt::raw_wrapper*) */
+inline parse_result from_chars_checked(csubstr buf, fmt::raw_wrapper r)
+{
+    return from_chars_checked(buf, &r);
+}
+/** @copydoc from_chars_checked(csubstr, fmt::raw_wrapper*) */
+inline parse_result from_chars_first_checked(csubstr buf, fmt::raw_wrapper *r)
+{
+    return from_chars_checked(buf, r);
+}
+/** @copydoc from_chars_checked(csubstr, fmt::raw_wrapper*) */
+inline parse_result from_chars_first_checked(csubstr buf, fmt::raw_wrapper r)
+{
+    return from_chars_checked(buf, &r);
+}
+
 
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
@@ -408,34 +639,104 @@ right_<T> right(T val, size_t width, char padchar=' ')
 } // namespace fmt
 
 
+/** the value is serialized only once, at the start of the buffer,
+ * and the remainder of the field is then filled with the pad char */
 template<class T>
 size_t to_chars(substr buf, fmt::left_<T> const& C4_RESTRICT align)
 {
     size_t ret = to_chars(buf, align.val);
     if(ret >= buf.len || ret >= align.width)
         return ret > align.width ? ret : align.width;
-    buf.first(align.width).sub(ret).fill(align.pad);
-    to_chars(buf, align.val);
+    const size_t end = align.width < buf.len ? align.width : buf.len;
+    memset(buf.str + ret, align.pad, end - ret);
     return align.width;
 }
 
+/** the value is serialized only once, at the start of the buffer,
+ * and then moved to the end of the field, whose start is filled
+ * with the pad char */
 template<class T>
 size_t to_chars(substr buf, fmt::right_<T> const& C4_RESTRICT align)
 {
     size_t ret = to_chars(buf, align.val);
     if(ret >= buf.len || ret >= align.width)
         return ret > align.width ? ret : align.width;
+    if(C4_UNLIKELY(align.width > buf.len))
+        return align.width;
     size_t rem = static_cast<size_t>(align.width - ret);
-    buf.first(rem).fill(align.pad);
-    to_chars(buf.sub(rem), align.val);
+    memmove(buf.str + rem, buf.str, ret);
+    memset(buf.str, align.pad, rem);
     return align.width;
 }
 
+template<class T>
+struct max_chars<fmt::left_<T>, typename std::enable_if<detail::has_max_chars<T>::value>::type>
+{
+    static size_t bound(fmt::left_<T> const& align)
+    {
+        const size_t ret = to_chars_bound(align.val);
+        return ret > align.width ? ret : align.width;
+    }
+};
+
+template<class T>
+struct max_chars<fmt::right_<T>, typename std::enable_if<detail::has_max_chars<T>::value>::type>
+{
+    static size_t bound(fmt::right_<T> const& align)
+    {
+        const size_t ret = to_chars_bound(align.val);
+        return ret > align.width ? ret : align.width;
+    }
+};
+
 
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 
+/** @name type-erased arguments
+ *
+ * Every distinct list of argument types given to c4::cat(),
+ * c4::catsep(), c4::format() and friends instantiates a new chain of
+ * templates. To reduce code size and compile time, the arguments can
+ * instead be packed into an array of c4::format_arg (a pointer to the
+ * argument plus a pointer to the function serializing it), which is
+ * handed to the non-template functions c4::vcat(), c4::vcatsep() and
+ * c4::vformat(), compiled once into the library:
+ *
+ * @code{.cpp}
+ * c4::vformat(buf, "{} and {}", c4::make_format_args(1, 2.5));
+ * @endcode
+ *
+ * When C4CORE_FORMAT_ERASED_ARGS is defined (see the cmake option
+ * of the same name), the variadic functions cat(), catsep(),
+ * format(), catrs(), catseprs(), formatrs(), and cat_dump(),
+ * catsep_dump(), format_dump() taking the dump function as template
+ * argument, do just this: they only pack the arguments and call the
+ * non-template functions. This trades an indirect call per argument
+ * for the code size.
+ * @{ */
+
+// c4::format_arg, c4::format_args and c4::make_format_args() are
+// defined in c4/format_args.hpp
+
+/** like c4::cat(), but with type-erased arguments
+ * @return the number of characters needed to write all the arguments into the buffer. */
+C4CORE_EXPORT size_t vcat(substr buf, format_args args);
+
+/** like c4::catsep(), but with type-erased arguments
+ * @return the number of characters needed to write all the arguments into the buffer. */
+C4CORE_EXPORT size_t vcatsep(substr buf, format_arg sep, format_args args);
+
+/** like c4::format(), but with type-erased arguments
+ * @return the number of characters needed to write into the buffer. */
+C4CORE_EXPORT size_t vformat(substr buf, csubstr fmt, format_args args);
+
+/** @} */
+
+
+//-----------------------------------------------------------------------------
+
 /// @cond dev
 // terminates the variadic recursion
 inline size_t cat(substr /*buf*/)
@@ -455,12 +756,41 @@ inline size_t cat(substr /*buf*/)
 template<class Arg, class... Args>
 size_t cat(substr buf, Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
 {
+#ifdef C4CORE_FORMAT_ERASED_ARGS
+    return vcat(buf, make_format_args(a, more...));
+#else
     size_t num = to_chars(buf, a);
     buf  = buf.len >= num ? buf.sub(num) : substr{};
     num += cat(buf, more...);
     return num;
+#endif
 }
 
+/** the maximum number of characters written by c4::cat() for
+ * arguments of these types. This is defined only when every type has
+ * a compile-time c4::max_chars<T>::value, and can be used to size a
+ * stack buffer which is known to be large enough:
+ *
+ * @code{.cpp}
+ * char buf_[c4::cat_max_chars<int, char, double>::value];
+ * c4::substr buf(buf_, sizeof(buf_));
+ * c4::csubstr s = c4::cat_sub(buf, i, ',', d); // always fits
+ * @endcode */
+template<class... Args>
+struct cat_max_chars;
+/// @cond dev
+template<>
+struct cat_max_chars<>
+{
+    enum : size_t { value = 0 };
+};
+template<class Arg, class... Args>
+struct cat_max_chars<Arg, Args...>
+{
+    enum : size_t { value = (size_t)max_chars<typename std::remove_cv<Arg>::type>::value + (size_t)cat_max_chars<Args...>::value };
+};
+/// @endcond
+
 /** like c4::cat() but return a substr instead of a size */
 template<class... Args>
 substr cat_sub(substr buf, Args && ...args)
@@ -566,10 +896,14 @@ size_t uncatsep_more(csubstr buf, Sep & C4_RESTRICT sep, Arg & C4_RESTRICT a, Ar
 template<class Sep, class Arg, class... Args>
 size_t catsep(substr buf, Sep const& C4_RESTRICT sep, Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
 {
+#ifdef C4CORE_FORMAT_ERASED_ARGS
+    return vcatsep(buf, make_format_arg(sep), make_format_args(a, more...));
+#else
     size_t num = to_chars(buf, a);
     buf  = buf.len >= num ? buf.sub(num) : substr{};
     num += detail::catsep_more(buf, sep, more...);
     return num;
+#endif
 }
 
 /** like c4::catsep() but return a substr instead of a size
@@ -633,6 +967,9 @@ inline size_t format(substr buf, csubstr fmt)
 template<class Arg, class... Args>
 size_t format(substr buf, csubstr fmt, Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
 {
+#ifdef C4CORE_FORMAT_ERASED_ARGS
+    return vformat(buf, fmt, make_format_args(a, more...));
+#else
     size_t pos = fmt.find("{}"); // @todo use _find_fmt()
     if(C4_UNLIKELY(pos == csubstr::npos))
         return to_chars(buf, fmt);
@@ -645,6 +982,7 @@ size_t format(substr buf, csubstr fmt, Arg const& C4_RESTRICT a, Args const& C4_
     num  = format(buf, fmt.sub(pos + 2), more...);
     out += num;
     return out;
+#endif
 }
 
 /** like c4::format() but return a substr instead of a size
@@ -659,6 +997,125 @@ substr format_sub(substr buf, csubstr fmt, Args const& C4_RESTRICT ...args)
 }
 
 
+//-----------------------------------------------------------------------------
+
+/// @cond dev
+namespace detail {
+
+template<class Fmt, size_t Pos>
+C4_ALWAYS_INLINE size_t _format_ct(substr buf)
+{
+    return to_chars(buf, _ct_fmt_seg<Fmt, Pos>::get());
+}
+
+template<class Fmt, size_t Pos, class Arg, class... Args>
+C4_ALWAYS_INLINE size_t _format_ct(substr buf, Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
+{
+    using seg = _ct_fmt_seg<Fmt, Pos>;
+    size_t num = to_chars(buf, seg::get());
+    size_t out = num;
+    buf  = buf.len >= num ? buf.sub(num) : substr{};
+    num  = to_chars(buf, a);
+    out += num;
+    buf  = buf.len >= num ? buf.sub(num) : substr{};
+    num  = _format_ct<Fmt, seg::next>(buf, more...);
+    out += num;
+    return out;
+}
+
+} // namespace detail
+/// @endcond
+
+
+/** using a compile-time format string created with C4_FMT(),
+ * serialize the arguments into the given fixed-size buffer. This
+ * works like the runtime c4::format(), but the placeholders are
+ * found at compile time, and the number of arguments must be equal
+ * to the number of placeholders.
+ * @code{.cpp}
+ * c4::format(buf, C4_FMT("the {} drank {} {}"), "partier", 5, "beers");
+ * @endcode
+ * @return the number of characters needed to write into the buffer.
+ * @see C4_FMT() */
+template<class Fmt, class... Args>
+C4_ALWAYS_INLINE typename std::enable_if<is_ct_fmt<Fmt>::value, size_t>::type
+format(substr buf, Fmt const&, Args const& C4_RESTRICT ...args)
+{
+    static_assert(ct_fmt_num_args<Fmt>::value == sizeof...(Args), "the number of arguments must match the number of {} in the format string");
+    return detail::_format_ct<Fmt, 0>(buf, args...);
+}
+
+/** like c4::format() with a compile-time format string, but return a
+ * substr instead of a size */
+template<class Fmt, class... Args>
+C4_ALWAYS_INLINE typename std::enable_if<is_ct_fmt<Fmt>::value, substr>::type
+format_sub(substr buf, Fmt const& fmt, Args const& C4_RESTRICT ...args)
+{
+    size_t sz = c4::format(buf, fmt, args...);
+    C4_CHECK(sz <= buf.len);
+    return {buf.str, sz <= buf.len ? sz : buf.len};
+}
+
+
+//-----------------------------------------------------------------------------
+
+/// @cond dev
+namespace detail {
+
+inline size_t _to_chars_nth(substr /*buf*/, size_t /*n*/)
+{
+    C4_NEVER_REACH();
+    return 0;
+}
+
+/** serialize the n-th argument */
+template<class Arg, class... Args>
+size_t _to_chars_nth(substr buf, size_t n, Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
+{
+    if(n == 0)
+        return to_chars(buf, a);
+    return _to_chars_nth(buf, n - 1u, more...);
+}
+
+} // namespace detail
+/// @endcond
+
+
+/** using a compiled format, serialize the arguments into the given
+ * fixed-size buffer. The buffer size is strictly respected: no writes
+ * will occur beyond its end.
+ * @return the number of characters needed to write into the buffer.
+ * @see c4::basic_compiled_format */
+template<size_t MaxSlots, class... Args>
+size_t format(substr buf, basic_compiled_format<MaxSlots> const& cf, Args const& C4_RESTRICT ...args)
+{
+    size_t out = 0;
+    const size_t last = cf.num_slots() - 1u;
+    for(size_t i = 0; i < last; ++i)
+    {
+        size_t num = to_chars(buf, cf.literal(i));
+        out += num;
+        buf  = buf.len >= num ? buf.sub(num) : substr{};
+        const size_t arg = cf.slot(i).arg;
+        num  = C4_LIKELY(arg < sizeof...(Args)) ? detail::_to_chars_nth(buf, arg, args...) : to_chars(buf, cf.placeholder(i));
+        out += num;
+        buf  = buf.len >= num ? buf.sub(num) : substr{};
+    }
+    out += to_chars(buf, cf.literal(last));
+    return out;
+}
+
+/** like c4::format() with a compiled format, but return a substr
+ * instead of a size */
+template<size_t MaxSlots, class... Args>
+substr format_sub(substr buf, basic_compiled_format<MaxSlots> const& cf, Args const& C4_RESTRICT ...args)
+{
+    size_t sz = c4::format(buf, cf, args...);
+    C4_CHECK(sz <= buf.len);
+    return {buf.str, sz <= buf.len ? sz : buf.len};
+}
+
+
 //-----------------------------------------------------------------------------
 
 /// @cond dev
@@ -696,63 +1153,574 @@ size_t unformat(csubstr buf, csubstr fmt, Arg & C4_RESTRICT a, Args & C4_RESTRIC
 }
 
 
-//-----------------------------------------------------------------------------
-//-----------------------------------------------------------------------------
-//-----------------------------------------------------------------------------
+/// @cond dev
+namespace detail {
 
-/** a tag type for marking append to container
- * @see c4::catrs() */
-struct append_t {};
+template<class Fmt, size_t Pos>
+C4_ALWAYS_INLINE size_t _unformat_ct(csubstr /*buf*/)
+{
+    return _ct_fmt_seg<Fmt, Pos>::len;
+}
 
-/** a tag variable
- * @see c4::catrs() */
-constexpr const append_t append = {};
+template<class Fmt, size_t Pos, class Arg, class... Args>
+C4_ALWAYS_INLINE size_t _unformat_ct(csubstr buf, Arg & C4_RESTRICT a, Args & C4_RESTRICT ...more)
+{
+    using seg = _ct_fmt_seg<Fmt, Pos>;
+    size_t num = seg::len;
+    size_t out = num;
+    buf  = buf.len >= num ? buf.sub(num) : substr{};
+    num  = from_chars_first(buf, &a);
+    if(C4_UNLIKELY(num == csubstr::npos))
+        return csubstr::npos;
+    out += num;
+    buf  = buf.len >= num ? buf.sub(num) : substr{};
+    num  = _unformat_ct<Fmt, seg::next>(buf, more...);
+    if(C4_UNLIKELY(num == csubstr::npos))
+        return csubstr::npos;
+    out += num;
+    return out;
+}
 
+} // namespace detail
+/// @endcond
 
-//-----------------------------------------------------------------------------
 
-/** like c4::cat(), but receives a container, and resizes it as needed to contain
- * the result. The container is overwritten. To append to it, use the append
- * overload.
- * @see c4::cat() */
-template<class CharOwningContainer, class... Args>
-inline void catrs(CharOwningContainer * C4_RESTRICT cont, Args const& C4_RESTRICT ...args)
+/** using a compile-time format string created with C4_FMT(),
+ * deserialize the arguments from the given buffer. This works like
+ * the runtime c4::unformat(), but the placeholders are found at
+ * compile time, and the number of arguments must be equal to the
+ * number of placeholders.
+ * @return the number of characters read from the buffer, or npos if a conversion failed.
+ * @see C4_FMT() */
+template<class Fmt, class... Args>
+C4_ALWAYS_INLINE typename std::enable_if<is_ct_fmt<Fmt>::value, size_t>::type
+unformat(csubstr buf, Fmt const&, Args & C4_RESTRICT ...args)
 {
-retry:
-    substr buf = to_substr(*cont);
-    size_t ret = cat(buf, args...);
-    cont->resize(ret);
-    if(ret > buf.len)
-        goto retry;
+    static_assert(ct_fmt_num_args<Fmt>::value == sizeof...(Args), "the number of arguments must match the number of {} in the format string");
+    return detail::_unformat_ct<Fmt, 0>(buf, args...);
 }
 
-/** like c4::cat(), but creates and returns a new container sized as needed to contain
- * the result.
- * @see c4::cat() */
-template<class CharOwningContainer, class... Args>
-inline CharOwningContainer catrs(Args const& C4_RESTRICT ...args)
-{
-    CharOwningContainer cont;
-    catrs(&cont, args...);
-    return cont;
-}
 
-/** like c4::cat(), but receives a container, and appends to it instead of
- * overwriting it. The container is resized as needed to contain the result.
- * @return the region newly appended to the original container
+//-----------------------------------------------------------------------------
+
+/** the result of c4::unformat_checked() */
+struct unformat_result
+{
+    enum : size_t { nofield = (size_t)-1 };
+    /** on success, the length of the buffer. On failure, the position
+     * in the buffer of the literal or of the field which failed. */
+    size_t consumed;
+    /** on success, nofield. On failure, the index of the placeholder
+     * whose field (or the literal before it) did not match; when the
+     * literal after the last placeholder does not match, this is the
+     * number of placeholders. */
+    size_t field;
+
+    C4_CONSTEXPR14 bool ok() const noexcept { return field == nofield; }
+    C4_CONSTEXPR14 explicit operator bool() const noexcept { return field == nofield; }
+};
+
+
+/// @cond dev
+namespace detail {
+
+/** true if the buffer starts with the literal */
+C4_ALWAYS_INLINE bool _unformat_lit(csubstr buf, csubstr lit) noexcept
+{
+    return buf.len >= lit.len && (lit.len == 0 || memcmp(buf.str, lit.str, lit.len) == 0);
+}
+
+/** the length of the field at the start of the buffer: it ends at
+ * the first character of the literal which follows its placeholder,
+ * or at the end of the buffer if the placeholder is the last and no
+ * literal follows it.
+ * @return the length of the field, or npos if it is not bounded */
+C4_ALWAYS_INLINE size_t _unformat_field_len(csubstr buf, csubstr next_lit, bool is_last) noexcept
+{
+    if(next_lit.len)
+    {
+        const void *pos = buf.len ? memchr(buf.str, next_lit.str[0], buf.len) : nullptr;
+        return pos ? static_cast<size_t>(static_cast<const char*>(pos) - buf.str) : csubstr::npos;
+    }
+    return is_last ? buf.len : csubstr::npos;
+}
+
+template<class Fmt, size_t Pos>
+C4_ALWAYS_INLINE unformat_result _unformat_checked_ct(csubstr buf, size_t pos, size_t field)
+{
+    using seg = _ct_fmt_seg<Fmt, Pos>;
+    if(C4_UNLIKELY(pos + (size_t)seg::len != buf.len || !_unformat_lit(buf.sub(pos), seg::get())))
+        return unformat_result{pos, field};
+    return unformat_result{buf.len, unformat_result::nofield};
+}
+
+template<class Fmt, size_t Pos, class Arg, class... Args>
+C4_ALWAYS_INLINE unformat_result _unformat_checked_ct(csubstr buf, size_t pos, size_t field, Arg & C4_RESTRICT a, Args & C4_RESTRICT ...more)
+{
+    using seg = _ct_fmt_seg<Fmt, Pos>;
+    using next = _ct_fmt_seg<Fmt, seg::next>;
+    static_assert(sizeof...(Args) == 0 || next::len > 0, "a placeholder must be followed by a literal, to bound its field");
+    if(C4_UNLIKELY(!_unformat_lit(buf.sub(pos), seg::get())))
+        return unformat_result{pos, field};
+    pos += seg::len;
+    const csubstr rest = buf.sub(pos);
+    const size_t len = _unformat_field_len(rest, next::get(), sizeof...(Args) == 0);
+    if(C4_UNLIKELY(len == csubstr::npos || !from_chars(rest.first(len), &a)))
+        return unformat_result{pos, field};
+    return _unformat_checked_ct<Fmt, seg::next>(buf, pos + len, field + 1u, more...);
+}
+
+inline bool _from_chars_nth(csubstr /*buf*/, size_t /*n*/)
+{
+    C4_NEVER_REACH();
+    return false;
+}
+
+/** deserialize the n-th argument */
+template<class Arg, class... Args>
+bool _from_chars_nth(csubstr buf, size_t n, Arg & C4_RESTRICT a, Args & C4_RESTRICT ...more)
+{
+    if(n == 0)
+        return from_chars(buf, &a);
+    return _from_chars_nth(buf, n - 1u, more...);
+}
+
+} // namespace detail
+/// @endcond
+
+
+/** using a compile-time format string created with C4_FMT(),
+ * deserialize the arguments from a record in the given buffer,
+ * verifying the whole record. Unlike c4::unformat():
+ *   - every literal segment is compared against the buffer.
+ *   - the field of each placeholder ends at the first occurrence of
+ *     the first character of the literal following it, and the whole
+ *     field must be converted with from_chars(). A placeholder which
+ *     is the last and is not followed by a literal takes the rest of
+ *     the buffer. Two adjacent placeholders are a compile error.
+ *   - the record must span the whole buffer.
+ *
+ * @code{.cpp}
+ * int id; double val; csubstr name;
+ * unformat_result r = c4::unformat_checked("id=7 val=1.5 name=foo", C4_FMT("id={} val={} name={}"), id, val, name);
+ * if(!r)
+ *     printf("field %zu failed at %zu\n", r.field, r.consumed);
+ * @endcode
+ *
+ * @note on failure, the arguments before the failing field have
+ * been assigned.
+ * @see c4::unformat_lines() to parse a buffer of records, one per line
+ * @see C4_FMT() */
+template<class Fmt, class... Args>
+C4_ALWAYS_INLINE typename std::enable_if<is_ct_fmt<Fmt>::value, unformat_result>::type
+unformat_checked(csubstr buf, Fmt const&, Args & C4_RESTRICT ...args)
+{
+    static_assert(ct_fmt_num_args<Fmt>::value == sizeof...(Args), "the number of arguments must match the number of {} in the format string");
+    return detail::_unformat_checked_ct<Fmt, 0>(buf, 0u, 0u, args...);
+}
+
+/** using a compiled format, deserialize the arguments from a record
+ * in the given buffer, verifying the whole record. This works like
+ * c4::unformat_checked() with a compile-time format string, but a
+ * placeholder which is not followed by a literal (other than the
+ * last), or whose argument is missing, fails at runtime. Positional
+ * placeholders read into the argument with that index.
+ * @see c4::basic_compiled_format */
+template<size_t MaxSlots, class... Args>
+unformat_result unformat_checked(csubstr buf, basic_compiled_format<MaxSlots> const& cf, Args & C4_RESTRICT ...args)
+{
+    const size_t last = cf.num_slots() - 1u;
+    size_t pos = 0;
+    for(size_t i = 0; i < last; ++i)
+    {
+        const csubstr lit = cf.literal(i);
+        if(C4_UNLIKELY(!detail::_unformat_lit(buf.sub(pos), lit)))
+            return unformat_result{pos, i};
+        pos += lit.len;
+        const csubstr rest = buf.sub(pos);
+        const size_t arg = cf.slot(i).arg;
+        const size_t len = detail::_unformat_field_len(rest, cf.literal(i + 1u), i + 1u == last);
+        if(C4_UNLIKELY(len == csubstr::npos || arg >= sizeof...(Args) || !detail::_from_chars_nth(rest.first(len), arg, args...)))
+            return unformat_result{pos, i};
+        pos += len;
+    }
+    const csubstr lit = cf.literal(last);
+    if(C4_UNLIKELY(pos + lit.len != buf.len || !detail::_unformat_lit(buf.sub(pos), lit)))
+        return unformat_result{pos, last};
+    return unformat_result{buf.len, unformat_result::nofield};
+}
+
+
+/** parse every line of the buffer as a record with
+ * c4::unformat_checked(), calling `fn(line_index, line, result)`
+ * after each line. When the result is ok, the arguments hold the
+ * values read from that line. Lines are terminated by `\n`, and a
+ * `\r` before it is removed; a newline at the end of the buffer does
+ * not start another line.
+ * @code{.cpp}
+ * auto fmt = C4_FMT("{} {} {}");
+ * int a, b; csubstr c;
+ * size_t num_ok = c4::unformat_lines(buf, fmt, [&](size_t line, csubstr, c4::unformat_result r){
+ *     if(r)
+ *         process(a, b, c);
+ *     else
+ *         report(line, r.field);
+ * }, a, b, c);
+ * @endcode
+ * @return the number of lines which were successfully parsed */
+template<class Fmt, class LineFn, class... Args>
+size_t unformat_lines(csubstr buf, Fmt const& fmt, LineFn &&fn, Args & C4_RESTRICT ...args)
+{
+    size_t num_ok = 0;
+    size_t line_index = 0;
+    size_t pos = 0;
+    while(pos < buf.len)
+    {
+        const void *nl = memchr(buf.str + pos, '\n', buf.len - pos);
+        const size_t end = nl ? static_cast<size_t>(static_cast<const char*>(nl) - buf.str) : buf.len;
+        csubstr line = buf.range(pos, end);
+        if(line.len && line.str[line.len - 1] == '\r')
+            --line.len;
+        const unformat_result result = unformat_checked(line, fmt, args...);
+        num_ok += result.ok();
+        fn(line_index, line, result);
+        ++line_index;
+        pos = end + 1;
+    }
+    return num_ok;
+}
+
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+/** a tag type for marking append to container
+ * @see c4::catrs() */
+struct append_t {};
+
+/** a tag variable
+ * @see c4::catrs() */
+constexpr const append_t append = {};
+
+
+/// @cond dev
+namespace detail {
+
+template<class... Args>
+struct _all_have_max_chars;
+template<>
+struct _all_have_max_chars<> : public std::true_type {};
+template<class Arg, class... Args>
+struct _all_have_max_chars<Arg, Args...>
+    : public std::integral_constant<bool, has_max_chars<typename std::remove_cv<Arg>::type>::value && _all_have_max_chars<Args...>::value>
+{
+};
+
+inline size_t _sum_chars_bound()
+{
+    return 0;
+}
+template<class Arg, class... Args>
+C4_ALWAYS_INLINE size_t _sum_chars_bound(Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
+{
+    return to_chars_bound(a) + _sum_chars_bound(more...);
+}
+
+template<class... Args>
+C4_ALWAYS_INLINE size_t _sum_chars_bound_if(std::true_type, Args const& C4_RESTRICT ...args)
+{
+    return _sum_chars_bound(args...);
+}
+template<class... Args>
+C4_ALWAYS_INLINE size_t _sum_chars_bound_if(std::false_type, Args const& C4_RESTRICT ...)
+{
+    return 0;
+}
+
+/** an upper bound for the size of cat(buf, args...), or 0 if some
+ * argument has no known bound */
+template<class... Args>
+C4_ALWAYS_INLINE size_t _cat_bound(Args const& C4_RESTRICT ...args)
+{
+    return _sum_chars_bound_if(_all_have_max_chars<Args...>{}, args...);
+}
+
+/** an upper bound for the size of catsep(buf, sep, args...), or 0 if
+ * some argument has no known bound */
+template<class Sep, class... Args>
+C4_ALWAYS_INLINE size_t _catsep_bound(Sep const& C4_RESTRICT sep, Args const& C4_RESTRICT ...args)
+{
+    using all_bounded = _all_have_max_chars<Sep, Args...>;
+    return sizeof...(Args) * _sum_chars_bound_if(all_bounded{}, sep) + _sum_chars_bound_if(all_bounded{}, args...);
+}
+
+/** an upper bound for the size of format(buf, fmt, args...), or 0 if
+ * some argument has no known bound */
+template<class... Args>
+C4_ALWAYS_INLINE size_t _format_bound(csubstr fmt, Args const& C4_RESTRICT ...args)
+{
+    using all_bounded = _all_have_max_chars<Args...>;
+    return all_bounded::value ? fmt.len + _sum_chars_bound_if(all_bounded{}, args...) : 0u;
+}
+
+/** make room for @p bound characters after @p pos, so that the
+ * arguments are serialized only once */
+template<class CharOwningContainer>
+C4_ALWAYS_INLINE void _reserve_chars(CharOwningContainer * C4_RESTRICT cont, size_t pos, size_t bound)
+{
+    if(bound && cont->size() < pos + bound)
+        cont->resize(pos + bound);
+}
+
+/** grow the container to fit at least @p needed characters. The
+ * growth is geometric, so that serializing many arguments which do
+ * not fit causes only a logarithmic number of resizes. */
+template<class CharOwningContainer>
+C4_NO_INLINE void _grow_chars(CharOwningContainer * C4_RESTRICT cont, size_t needed)
+{
+    size_t sz = 2u * cont->size();
+    cont->resize(sz > needed ? sz : needed);
+}
+
+/** serialize @p a into the container, starting at @p *pos, and then
+ * advance @p *pos. When the container is too small, it is grown
+ * and only this argument is serialized again: the arguments before
+ * it are kept in place, and the arguments after it are serialized
+ * from the resumed position. */
+template<class CharOwningContainer, class Arg>
+C4_ALWAYS_INLINE void _rs_write(CharOwningContainer * C4_RESTRICT cont, size_t * C4_RESTRICT pos, Arg const& C4_RESTRICT a)
+{
+    substr buf = to_substr(*cont).sub(*pos);
+    size_t ret = to_chars(buf, a);
+    while(C4_UNLIKELY(ret > buf.len))
+    {
+        _grow_chars(cont, *pos + ret);
+        buf = to_substr(*cont).sub(*pos);
+        ret = to_chars(buf, a);
+    }
+    *pos += ret;
+}
+
+#ifdef C4CORE_FORMAT_ERASED_ARGS
+
+template<class CharOwningContainer>
+void _vcatrs(CharOwningContainer * C4_RESTRICT cont, size_t * C4_RESTRICT pos, format_args args)
+{
+    for(size_t i = 0; i < args.num; ++i)
+        _rs_write(cont, pos, args[i]);
+}
+template<class CharOwningContainer, class... Args>
+C4_ALWAYS_INLINE void _catrs(CharOwningContainer * C4_RESTRICT cont, size_t * C4_RESTRICT pos, Args const& C4_RESTRICT ...args)
+{
+    _vcatrs(cont, pos, make_format_args(args...));
+}
+
+template<class CharOwningContainer>
+void _vcatseprs(CharOwningContainer * C4_RESTRICT cont, size_t * C4_RESTRICT pos, format_arg sep, format_args args)
+{
+    for(size_t i = 0; i < args.num; ++i)
+    {
+        if(i)
+            _rs_write(cont, pos, sep);
+        _rs_write(cont, pos, args[i]);
+    }
+}
+template<class CharOwningContainer, class Sep, class... Args>
+C4_ALWAYS_INLINE void _catseprs(CharOwningContainer * C4_RESTRICT cont, size_t * C4_RESTRICT pos, Sep const& C4_RESTRICT sep, Args const& C4_RESTRICT ...args)
+{
+    _vcatseprs(cont, pos, make_format_arg(sep), make_format_args(args...));
+}
+
+template<class CharOwningContainer>
+void _vformatrs(CharOwningContainer * C4_RESTRICT cont, size_t * C4_RESTRICT pos, csubstr fmt, format_args args)
+{
+    for(size_t i = 0; i < args.num; ++i)
+    {
+        const size_t fpos = fmt.find("{}");
+        if(C4_UNLIKELY(fpos == csubstr::npos))
+            break;
+        _rs_write(cont, pos, fmt.first(fpos));
+        _rs_write(cont, pos, args[i]);
+        fmt = fmt.sub(fpos + 2);
+    }
+    _rs_write(cont, pos, fmt);
+}
+template<class CharOwningContainer, class... Args>
+C4_ALWAYS_INLINE void _formatrs(CharOwningContainer * C4_RESTRICT cont, size_t * C4_RESTRICT pos, csubstr fmt, Args const& C4_RESTRICT ...args)
+{
+    _vformatrs(cont, pos, fmt, make_format_args(args...));
+}
+
+#else // C4CORE_FORMAT_ERASED_ARGS
+
+template<class CharOwningContainer>
+C4_ALWAYS_INLINE void _catrs(CharOwningContainer * C4_RESTRICT, size_t * C4_RESTRICT)
+{
+}
+template<class CharOwningContainer, class Arg, class... Args>
+C4_ALWAYS_INLINE void _catrs(CharOwningContainer * C4_RESTRICT cont, size_t * C4_RESTRICT pos, Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
+{
+    _rs_write(cont, pos, a);
+    _catrs(cont, pos, more...);
+}
+
+template<class CharOwningContainer, class Sep>
+C4_ALWAYS_INLINE void _catseprs_more(CharOwningContainer * C4_RESTRICT, size_t * C4_RESTRICT, Sep const& C4_RESTRICT)
+{
+}
+template<class CharOwningContainer, class Sep, class Arg, class... Args>
+C4_ALWAYS_INLINE void _catseprs_more(CharOwningContainer * C4_RESTRICT cont, size_t * C4_RESTRICT pos, Sep const& C4_RESTRICT sep, Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
+{
+    _rs_write(cont, pos, sep);
+    _rs_write(cont, pos, a);
+    _catseprs_more(cont, pos, sep, more...);
+}
+template<class CharOwningContainer, class Sep, class Arg, class... Args>
+C4_ALWAYS_INLINE void _catseprs(CharOwningContainer * C4_RESTRICT cont, size_t * C4_RESTRICT pos, Sep const& C4_RESTRICT sep, Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
+{
+    _rs_write(cont, pos, a);
+    _catseprs_more(cont, pos, sep, more...);
+}
+
+template<class CharOwningContainer>
+C4_ALWAYS_INLINE void _formatrs(CharOwningContainer * C4_RESTRICT cont, size_t * C4_RESTRICT pos, csubstr fmt)
+{
+    _rs_write(cont, pos, fmt);
+}
+template<class CharOwningContainer, class Arg, class... Args>
+void _formatrs(CharOwningContainer * C4_RESTRICT cont, size_t * C4_RESTRICT pos, csubstr fmt, Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
+{
+    const size_t fpos = fmt.find("{}");
+    if(C4_UNLIKELY(fpos == csubstr::npos))
+    {
+        _rs_write(cont, pos, fmt);
+        return;
+    }
+    _rs_write(cont, pos, fmt.first(fpos));
+    _rs_write(cont, pos, a);
+    _formatrs(cont, pos, fmt.sub(fpos + 2), more...);
+}
+
+#endif // C4CORE_FORMAT_ERASED_ARGS
+
+template<class CharOwningContainer, class... Args>
+void _rs_write_nth(CharOwningContainer * C4_RESTRICT cont, size_t * C4_RESTRICT pos, size_t n, Args const& C4_RESTRICT ...args)
+{
+    substr buf = to_substr(*cont).sub(*pos);
+    size_t ret = _to_chars_nth(buf, n, args...);
+    while(C4_UNLIKELY(ret > buf.len))
+    {
+        _grow_chars(cont, *pos + ret);
+        buf = to_substr(*cont).sub(*pos);
+        ret = _to_chars_nth(buf, n, args...);
+    }
+    *pos += ret;
+}
+
+/** an upper bound for the size of format(buf, cf, args...), or 0 if
+ * some argument has no known bound. Arguments may be used more than
+ * once, so the bound is summed over the slots. */
+template<size_t MaxSlots, class... Args>
+size_t _compiled_format_bound(std::true_type, basic_compiled_format<MaxSlots> const& cf, Args const& C4_RESTRICT ...args)
+{
+    const size_t bounds[] = {to_chars_bound(args)..., 0u};
+    size_t sum = cf.fmt().len;
+    for(size_t i = 0; i + 1u < cf.num_slots(); ++i)
+    {
+        const size_t arg = cf.slot(i).arg;
+        if(arg < sizeof...(Args))
+            sum += bounds[arg];
+    }
+    return sum;
+}
+template<size_t MaxSlots, class... Args>
+C4_ALWAYS_INLINE size_t _compiled_format_bound(std::false_type, basic_compiled_format<MaxSlots> const&, Args const& C4_RESTRICT ...)
+{
+    return 0;
+}
+
+template<class CharOwningContainer, size_t MaxSlots, class... Args>
+void _formatrs_compiled(CharOwningContainer * C4_RESTRICT cont, size_t * C4_RESTRICT pos, basic_compiled_format<MaxSlots> const& cf, Args const& C4_RESTRICT ...args)
+{
+    const size_t last = cf.num_slots() - 1u;
+    for(size_t i = 0; i < last; ++i)
+    {
+        _rs_write(cont, pos, cf.literal(i));
+        const size_t arg = cf.slot(i).arg;
+        if(C4_LIKELY(arg < sizeof...(Args)))
+            _rs_write_nth(cont, pos, arg, args...);
+        else
+            _rs_write(cont, pos, cf.placeholder(i));
+    }
+    _rs_write(cont, pos, cf.literal(last));
+}
+
+template<class Fmt, size_t Pos, class CharOwningContainer>
+C4_ALWAYS_INLINE void _formatrs_ct(CharOwningContainer * C4_RESTRICT cont, size_t * C4_RESTRICT pos)
+{
+    using seg = _ct_fmt_seg<Fmt, Pos>;
+    if(seg::len > 0)
+        _rs_write(cont, pos, seg::get());
+}
+template<class Fmt, size_t Pos, class CharOwningContainer, class Arg, class... Args>
+C4_ALWAYS_INLINE void _formatrs_ct(CharOwningContainer * C4_RESTRICT cont, size_t * C4_RESTRICT pos, Arg const& C4_RESTRICT a, Args const& C4_RESTRICT ...more)
+{
+    using seg = _ct_fmt_seg<Fmt, Pos>;
+    if(seg::len > 0)
+        _rs_write(cont, pos, seg::get());
+    _rs_write(cont, pos, a);
+    _formatrs_ct<Fmt, seg::next>(cont, pos, more...);
+}
+
+} // namespace detail
+/// @endcond
+
+
+//-----------------------------------------------------------------------------
+
+/** like c4::cat(), but receives a container, and resizes it as needed to contain
+ * the result. The container is overwritten. To append to it, use the append
+ * overload. When every argument has a c4::max_chars bound, the container is
+ * first resized to that bound, so that the arguments are serialized only once.
+ * Otherwise, when an argument does not fit, the container is grown
+ * geometrically and the serialization resumes from that argument: the
+ * arguments already written are not serialized again.
+ * @see c4::cat() */
+template<class CharOwningContainer, class... Args>
+inline void catrs(CharOwningContainer * C4_RESTRICT cont, Args const& C4_RESTRICT ...args)
+{
+    size_t pos = 0;
+    detail::_reserve_chars(cont, pos, detail::_cat_bound(args...));
+    detail::_catrs(cont, &pos, args...);
+    cont->resize(pos);
+}
+
+/** like c4::cat(), but creates and returns a new container sized as needed to contain
+ * the result.
+ * @see c4::cat() */
+template<class CharOwningContainer, class... Args>
+inline CharOwningContainer catrs(Args const& C4_RESTRICT ...args)
+{
+    CharOwningContainer cont;
+    catrs(&cont, args...);
+    return cont;
+}
+
+/** like c4::cat(), but receives a container, and appends to it instead of
+ * overwriting it. The container is resized as needed to contain the result.
+ * @return the region newly appended to the original container
  * @see c4::cat()
  * @see c4::catrs() */
 template<class CharOwningContainer, class... Args>
 inline csubstr catrs(append_t, CharOwningContainer * C4_RESTRICT cont, Args const& C4_RESTRICT ...args)
 {
     const size_t pos = cont->size();
-retry:
-    substr buf = to_substr(*cont).sub(pos);
-    size_t ret = cat(buf, args...);
-    cont->resize(pos + ret);
-    if(ret > buf.len)
-        goto retry;
-    return to_csubstr(*cont).range(pos, cont->size());
+    size_t end = pos;
+    detail::_reserve_chars(cont, pos, detail::_cat_bound(args...));
+    detail::_catrs(cont, &end, args...);
+    cont->resize(end);
+    return to_csubstr(*cont).range(pos, end);
 }
 
 
@@ -774,12 +1742,10 @@ inline void catseprs(CharOwningContainer * C4_RESTRICT, Sep const& C4_RESTRICT)
 template<class CharOwningContainer, class Sep, class... Args>
 inline void catseprs(CharOwningContainer * C4_RESTRICT cont, Sep const& C4_RESTRICT sep, Args const& C4_RESTRICT ...args)
 {
-retry:
-    substr buf = to_substr(*cont);
-    size_t ret = catsep(buf, sep, args...);
-    cont->resize(ret);
-    if(ret > buf.len)
-        goto retry;
+    size_t pos = 0;
+    detail::_reserve_chars(cont, pos, detail::_catsep_bound(sep, args...));
+    detail::_catseprs(cont, &pos, sep, args...);
+    cont->resize(pos);
 }
 
 /** like c4::catsep(), but create a new container with the result.
@@ -811,13 +1777,11 @@ template<class CharOwningContainer, class Sep, class... Args>
 inline csubstr catseprs(append_t, CharOwningContainer * C4_RESTRICT cont, Sep const& C4_RESTRICT sep, Args const& C4_RESTRICT ...args)
 {
     const size_t pos = cont->size();
-retry:
-    substr buf = to_substr(*cont).sub(pos);
-    size_t ret = catsep(buf, sep, args...);
-    cont->resize(pos + ret);
-    if(ret > buf.len)
-        goto retry;
-    return to_csubstr(*cont).range(pos, cont->size());
+    size_t end = pos;
+    detail::_reserve_chars(cont, pos, detail::_catsep_bound(sep, args...));
+    detail::_catseprs(cont, &end, sep, args...);
+    cont->resize(end);
+    return to_csubstr(*cont).range(pos, end);
 }
 
 
@@ -830,12 +1794,10 @@ retry:
 template<class CharOwningContainer, class... Args>
 inline void formatrs(CharOwningContainer * C4_RESTRICT cont, csubstr fmt, Args const& C4_RESTRICT ...args)
 {
-retry:
-    substr buf = to_substr(*cont);
-    size_t ret = format(buf, fmt, args...);
-    cont->resize(ret);
-    if(ret > buf.len)
-        goto retry;
+    size_t pos = 0;
+    detail::_reserve_chars(cont, pos, detail::_format_bound(fmt, args...));
+    detail::_formatrs(cont, &pos, fmt, args...);
+    cont->resize(pos);
 }
 
 /** like c4::format(), but create a new container with the result.
@@ -857,12 +1819,494 @@ template<class CharOwningContainer, class... Args>
 inline csubstr formatrs(append_t, CharOwningContainer * C4_RESTRICT cont, csubstr fmt, Args const& C4_RESTRICT ...args)
 {
     const size_t pos = cont->size();
-retry:
-    substr buf = to_substr(*cont).sub(pos);
-    size_t ret = format(buf, fmt, args...);
-    cont->resize(pos + ret);
-    if(ret > buf.len)
-        goto retry;
+    size_t end = pos;
+    detail::_reserve_chars(cont, pos, detail::_format_bound(fmt, args...));
+    detail::_formatrs(cont, &end, fmt, args...);
+    cont->resize(end);
+    return to_csubstr(*cont).range(pos, end);
+}
+
+
+/** like c4::formatrs(), but using a compile-time format string
+ * created with C4_FMT(). The container is overwritten.
+ * @see C4_FMT() */
+template<class CharOwningContainer, class Fmt, class... Args>
+inline typename std::enable_if<is_ct_fmt<Fmt>::value, void>::type
+formatrs(CharOwningContainer * C4_RESTRICT cont, Fmt const& fmt, Args const& C4_RESTRICT ...args)
+{
+    static_assert(ct_fmt_num_args<Fmt>::value == sizeof...(Args), "the number of arguments must match the number of {} in the format string");
+    size_t pos = 0;
+    detail::_reserve_chars(cont, pos, detail::_format_bound(to_csubstr(fmt), args...));
+    detail::_formatrs_ct<Fmt, 0>(cont, &pos, args...);
+    cont->resize(pos);
+}
+
+/** like c4::formatrs(), but using a compile-time format string
+ * created with C4_FMT(), and creating a new container with the result.
+ * @return the requested container */
+template<class CharOwningContainer, class Fmt, class... Args>
+inline typename std::enable_if<is_ct_fmt<Fmt>::value, CharOwningContainer>::type
+formatrs(Fmt const& fmt, Args const& C4_RESTRICT ...args)
+{
+    CharOwningContainer cont;
+    formatrs(&cont, fmt, args...);
+    return cont;
+}
+
+/** like c4::formatrs(), but using a compile-time format string
+ * created with C4_FMT(), and appending to the container.
+ * @return the region newly appended to the original container */
+template<class CharOwningContainer, class Fmt, class... Args>
+inline typename std::enable_if<is_ct_fmt<Fmt>::value, csubstr>::type
+formatrs(append_t, CharOwningContainer * C4_RESTRICT cont, Fmt const& fmt, Args const& C4_RESTRICT ...args)
+{
+    static_assert(ct_fmt_num_args<Fmt>::value == sizeof...(Args), "the number of arguments must match the number of {} in the format string");
+    const size_t pos = cont->size();
+    size_t end = pos;
+    detail::_reserve_chars(cont, pos, detail::_format_bound(to_csubstr(fmt), args...));
+    detail::_formatrs_ct<Fmt, 0>(cont, &end, args...);
+    cont->resize(end);
+    return to_csubstr(*cont).range(pos, end);
+}
+
+
+/** like c4::formatrs(), but using a compiled format. The container is
+ * overwritten.
+ * @see c4::basic_compiled_format */
+template<class CharOwningContainer, size_t MaxSlots, class... Args>
+inline void formatrs(CharOwningContainer * C4_RESTRICT cont, basic_compiled_format<MaxSlots> const& cf, Args const& C4_RESTRICT ...args)
+{
+    size_t pos = 0;
+    detail::_reserve_chars(cont, pos, detail::_compiled_format_bound(detail::_all_have_max_chars<Args...>{}, cf, args...));
+    detail::_formatrs_compiled(cont, &pos, cf, args...);
+    cont->resize(pos);
+}
+
+/** like c4::formatrs(), but using a compiled format, and creating a
+ * new container with the result.
+ * @return the requested container */
+template<class CharOwningContainer, size_t MaxSlots, class... Args>
+inline CharOwningContainer formatrs(basic_compiled_format<MaxSlots> const& cf, Args const& C4_RESTRICT ...args)
+{
+    CharOwningContainer cont;
+    formatrs(&cont, cf, args...);
+    return cont;
+}
+
+/** like c4::formatrs(), but using a compiled format, and appending to
+ * the container.
+ * @return the region newly appended to the original container */
+template<class CharOwningContainer, size_t MaxSlots, class... Args>
+inline csubstr formatrs(append_t, CharOwningContainer * C4_RESTRICT cont, basic_compiled_format<MaxSlots> const& cf, Args const& C4_RESTRICT ...args)
+{
+    const size_t pos = cont->size();
+    size_t end = pos;
+    detail::_reserve_chars(cont, pos, detail::_compiled_format_bound(detail::_all_have_max_chars<Args...>{}, cf, args...));
+    detail::_formatrs_compiled(cont, &end, cf, args...);
+    cont->resize(end);
+    return to_csubstr(*cont).range(pos, end);
+}
+
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+// reading arrays of numbers
+
+/** the result of c4::parse_array() */
+struct parse_array_result
+{
+    /** the number of values written to the output span */
+    size_t count;
+    /** the offset in the source of the first field which could not
+     * be read, or csubstr::npos if every field was read */
+    size_t error;
+
+    C4_ALWAYS_INLINE bool ok() const noexcept { return error == csubstr::npos; }
+};
+
+namespace detail {
+
+/** read a field by finding its end first, then converting it.
+ * Used for the fields which the fast paths do not handle. */
+template<class T>
+const char* _parse_array_field_slow(const char *C4_RESTRICT str, const char *C4_RESTRICT end, char sep, T *C4_RESTRICT v)
+{
+    const void *pos = memchr(str, sep, static_cast<size_t>(end - str));
+    const char *fend = pos ? static_cast<const char*>(pos) : end;
+    if(C4_UNLIKELY(fend == str || ! atox(csubstr(str, static_cast<size_t>(fend - str)), v)))
+        return nullptr;
+    return fend;
+}
+
+/** read an integer at the start of [str,end), finding its end while
+ * converting it
+ * @return a pointer to the end of the integer, or nullptr on failure */
+template<class T>
+C4_ALWAYS_INLINE auto _parse_array_field(const char *C4_RESTRICT str, const char *C4_RESTRICT end, char sep, T *C4_RESTRICT v)
+    -> typename std::enable_if<std::is_integral<T>::value, const char*>::type
+{
+    using U = typename std::make_unsigned<T>::type;
+    const char *beg = str;
+    bool neg = false;
+    if C4_IF_CONSTEXPR (std::is_signed<T>::value)
+    {
+        if(str < end && *str == '-')
+        {
+            neg = true;
+            ++str;
+        }
+    }
+    if(C4_UNLIKELY(end - str > 1 && str[0] == '0' && (str[1] > '9' || str[1] < '0') && str[1] != sep))
+        return _parse_array_field_slow(beg, end, sep, v); // maybe 0x, 0b or 0o
+    U mag;
+    const char *ret = _read_dec_prefix(str, end, &mag);
+    if(C4_UNLIKELY(ret == str))
+        return nullptr; // no digits
+    *v = static_cast<T>(neg ? static_cast<U>(U(0) - mag) : mag);
+    return ret;
+}
+
+/** read a real at the start of [str,end), finding its end while
+ * converting it
+ * @return a pointer to the end of the number, or nullptr on failure */
+template<class T>
+C4_ALWAYS_INLINE auto _parse_array_field(const char *C4_RESTRICT str, const char *C4_RESTRICT end, char sep, T *C4_RESTRICT v)
+    -> typename std::enable_if<std::is_floating_point<T>::value, const char*>::type
+{
+    if(_is_hexa_start(str, end))
+        return _read_hexa(str, end, v);
+#if C4CORE_HAVE_FAST_FLOAT
+    C4_UNUSED(sep);
+    fast_float::from_chars_result result = fast_float::from_chars(str, end, *v);
+    return result.ec == std::errc() ? result.ptr : nullptr;
+#elif C4CORE_HAVE_STD_FROMCHARS
+    C4_UNUSED(sep);
+    std::from_chars_result result = std::from_chars(str, end, *v);
+    return result.ec == std::errc() ? result.ptr : nullptr;
+#else
+    C4_UNUSED(sep);
+    // scan_real() skips leading whitespace, which is not allowed here
+    if(C4_UNLIKELY(str == end || *str == ' ' || (*str >= '\t' && *str <= '\r')))
+        return nullptr;
+    const size_t len = detail::scan_real(csubstr(str, static_cast<size_t>(end - str)), v);
+    return len != csubstr::npos ? str + len : nullptr;
+#endif
+}
+
+/** the 16 bit real types, which are read as a double and then
+ * narrowed */
+template<class T>
+struct _is_array_real16
+{
+    enum : bool { value = std::is_same<T, half>::value || std::is_same<T, bfloat16>::value };
+};
+
+template<class T>
+C4_ALWAYS_INLINE auto _parse_array_field(const char *C4_RESTRICT str, const char *C4_RESTRICT end, char sep, T *C4_RESTRICT v)
+    -> typename std::enable_if<_is_array_real16<T>::value, const char*>::type
+{
+    double d;
+    const char *pos = _parse_array_field(str, end, sep, &d);
+    if(C4_LIKELY(pos != nullptr))
+        _narrow_read(csubstr(str, static_cast<size_t>(pos - str)), d, v);
+    return pos;
+}
+
+} // namespace detail
+
+/** read a list of numbers separated by @p sep into a span, eg
+ * `1,2,3`. Each field is converted in a single pass: the end of
+ * the field is found while it is converted. Integers are read eight
+ * digits at a time, and reals use the same backend as atof() and
+ * atod(), including hexadecimal reals such as those written by
+ * to_chars_array_hexa(). half and bfloat16 are read as double, and
+ * then rounded to the narrow type. The fields are read as with atox(): they must not have
+ * leading or trailing whitespace, and overflow is not detected.
+ *
+ * An empty source has no fields. Otherwise, every separator is
+ * followed by a field, so that eg `1,2,` has an empty (and
+ * therefore invalid) third field.
+ *
+ * @return the number of values read, and the offset of the first
+ * field which could not be read, if any. If the output span is too
+ * small, this is the offset of the first field which did not fit.
+ * The output elements after the ones read are not modified. */
+template<class T>
+parse_array_result parse_array(csubstr src, char sep, span<T> out)
+{
+    C4_STATIC_ASSERT(std::is_arithmetic<T>::value || detail::_is_array_real16<T>::value);
+    parse_array_result result = {0, csubstr::npos};
+    if(src.empty())
+        return result;
+    const char *C4_RESTRICT str = src.str;
+    const char *C4_RESTRICT end = src.str + src.len;
+    T *C4_RESTRICT vals = out.data();
+    for(size_t i = 0; ; ++i)
+    {
+        T val;
+        const char *pos;
+        if(C4_UNLIKELY(i >= out.size()
+                       || (pos = detail::_parse_array_field(str, end, sep, &val)) == nullptr
+                       || (pos < end && *pos != sep)))
+        {
+            result.count = i;
+            result.error = static_cast<size_t>(str - src.str);
+            return result;
+        }
+        vals[i] = val;
+        if(pos == end)
+        {
+            result.count = i + 1;
+            return result;
+        }
+        str = pos + 1;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+// writing arrays of numbers
+
+/** the result of c4::to_chars_array() */
+struct to_chars_array_result
+{
+    /** the total size required to write every value */
+    size_t required;
+    /** the number of values which were completely written */
+    size_t count;
+    /** the number of characters written for those values, ie the
+     * position where the first value which did not fit would start
+     * (with its separator) */
+    size_t pos;
+};
+
+namespace detail {
+
+/** integers which are written as numbers (ie not char or bool) */
+template<class T>
+struct _is_array_int
+{
+    enum : bool { value = std::is_integral<T>::value && ! std::is_same<T, char>::value && ! std::is_same<T, bool>::value };
+};
+
+/** write an integer: the digits are counted first, so that it is
+ * written only when it fits */
+template<class T>
+C4_ALWAYS_INLINE auto _write_array_elm(substr buf, T v) noexcept
+    -> typename std::enable_if<_is_array_int<T>::value, size_t>::type
+{
+    using U = typename std::make_unsigned<T>::type;
+    const bool neg = v < 0;
+    const U mag = neg ? static_cast<U>(U(0) - static_cast<U>(v)) : static_cast<U>(v);
+    const unsigned digits = digits_dec(mag);
+    const size_t len = neg + digits;
+    if(C4_LIKELY(len <= buf.len))
+    {
+        buf.str[0] = '-'; // overwritten by the digits if not negative
+        write_dec_unchecked(buf.sub(neg), mag, digits);
+    }
+    return len;
+}
+
+template<class T>
+C4_ALWAYS_INLINE auto _write_array_elm(substr buf, T const& v)
+    -> typename std::enable_if< ! _is_array_int<T>::value, size_t>::type
+{
+    return to_chars(buf, v);
+}
+
+/** size of a value which is not going to be written */
+template<class T>
+C4_ALWAYS_INLINE auto _array_elm_size(T v) noexcept
+    -> typename std::enable_if<_is_array_int<T>::value, size_t>::type
+{
+    using U = typename std::make_unsigned<T>::type;
+    const bool neg = v < 0;
+    return neg + digits_dec(neg ? static_cast<U>(U(0) - static_cast<U>(v)) : static_cast<U>(v));
+}
+
+template<class T>
+C4_ALWAYS_INLINE auto _array_elm_size(T const& v)
+    -> typename std::enable_if< ! _is_array_int<T>::value, size_t>::type
+{
+    return to_chars(substr{}, v);
+}
+
+/** how _to_chars_array() writes each value: with to_chars(), or
+ * with the integer writer for integers */
+struct _array_elm_writer
+{
+    template<class T>
+    static C4_ALWAYS_INLINE size_t write(substr buf, T const& v) { return _write_array_elm(buf, v); }
+    template<class T>
+    static C4_ALWAYS_INLINE size_t size(T const& v) { return _array_elm_size(v); }
+};
+
+/** how _to_chars_array() writes each value: reals in exact
+ * hexadecimal format */
+struct _array_elm_writer_hexa
+{
+    template<class T>
+    static C4_ALWAYS_INLINE size_t write(substr buf, T v) noexcept { return _write_hexa(buf, v, -1); }
+    template<class T>
+    static C4_ALWAYS_INLINE size_t size(T v) noexcept { return _write_hexa(substr{}, v, -1); }
+};
+
+template<class T, class Writer=_array_elm_writer>
+to_chars_array_result _to_chars_array(substr buf, T const* C4_RESTRICT vals, size_t num, csubstr sep, bool sep_first)
+{
+    to_chars_array_result result = {0, num, 0};
+    size_t pos = 0;
+    size_t i = 0;
+    // write while there is room
+    for( ; i < num; ++i)
+    {
+        size_t start = pos;
+        if(i || sep_first)
+        {
+            if(C4_UNLIKELY(pos + sep.len > buf.len))
+                break;
+            if(sep.len == 1) // the common case: avoid the memcpy() call
+                buf.str[pos] = sep.str[0];
+            else if(sep.len)
+                memcpy(buf.str + pos, sep.str, sep.len);
+            pos += sep.len;
+        }
+        const size_t ret = Writer::write(buf.sub(pos), vals[i]);
+        if(C4_UNLIKELY(ret > buf.len - pos))
+        {
+            pos = start;
+            break;
+        }
+        pos += ret;
+    }
+    result.pos = pos;
+    result.required = pos;
+    if(C4_UNLIKELY(i < num))
+    {
+        // then only count the size of the remaining values
+        result.count = i;
+        for( ; i < num; ++i)
+            result.required += ((i || sep_first) ? sep.len : 0u) + Writer::size(vals[i]);
+    }
+    return result;
+}
+
+template<class T, class Writer>
+to_chars_array_result _to_chars_array_resume(substr buf, cspan<T> vals, csubstr sep, to_chars_array_result prev)
+{
+    C4_ASSERT(prev.count <= vals.size());
+    C4_ASSERT(prev.pos <= buf.len);
+    to_chars_array_result ret = _to_chars_array<T, Writer>(buf.sub(prev.pos), vals.data() + prev.count, vals.size() - prev.count, sep, /*sep_first*/prev.count > 0);
+    ret.required += prev.pos;
+    ret.count += prev.count;
+    ret.pos += prev.pos;
+    return ret;
+}
+
+} // namespace detail
+
+/** write an array of values, separated by @p sep. Integers are
+ * written without any intermediate call to to_chars(): the digits
+ * are counted first and then written two at a time, directly into
+ * the buffer.
+ *
+ * When the buffer is too small, the values which fit are written,
+ * and the sizes of the remaining values are only counted (which for
+ * integers is done without writing them).
+ * @return the size required for the full array, the number of
+ * values written and the number of characters used for them. If
+ * the buffer was too small, the write can be resumed from the first
+ * value which did not fit with to_chars_array_resume().
+ * @see to_chars_arrayrs() */
+template<class T>
+to_chars_array_result to_chars_array(substr buf, cspan<T> vals, csubstr sep)
+{
+    return detail::_to_chars_array(buf, vals.data(), vals.size(), sep, /*sep_first*/false);
+}
+
+/** resume writing an array of values after a previous call to
+ * to_chars_array() was not able to write every value. @p buf must
+ * contain the characters previously written, and have its full
+ * size; @p prev is the result of the previous call.
+ * @return the result for the full array */
+template<class T>
+to_chars_array_result to_chars_array_resume(substr buf, cspan<T> vals, csubstr sep, to_chars_array_result prev)
+{
+    return detail::_to_chars_array_resume<T, detail::_array_elm_writer>(buf, vals, sep, prev);
+}
+
+/** write an array of reals separated by @p sep, in hexadecimal
+ * format, like printf's %a. This is exact (including the payload of
+ * nans) and much faster than the shortest decimal format, so it is
+ * meant for persisting reals in bulk. The result reads back to the
+ * same values with parse_array(), and the buffer is handled as in
+ * to_chars_array().
+ * @see detail::_write_hexa() */
+template<class T>
+to_chars_array_result to_chars_array_hexa(substr buf, cspan<T> vals, csubstr sep)
+{
+    C4_STATIC_ASSERT(std::is_floating_point<T>::value);
+    return detail::_to_chars_array<T, detail::_array_elm_writer_hexa>(buf, vals.data(), vals.size(), sep, /*sep_first*/false);
+}
+
+/** resume writing an array of reals after a previous call to
+ * to_chars_array_hexa(), as in to_chars_array_resume() */
+template<class T>
+to_chars_array_result to_chars_array_hexa_resume(substr buf, cspan<T> vals, csubstr sep, to_chars_array_result prev)
+{
+    C4_STATIC_ASSERT(std::is_floating_point<T>::value);
+    return detail::_to_chars_array_resume<T, detail::_array_elm_writer_hexa>(buf, vals, sep, prev);
+}
+
+/** like to_chars_array(), but receives a container, and resizes it
+ * as needed to contain the result. The container is overwritten. At
+ * most one resize is needed, as the first call to to_chars_array()
+ * gives the exact size, and the write is then resumed from the
+ * first value which did not fit.
+ * @see to_chars_array() */
+template<class CharOwningContainer, class T>
+inline void to_chars_arrayrs(CharOwningContainer * C4_RESTRICT cont, cspan<T> vals, csubstr sep)
+{
+    to_chars_array_result ret = to_chars_array(to_substr(*cont), vals, sep);
+    if(C4_UNLIKELY(ret.count < vals.size()))
+    {
+        cont->resize(ret.required);
+        ret = to_chars_array_resume(to_substr(*cont), vals, sep, ret);
+        C4_ASSERT(ret.count == vals.size());
+    }
+    cont->resize(ret.required);
+}
+
+/** like to_chars_array(), but create a new container with the result.
+ * @return the requested container */
+template<class CharOwningContainer, class T>
+inline CharOwningContainer to_chars_arrayrs(cspan<T> vals, csubstr sep)
+{
+    CharOwningContainer cont;
+    to_chars_arrayrs(&cont, vals, sep);
+    return cont;
+}
+
+/** like to_chars_array(), but receives a container, and appends the
+ * values, resizing the container as needed to contain the
+ * result.
+ * @return the region newly appended to the original container */
+template<class CharOwningContainer, class T>
+inline csubstr to_chars_arrayrs(append_t, CharOwningContainer * C4_RESTRICT cont, cspan<T> vals, csubstr sep)
+{
+    const size_t pos = cont->size();
+    to_chars_array_result ret = to_chars_array(to_substr(*cont).sub(pos), vals, sep);
+    if(C4_UNLIKELY(ret.count < vals.size()))
+    {
+        cont->resize(pos + ret.required);
+        ret = to_chars_array_resume(to_substr(*cont).sub(pos), vals, sep, ret);
+        C4_ASSERT(ret.count == vals.size());
+    }
+    cont->resize(pos + ret.required);
     return to_csubstr(*cont).range(pos, cont->size());
 }
 
@@ -0,0 +1,131 @@
+#ifndef _C4_FORMAT_ARGS_HPP_
+#define _C4_FORMAT_ARGS_HPP_
+
+/** @file format_args.hpp type-erased arguments for c4::vcat(),
+ * c4::vcatsep(), c4::vformat() and their dump versions. This header
+ * is kept light so that c4/dump.hpp can use it without pulling in
+ * c4/format.hpp.
+ * @see c4/format.hpp */
+
+#include "c4/substr.hpp"
+
+namespace c4 {
+
+/** a type-erased reference to an argument, together with the
+ * function to serialize it. Strings are stored directly, without a
+ * serializing function. The argument must outlive this object. */
+struct format_arg
+{
+    using thunk_type = size_t (*)(substr buf, void const* C4_RESTRICT arg);
+
+    void const* ptr;   ///< the argument, or the string characters if thunk is null
+    size_t      len;   ///< the length of the string, when thunk is null
+    thunk_type  thunk; ///< the function to serialize the argument, or null for strings
+
+    /** true if this argument is a string, which can be copied without serializing */
+    C4_ALWAYS_INLINE bool is_str() const noexcept { return thunk == nullptr; }
+    /** the string characters, if this is a string */
+    C4_ALWAYS_INLINE csubstr str() const noexcept { C4_ASSERT(is_str()); return csubstr(static_cast<const char*>(ptr), len); }
+    /** serialize the argument into the buffer, with the semantics of to_chars() */
+    C4_ALWAYS_INLINE size_t to_chars(substr buf) const
+    {
+        if(thunk)
+            return thunk(buf, ptr);
+        // same as c4::to_chars(substr, csubstr), which is not visible here
+        const size_t num = buf.len < len ? buf.len : len;
+        if(num)
+            memcpy(buf.str, ptr, num);
+        return len;
+    }
+};
+
+/// @cond dev
+namespace detail {
+template<class T>
+size_t _format_arg_thunk(substr buf, void const* C4_RESTRICT arg)
+{
+    return to_chars(buf, *static_cast<T const*>(arg));
+}
+} // namespace detail
+/// @endcond
+
+/** wrap an argument into a c4::format_arg */
+template<class T>
+C4_ALWAYS_INLINE format_arg make_format_arg(T const& C4_RESTRICT v) noexcept
+{
+    return format_arg{&v, 0u, &detail::_format_arg_thunk<T>};
+}
+C4_ALWAYS_INLINE format_arg make_format_arg(csubstr v) noexcept
+{
+    return format_arg{v.str, v.len, nullptr};
+}
+C4_ALWAYS_INLINE format_arg make_format_arg(substr v) noexcept
+{
+    return format_arg{v.str, v.len, nullptr};
+}
+template<size_t N>
+C4_ALWAYS_INLINE format_arg make_format_arg(const char (&v)[N]) noexcept
+{
+    return make_format_arg(csubstr(v));
+}
+C4_ALWAYS_INLINE format_arg make_format_arg(const char* v) noexcept
+{
+    return make_format_arg(to_csubstr(v));
+}
+
+
+/** a non-owning view of an array of c4::format_arg */
+struct format_args
+{
+    format_arg const* args;
+    size_t num;
+
+    format_args() noexcept : args(nullptr), num(0) {}
+    format_args(format_arg const* args_, size_t num_) noexcept : args(args_), num(num_) {}
+    template<size_t N>
+    format_args(format_arg const (&args_)[N]) noexcept : args(args_), num(N) {}
+
+    C4_ALWAYS_INLINE size_t size() const noexcept { return num; }
+    C4_ALWAYS_INLINE format_arg const& operator[] (size_t i) const noexcept { C4_ASSERT(i < num); return args[i]; }
+};
+
+/** the storage for the type-erased arguments, as returned by
+ * c4::make_format_args(). It is meant to be used as a temporary in
+ * the call, as it refers to the arguments. */
+template<size_t N>
+struct format_arg_store
+{
+    format_arg args[N];
+    C4_ALWAYS_INLINE operator format_args () const noexcept { return format_args(args, N); }
+};
+/// @cond dev
+template<>
+struct format_arg_store<0>
+{
+    C4_ALWAYS_INLINE operator format_args () const noexcept { return format_args(); }
+};
+/// @endcond
+
+/** pack the arguments into an array of type-erased arguments, to be
+ * given to c4::vcat(), c4::vcatsep() or c4::vformat(). The arguments
+ * must outlive the returned object. */
+template<class... Args>
+C4_ALWAYS_INLINE format_arg_store<sizeof...(Args)> make_format_args(Args const& C4_RESTRICT ...args) noexcept
+{
+    return format_arg_store<sizeof...(Args)>{{make_format_arg(args)...}};
+}
+inline format_arg_store<0> make_format_args() noexcept
+{
+    return format_arg_store<0>{};
+}
+
+
+/** serialize a type-erased argument */
+C4_ALWAYS_INLINE size_t to_chars(substr buf, format_arg const& C4_RESTRICT arg)
+{
+    return arg.to_chars(buf);
+}
+
+} // namespace c4
+
+#endif /* _C4_FORMAT_ARGS_HPP_ */
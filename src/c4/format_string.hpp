@@ -0,0 +1,257 @@
+#ifndef _C4_FORMAT_STRING_HPP_
+#define _C4_FORMAT_STRING_HPP_
+
+/** @file format_string.hpp format strings which are parsed ahead of
+ * their use, so that the placeholders are not searched on every call
+ * of c4::format(), c4::formatrs(), c4::format_dump() or c4::unformat().
+ * @see C4_FMT() */
+
+#include "c4/substr.hpp"
+
+namespace c4 {
+
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+/** base class of the types created by C4_FMT(). Each such type
+ * provides the format string through the static constexpr functions
+ * `str_()` and `len_()`, so that the format string is available at
+ * compile time from the type alone.
+ * @see C4_FMT() */
+struct ct_fmt_base {};
+
+/** true if T is a compile-time format string, as created by C4_FMT() */
+template<class T>
+struct is_ct_fmt : public std::is_base_of<ct_fmt_base, T> {};
+
+
+/** create a compile-time format string from a string literal. The
+ * positions of the {} placeholders and of the literal segments
+ * between them are computed at compile time, so that formatting with
+ * it becomes a flat sequence of copies of the literal segments and of
+ * calls to to_chars(). Also, a mismatch between the number of
+ * placeholders and the number of arguments is a compile error.
+ *
+ * @code{.cpp}
+ * c4::format(buf, C4_FMT("the {} drank {} {}"), "partier", 5, "beers");
+ * c4::formatrs(&str, C4_FMT("a={} b={}"), a, b);
+ * c4::unformat(buf, C4_FMT("a={} b={}"), a, b);
+ * @endcode
+ *
+ * @note the result is an object of an unnamed type; every use of the
+ * macro creates a different type. To reuse a format string, store the
+ * object with `auto`. */
+#define C4_FMT(str_literal)                                             \
+    ([]{                                                                \
+        struct _c4_ct_fmt : public ::c4::ct_fmt_base                    \
+        {                                                               \
+            static_assert(std::is_array<std::remove_reference<decltype(str_literal)>::type>::value, \
+                          "C4_FMT() requires a string literal");        \
+            static constexpr const char* str_() noexcept { return str_literal; } \
+            static constexpr size_t len_() noexcept { return sizeof(str_literal) - 1u; } \
+        };                                                              \
+        return _c4_ct_fmt{};                                            \
+    }())
+
+
+/// @cond dev
+namespace detail {
+
+// these are C++11 constexpr functions, so they have to be a single
+// return statement. The search for {} splits the range in halves so
+// that the recursion depth is logarithmic in the length of the
+// format string.
+
+constexpr size_t _ct_fmt_find(const char *s, size_t len, size_t first, size_t last) noexcept;
+
+constexpr size_t _ct_fmt_find_right(size_t found_left, const char *s, size_t len, size_t mid, size_t last) noexcept
+{
+    return found_left != csubstr::npos ? found_left : _ct_fmt_find(s, len, mid, last);
+}
+
+/** find the position of the first {} starting in [first,last[ */
+constexpr size_t _ct_fmt_find(const char *s, size_t len, size_t first, size_t last) noexcept
+{
+    return last <= first ?
+        (size_t)csubstr::npos
+        : (last - first == 1u ?
+           ((first + 1u < len && s[first] == '{' && s[first + 1u] == '}') ? first : (size_t)csubstr::npos)
+           : _ct_fmt_find_right(_ct_fmt_find(s, len, first, first + (last - first) / 2u), s, len, first + (last - first) / 2u, last));
+}
+
+constexpr size_t _ct_fmt_count(const char *s, size_t len, size_t first) noexcept;
+
+constexpr size_t _ct_fmt_count_from(size_t found, const char *s, size_t len) noexcept
+{
+    return found == csubstr::npos ? 0u : 1u + _ct_fmt_count(s, len, found + 2u);
+}
+
+/** count the {} placeholders starting at first */
+constexpr size_t _ct_fmt_count(const char *s, size_t len, size_t first) noexcept
+{
+    return _ct_fmt_count_from(_ct_fmt_find(s, len, first, len), s, len);
+}
+
+/** the literal segment of the format string Fmt which starts at
+ * Pos: [begin,end[ is the literal, and next is the position after
+ * the {} placeholder which ends it. When there are no more
+ * placeholders, end is the length of the format string. */
+template<class Fmt, size_t Pos>
+struct _ct_fmt_seg
+{
+    enum : size_t {
+        found = _ct_fmt_find(Fmt::str_(), Fmt::len_(), Pos, Fmt::len_()),
+        begin = Pos,
+        end = (size_t)found != (size_t)csubstr::npos ? (size_t)found : Fmt::len_(),
+        len = (size_t)end - (size_t)begin,
+        next = (size_t)end + 2u,
+    };
+    static C4_ALWAYS_INLINE csubstr get() noexcept { return csubstr(Fmt::str_() + Pos, (size_t)len); }
+};
+
+} // namespace detail
+/// @endcond
+
+
+/** the number of {} placeholders in the compile-time format string Fmt */
+template<class Fmt>
+struct ct_fmt_num_args
+{
+    static_assert(is_ct_fmt<Fmt>::value, "Fmt must be created with C4_FMT()");
+    enum : size_t { value = detail::_ct_fmt_count(Fmt::str_(), Fmt::len_(), 0u) };
+};
+
+/** the full compile-time format string as a csubstr */
+template<class Fmt>
+C4_ALWAYS_INLINE typename std::enable_if<is_ct_fmt<Fmt>::value, csubstr>::type
+to_csubstr(Fmt const&) noexcept
+{
+    return csubstr(Fmt::str_(), Fmt::len_());
+}
+
+
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+/** a slot of a compiled format: a literal segment of the format
+ * string, followed by a reference to an argument. The last slot of a
+ * compiled format has no argument. */
+struct compiled_format_slot
+{
+    size_t lit_pos; ///< the position of the literal segment in the format string
+    size_t lit_len; ///< the length of the literal segment
+    size_t arg;     ///< the index of the argument following the literal, or npos for the last slot
+};
+
+/// @cond dev
+namespace detail {
+/** parse a runtime format string into slots.
+ * @return the number of slots, or npos if the format string
+ *   needs more than @p max_slots slots. */
+C4CORE_EXPORT size_t _compile_format(csubstr fmt, compiled_format_slot *C4_RESTRICT slots, size_t max_slots, size_t *C4_RESTRICT num_args) noexcept;
+} // namespace detail
+/// @endcond
+
+
+/** a format string which is parsed at runtime, but only once, into
+ * literal segments and argument slots. It can then be applied many
+ * times with c4::format(), c4::format_sub(), c4::formatrs() and
+ * c4::format_dump(), without searching again for the placeholders.
+ * This is useful for format strings which are not known at compile
+ * time (eg, loaded from configuration); for format strings known at
+ * compile time, C4_FMT() is faster.
+ *
+ * Besides the sequential placeholder {}, the format string may use
+ * positional placeholders {0}, {1}, ... which refer to the argument
+ * with that index; an argument may be referred to more than once, and
+ * the sequential placeholders are numbered independently of the
+ * positional ones:
+ *
+ * @code{.cpp}
+ * c4::compiled_format cf("{1} {0} {1}, {} {}");
+ * c4::format(buf, cf, "a", "b"); // b a b, a b
+ * @endcode
+ *
+ * As with the runtime c4::format(), surplus arguments are ignored,
+ * and a placeholder whose argument is missing is written verbatim.
+ *
+ * @note the format string is not copied, so it must outlive this
+ * object.
+ * @tparam MaxSlots the maximum number of slots, which is the number
+ *   of placeholders plus one. */
+template<size_t MaxSlots>
+class basic_compiled_format
+{
+    static_assert(MaxSlots > 0, "at least one slot is needed");
+
+    csubstr m_fmt;
+    size_t m_num_slots;
+    size_t m_num_args;
+    compiled_format_slot m_slots[MaxSlots];
+
+public:
+
+    enum : size_t { max_slots = MaxSlots };
+
+    basic_compiled_format() noexcept : m_fmt(), m_num_slots(1), m_num_args(0), m_slots()
+    {
+        m_slots[0].arg = csubstr::npos;
+    }
+
+    /** compile the format string, failing with an error when it has
+     * too many placeholders.
+     * @see compile() for a version which does not error out */
+    explicit basic_compiled_format(csubstr fmt) : basic_compiled_format()
+    {
+        C4_CHECK_MSG(compile(fmt), "too many placeholders in format string: max=%zu", (size_t)MaxSlots - 1u);
+    }
+
+    /** compile the format string.
+     * @return false if the format string has more than MaxSlots-1
+     *   placeholders; the object is left empty in that case. */
+    bool compile(csubstr fmt) noexcept
+    {
+        size_t num = detail::_compile_format(fmt, m_slots, MaxSlots, &m_num_args);
+        if(C4_UNLIKELY(num == csubstr::npos))
+        {
+            m_fmt = {};
+            m_num_slots = 1;
+            m_num_args = 0;
+            m_slots[0] = {0, 0, csubstr::npos};
+            return false;
+        }
+        m_fmt = fmt;
+        m_num_slots = num;
+        return true;
+    }
+
+    /** the format string */
+    csubstr fmt() const noexcept { return m_fmt; }
+    /** the number of slots: this is the number of placeholders plus one */
+    size_t num_slots() const noexcept { return m_num_slots; }
+    /** the number of arguments needed by the placeholders: one more
+     * than the highest argument index */
+    size_t num_args() const noexcept { return m_num_args; }
+
+    compiled_format_slot const& slot(size_t i) const noexcept { C4_ASSERT(i < m_num_slots); return m_slots[i]; }
+    /** the literal segment of the i-th slot */
+    csubstr literal(size_t i) const noexcept { C4_ASSERT(i < m_num_slots); return csubstr(m_fmt.str + m_slots[i].lit_pos, m_slots[i].lit_len); }
+    /** the placeholder text of the i-th slot, eg {} or {1} */
+    csubstr placeholder(size_t i) const noexcept
+    {
+        C4_ASSERT(i + 1u < m_num_slots);
+        const size_t first = m_slots[i].lit_pos + m_slots[i].lit_len;
+        return m_fmt.range(first, m_slots[i + 1u].lit_pos);
+    }
+};
+
+/** a compiled format with room for 31 placeholders */
+using compiled_format = basic_compiled_format<32>;
+
+} // namespace c4
+
+#endif /* _C4_FORMAT_STRING_HPP_ */
@@ -0,0 +1,309 @@
+#ifndef _C4_SCANNER_HPP_
+#define _C4_SCANNER_HPP_
+
+/** @file scanner.hpp a cursor to read values and tokens sequentially
+ * from a string */
+
+#include "c4/charconv.hpp"
+
+namespace c4 {
+
+/** a cursor over a string, which reads values and tokens from it
+ * sequentially. Each operation starts at the position of the cursor,
+ * and advances the cursor past what it read.
+ *
+ * When an operation fails, the scanner enters the failed state: the
+ * cursor stays at the position where the failing operation started,
+ * and every later operation does nothing. So, like the state of an
+ * iostream, a sequence of operations can be checked only once, at
+ * the end:
+ *
+ * @code{.cpp}
+ * c4::scanner sc("GET /index.html HTTP/1.1\r\n");
+ * csubstr method = sc.read_until(' ');
+ * csubstr path = sc.skip(' ').read_until(' ');
+ * int major = 0, minor = 0;
+ * sc.skip(' ').expect("HTTP/").read(&major).expect('.').read(&minor).expect("\r\n");
+ * if(!sc)
+ *     error(sc.pos());
+ * @endcode
+ *
+ * @note the scanner does not copy the string, so it must outlive the
+ * scanner and the tokens read from it. */
+class scanner
+{
+    const char *m_str;
+    size_t m_len;
+    size_t m_pos;
+    bool m_ok;
+
+public:
+
+    scanner() noexcept : m_str(nullptr), m_len(0), m_pos(0), m_ok(true) {}
+    explicit scanner(csubstr s) noexcept : m_str(s.str), m_len(s.len), m_pos(0), m_ok(true) {}
+
+public:
+
+    /** @name state */
+    /** @{ */
+
+    /** true if no operation has failed */
+    C4_ALWAYS_INLINE bool ok() const noexcept { return m_ok; }
+    /** true if no operation has failed */
+    C4_ALWAYS_INLINE explicit operator bool() const noexcept { return m_ok; }
+    /** put the scanner in the failed state */
+    C4_ALWAYS_INLINE void fail() noexcept { m_ok = false; }
+
+    /** the position of the cursor. After a failure, this is the
+     * position where the failing operation started. */
+    C4_ALWAYS_INLINE size_t pos() const noexcept { return m_pos; }
+    /** the whole string */
+    C4_ALWAYS_INLINE csubstr buf() const noexcept { return csubstr(m_str, m_len); }
+    /** the part of the string which was not read yet */
+    C4_ALWAYS_INLINE csubstr rest() const noexcept { return csubstr(m_str + m_pos, m_len - m_pos); }
+    /** true if the whole string was read */
+    C4_ALWAYS_INLINE bool at_end() const noexcept { return m_pos == m_len; }
+    /** the character at the cursor, or '\0' at the end of the string */
+    C4_ALWAYS_INLINE char peek() const noexcept { return m_pos < m_len ? m_str[m_pos] : '\0'; }
+
+    /** @} */
+
+public:
+
+    /** @name values */
+    /** @{ */
+
+    /** read a value, skipping leading whitespace. Numbers are read
+     * with the same kernels as from_chars_first(), but they end at the
+     * first character which is not part of the number, so they need
+     * not be followed by a delimiter: eg, `1.1` can be read as an
+     * integer, a dot, and another integer, and `1.5x` as a real and
+     * an `x`. Integers out of the range of the type fail. Other types
+     * are read with from_chars_first(). To read strings, use
+     * read_until() or read_quoted(). */
+    template<class T>
+    C4_ALWAYS_INLINE scanner& read(T *C4_RESTRICT v)
+    {
+        C4_STATIC_ASSERT_MSG((!std::is_same<T, csubstr>::value && !std::is_same<T, substr>::value),
+                             "use read_until() or read_quoted() to read strings");
+        if(C4_LIKELY(m_ok))
+        {
+            const size_t num = _read(v, _read_kind<T>{});
+            if(C4_LIKELY(num != csubstr::npos))
+                m_pos += num;
+            else
+                m_ok = false;
+        }
+        return *this;
+    }
+
+    /** read a value, returning it. On failure, a value-initialized T
+     * is returned.
+     * @see read(T*) */
+    template<class T>
+    C4_ALWAYS_INLINE T read()
+    {
+        T v = {};
+        read(&v);
+        return v;
+    }
+
+    /** @} */
+
+public:
+
+    /** @name tokens */
+    /** @{ */
+
+    /** skip any number of consecutive occurrences of the character */
+    C4_ALWAYS_INLINE scanner& skip(char c) noexcept
+    {
+        if(C4_LIKELY(m_ok))
+            while(m_pos < m_len && m_str[m_pos] == c)
+                ++m_pos;
+        return *this;
+    }
+
+    /** skip any number of consecutive characters belonging to the charset */
+    C4_ALWAYS_INLINE scanner& skip(csubstr charset) noexcept
+    {
+        if(C4_LIKELY(m_ok))
+            while(m_pos < m_len && charset.len && memchr(charset.str, m_str[m_pos], charset.len) != nullptr)
+                ++m_pos;
+        return *this;
+    }
+
+    /** skip spaces, tabs and newlines */
+    C4_ALWAYS_INLINE scanner& skip_ws() noexcept
+    {
+        if(C4_LIKELY(m_ok))
+            while(m_pos < m_len && (m_str[m_pos] == ' ' || m_str[m_pos] == '\t' || m_str[m_pos] == '\n' || m_str[m_pos] == '\r'))
+                ++m_pos;
+        return *this;
+    }
+
+    /** read the character, failing if it is not at the cursor */
+    C4_ALWAYS_INLINE scanner& expect(char c) noexcept
+    {
+        if(C4_LIKELY(m_ok))
+        {
+            if(C4_LIKELY(m_pos < m_len && m_str[m_pos] == c))
+                ++m_pos;
+            else
+                m_ok = false;
+        }
+        return *this;
+    }
+
+    /** read the literal, failing if it is not at the cursor */
+    C4_ALWAYS_INLINE scanner& expect(csubstr lit) noexcept
+    {
+        if(C4_LIKELY(m_ok))
+        {
+            if(C4_LIKELY(m_len - m_pos >= lit.len && (lit.len == 0 || memcmp(m_str + m_pos, lit.str, lit.len) == 0)))
+                m_pos += lit.len;
+            else
+                m_ok = false;
+        }
+        return *this;
+    }
+
+    /** read the characters up to the first occurrence of @p c, which
+     * is not read: the cursor is left at it. Fails if @p c is not
+     * found. */
+    C4_ALWAYS_INLINE scanner& read_until(char c, csubstr *C4_RESTRICT v) noexcept
+    {
+        if(C4_LIKELY(m_ok))
+        {
+            const void *found = m_pos < m_len ? memchr(m_str + m_pos, c, m_len - m_pos) : nullptr;
+            if(C4_LIKELY(found != nullptr))
+            {
+                const size_t end = static_cast<size_t>(static_cast<const char*>(found) - m_str);
+                *v = csubstr(m_str + m_pos, end - m_pos);
+                m_pos = end;
+            }
+            else
+            {
+                m_ok = false;
+            }
+        }
+        return *this;
+    }
+
+    /** read the characters up to the first occurrence of @p c,
+     * returning them. On failure, an empty string is returned.
+     * @see read_until(char, csubstr*) */
+    C4_ALWAYS_INLINE csubstr read_until(char c) noexcept
+    {
+        csubstr v = {};
+        read_until(c, &v);
+        return v;
+    }
+
+    /** read a string delimited by the quote character @p q. The
+     * opening quote must be at the cursor; a quote preceded by an odd
+     * number of backslashes does not close the string. The cursor is
+     * left after the closing quote.
+     * @param v [out] receives the characters between the quotes. No
+     *   unescaping is done. */
+    C4_ALWAYS_INLINE scanner& read_quoted(csubstr *C4_RESTRICT v, char q='"') noexcept
+    {
+        if(C4_LIKELY(m_ok))
+        {
+            if(C4_LIKELY(m_pos < m_len && m_str[m_pos] == q))
+            {
+                const size_t first = m_pos + 1;
+                size_t pos = first;
+                while(pos < m_len)
+                {
+                    const void *found = memchr(m_str + pos, q, m_len - pos);
+                    if(!found)
+                        break;
+                    const size_t end = static_cast<size_t>(static_cast<const char*>(found) - m_str);
+                    size_t num_backslashes = 0;
+                    while(end - num_backslashes > first && m_str[end - num_backslashes - 1] == '\\')
+                        ++num_backslashes;
+                    if((num_backslashes & 1u) == 0)
+                    {
+                        *v = csubstr(m_str + first, end - first);
+                        m_pos = end + 1;
+                        return *this;
+                    }
+                    pos = end + 1;
+                }
+            }
+            m_ok = false;
+        }
+        return *this;
+    }
+
+    /** read a string delimited by the quote character @p q, returning
+     * the characters between the quotes. On failure, an empty string
+     * is returned.
+     * @see read_quoted(csubstr*, char) */
+    C4_ALWAYS_INLINE csubstr read_quoted(char q='"') noexcept
+    {
+        csubstr v = {};
+        read_quoted(&v, q);
+        return v;
+    }
+
+    /** @} */
+
+private:
+
+    enum : int { _read_other, _read_int, _read_real, _read_real16 };
+
+    template<class T>
+    struct _read_kind : public std::integral_constant<int,
+        (std::is_same<T, float>::value || std::is_same<T, double>::value) ? _read_real :
+        (std::is_same<T, half>::value || std::is_same<T, bfloat16>::value) ? _read_real16 :
+        (detail::is_int<T>::value && !std::is_same<T, bool>::value && !std::is_same<T, char>::value) ? _read_int :
+        _read_other> {};
+
+    template<class T>
+    C4_ALWAYS_INLINE size_t _read(T *C4_RESTRICT v, std::integral_constant<int, _read_int>) noexcept
+    {
+        const char *C4_RESTRICT end = m_str + m_len;
+        const char *s = detail::_skip_first_space(m_str + m_pos, end);
+        const errc err = detail::_read_int_prefix<T, detail::is_sint<T>::value, true>(s, end, v);
+        if(C4_UNLIKELY(err != errc::ok))
+            return csubstr::npos;
+        return static_cast<size_t>(s - (m_str + m_pos));
+    }
+
+    template<class T>
+    C4_ALWAYS_INLINE size_t _read(T *C4_RESTRICT v, std::integral_constant<int, _read_real>) noexcept
+    {
+        const char *C4_RESTRICT end = m_str + m_len;
+        const char *s = detail::_skip_first_space(m_str + m_pos, end);
+        const errc err = detail::_read_real_prefix(s, end, v);
+        if(C4_UNLIKELY(err != errc::ok))
+            return csubstr::npos;
+        return static_cast<size_t>(s - (m_str + m_pos));
+    }
+
+    template<class T>
+    C4_ALWAYS_INLINE size_t _read(T *C4_RESTRICT v, std::integral_constant<int, _read_real16>) noexcept
+    {
+        const char *C4_RESTRICT end = m_str + m_len;
+        const char *C4_RESTRICT start = detail::_skip_first_space(m_str + m_pos, end);
+        const char *s = start;
+        double d;
+        const errc err = detail::_read_real_prefix(s, end, &d);
+        if(C4_UNLIKELY(err != errc::ok))
+            return csubstr::npos;
+        detail::_narrow_read(csubstr(start, static_cast<size_t>(s - start)), d, v);
+        return static_cast<size_t>(s - (m_str + m_pos));
+    }
+
+    template<class T>
+    C4_ALWAYS_INLINE size_t _read(T *C4_RESTRICT v, std::integral_constant<int, _read_other>)
+    {
+        return from_chars_first(rest(), v);
+    }
+};
+
+} // namespace c4
+
+#endif /* _C4_SCANNER_HPP_ */
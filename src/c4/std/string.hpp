@@ -54,6 +54,12 @@ inline size_t to_chars(c4::substr buf, std::string const& s)
     return s.size(); // return the number of needed chars
 }
 
+template<>
+struct max_chars<std::string>
+{
+    static size_t bound(std::string const& s) noexcept { return s.size(); }
+};
+
 /** copy a string view to an existing std::string */
 inline bool from_chars(c4::csubstr buf, std::string * s)
 {
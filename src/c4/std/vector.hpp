@@ -61,6 +61,12 @@ inline size_t to_chars(c4::substr buf, std::vector<char, Alloc> const& s)
     return s.size(); // return the number of needed chars
 }
 
+template<class Alloc>
+struct max_chars<std::vector<char, Alloc>>
+{
+    static size_t bound(std::vector<char, Alloc> const& s) noexcept { return s.size(); }
+};
+
 /** copy a string view to an existing std::vector<char> */
 template<class Alloc>
 inline bool from_chars(c4::csubstr buf, std::vector<char, Alloc> * s)
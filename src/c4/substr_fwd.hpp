@@ -9,6 +9,7 @@ namespace c4 {
 template<class C> struct basic_substring;
 using csubstr = C4CORE_EXPORT basic_substring<const char>;
 using substr = C4CORE_EXPORT basic_substring<char>;
+template<class T, class Enable=void> struct max_chars; // see charconv.hpp
 #endif // !DOXYGEN
 
 } // namespace c4
@@ -17,6 +17,7 @@
 #endif
 
 #include <c4/test.hpp>
+#include <cmath>
 
 namespace c4 {
 
@@ -191,6 +192,65 @@ TEST_CASE("utoa.prefixed_number_on_empty_buffer")
 }
 
 
+TEST_CASE_TEMPLATE("digits_dec", T, uint8_t, int8_t, uint16_t, int16_t, uint32_t, int32_t, uint64_t, int64_t)
+{
+    char bufc[64];
+    substr buf = bufc;
+    auto check = [&](T val, unsigned expected_digits){
+        std::string expected = std::to_string((unsigned long long)val);
+        INFO("val=" << expected);
+        CHECK_EQ(digits_dec(val), expected_digits);
+        CHECK_EQ(expected.size(), expected_digits);
+        buf.fill('?');
+        size_t ret = write_dec(buf, val);
+        CHECK_EQ(ret, expected_digits);
+        CHECK_EQ(buf.first(ret), to_csubstr(expected));
+        CHECK_EQ(buf.sub(ret).first_not_of('?'), csubstr::npos);
+        // too-small buffers get the least significant digits, and
+        // must not be written past their end
+        buf.fill('?');
+        CHECK_EQ(write_dec(buf.first(ret - 1), val), expected_digits);
+        CHECK_EQ(buf.first(ret - 1), to_csubstr(expected).sub(1));
+        CHECK_EQ(buf.sub(ret - 1).first_not_of('?'), csubstr::npos);
+    };
+    check(T(0), 1u);
+    unsigned num_digits = 1;
+    for(uint64_t p = 10; p <= uint64_t(std::numeric_limits<T>::max()); p *= 10u, ++num_digits)
+    {
+        check(T(p - 1u), num_digits);
+        check(T(p), num_digits + 1u);
+        check(T(p + 1u), num_digits + 1u);
+        if(p > std::numeric_limits<uint64_t>::max() / 10u)
+            break;
+    }
+    check(std::numeric_limits<T>::max(), (unsigned)std::to_string((unsigned long long)std::numeric_limits<T>::max()).size());
+}
+
+TEST_CASE("write_dec.num_digits")
+{
+    char bufc[64];
+    substr buf = bufc;
+    for(size_t num_digits : {0u, 1u, 2u, 3u, 10u, 20u, 30u})
+    {
+        for(uint64_t val : {UINT64_C(0), UINT64_C(7), UINT64_C(42), UINT64_C(12345678901234567890)})
+        {
+            std::string expected = std::to_string((unsigned long long)val);
+            if(expected.size() < num_digits)
+                expected.insert(0, num_digits - expected.size(), '0');
+            INFO("val=" << val << " num_digits=" << num_digits << " expected=" << expected);
+            buf.fill('?');
+            size_t ret = write_dec(buf, val, num_digits);
+            CHECK_EQ(ret, expected.size());
+            CHECK_EQ(buf.first(ret), to_csubstr(expected));
+            CHECK_EQ(buf.sub(ret).first_not_of('?'), csubstr::npos);
+            buf.fill('?');
+            CHECK_EQ(write_dec(buf.first(ret - 1), val, num_digits), expected.size());
+            CHECK_EQ(buf.first_not_of('?'), csubstr::npos);
+        }
+    }
+}
+
+
 template<class T> using xtoaNumDigitsFn = size_t (*)(substr, T, T, size_t);
 template<class T, xtoaNumDigitsFn<T> xtoa_fn>
 void test_itoa_num_digits(substr buf, T val, T radix, size_t digits, csubstr expected)
@@ -314,6 +374,43 @@ TEST_CASE("read_dec.fail")
     CHECK_EQ(udec, 10);
 }
 
+TEST_CASE("read_dec.all_lengths")
+{
+    // exercise every combination of the 8-, 4- and 1-digit steps
+    const char digits[] = "12345678901234567890";
+    for(size_t len = 0; len < 20; ++len)
+    {
+        csubstr s = csubstr(digits).first(len);
+        uint64_t expected = 0;
+        for(char c : s)
+            expected = expected * 10u + uint64_t(c - '0');
+        INFO("s=" << s);
+        uint64_t val = 1;
+        CHECK_UNARY(read_dec(s, &val));
+        CHECK_EQ(val, expected);
+        // an invalid character at any position must be rejected
+        for(size_t i = 0; i < len; ++i)
+        {
+            for(char bad : {'/', ':', ' ', 'a', '\0', '\xff', '\xfa'})
+            {
+                std::string tmp(s.str, s.len);
+                tmp[i] = bad;
+                INFO("i=" << i << " bad=" << int(bad));
+                CHECK_UNARY_FALSE(read_dec(to_csubstr(tmp), &val));
+            }
+        }
+    }
+    // wraps around like the native types
+    uint8_t vu8 = 0;
+    CHECK_UNARY(read_dec("00000000256", &vu8));
+    CHECK_EQ(vu8, 0);
+    CHECK_UNARY(read_dec("000000000257", &vu8));
+    CHECK_EQ(vu8, 1);
+    int16_t vi16 = 0;
+    CHECK_UNARY(read_dec("0000000032768", &vi16));
+    CHECK_EQ(vi16, std::numeric_limits<int16_t>::min());
+}
+
 TEST_CASE("read_hex.fail")
 {
     int dec = 1;
@@ -428,6 +525,194 @@ TEST_CASE("read_bin.fail")
     CHECK_EQ(udec, (uint32_t)-1);
 }
 
+TEST_CASE("read_pow2.all_lengths")
+{
+    // exercise the 8-character chunks and the padded last chunk
+    const char hexdigits[] = "0123456789abcdefABCDEF0123456789abcdef";
+    for(size_t len = 0; len <= 16; ++len)
+    {
+        for(size_t offs = 0; offs + len <= 22; offs += 3)
+        {
+            csubstr s = csubstr(hexdigits).sub(offs, len);
+            uint64_t expected = 0, expected_oct = 0, expected_bin = 0;
+            for(char c : s)
+            {
+                const uint64_t nibble = uint64_t(c <= '9' ? c - '0' : (c >= 'a' ? c - 'a' + 10 : c - 'A' + 10));
+                expected = (expected << 4u) | nibble;
+                expected_oct = (expected_oct << 3u) | (nibble & 7u);
+                expected_bin = (expected_bin << 1u) | (nibble & 1u);
+            }
+            INFO("s=" << s);
+            uint64_t val = 1;
+            CHECK_UNARY(read_hex(s, &val));
+            CHECK_EQ(val, expected);
+            // octal and binary versions of the same string
+            std::string oct(s.str, s.len), bin(s.str, s.len);
+            for(char &c : oct)
+                c = static_cast<char>('0' + ((c <= '9' ? c - '0' : (c >= 'a' ? c - 'a' + 10 : c - 'A' + 10)) & 7));
+            for(char &c : bin)
+                c = static_cast<char>('0' + ((c <= '9' ? c - '0' : (c >= 'a' ? c - 'a' + 10 : c - 'A' + 10)) & 1));
+            CHECK_UNARY(read_oct(to_csubstr(oct), &val));
+            CHECK_EQ(val, expected_oct);
+            CHECK_UNARY(read_bin(to_csubstr(bin), &val));
+            CHECK_EQ(val, expected_bin);
+            // an invalid character at any position must be rejected
+            for(size_t i = 0; i < len; ++i)
+            {
+                for(char bad : {'/', ':', '@', 'G', '`', 'g', ' ', '\0', '\xff', '\xc1'})
+                {
+                    INFO("i=" << i << " bad=" << int(bad));
+                    std::string tmp(s.str, s.len);
+                    tmp[i] = bad;
+                    CHECK_UNARY_FALSE(read_hex(to_csubstr(tmp), &val));
+                    tmp = oct;
+                    tmp[i] = bad;
+                    CHECK_UNARY_FALSE(read_oct(to_csubstr(tmp), &val));
+                    tmp[i] = '8';
+                    CHECK_UNARY_FALSE(read_oct(to_csubstr(tmp), &val));
+                    tmp = bin;
+                    tmp[i] = bad;
+                    CHECK_UNARY_FALSE(read_bin(to_csubstr(tmp), &val));
+                    tmp[i] = '2';
+                    CHECK_UNARY_FALSE(read_bin(to_csubstr(tmp), &val));
+                }
+            }
+        }
+    }
+    // wraps around like the native types
+    uint8_t vu8 = 0;
+    CHECK_UNARY(read_hex("0000000000000101", &vu8));
+    CHECK_EQ(vu8, 1);
+    int16_t vi16 = 0;
+    CHECK_UNARY(read_hex("0000000000008000", &vi16));
+    CHECK_EQ(vi16, std::numeric_limits<int16_t>::min());
+    uint32_t vu32 = 0;
+    CHECK_UNARY(read_bin("111111111111111111111111111111111", &vu32));
+    CHECK_EQ(vu32, UINT32_MAX);
+}
+
+TEST_CASE_TEMPLATE("write_pow2.full_width", T, uint8_t, int8_t, uint16_t, int16_t, uint32_t, int32_t, uint64_t, int64_t)
+{
+    // every number of digits, and buffers which are too small
+    using U = typename std::make_unsigned<T>::type;
+    char bufc[80];
+    for(unsigned bit = 0; bit < 8u * sizeof(T); ++bit)
+    {
+        // shift in the unsigned type: shifting into or past the sign
+        // bit of a signed type is undefined
+        const T vals[] = {T(U(U(1) << bit)), T(U(U(U(1) << bit) - 1u)), T(std::numeric_limits<T>::max() >> bit)};
+        for(T v : vals)
+        {
+            if(v < 0)
+                continue;
+            std::string hex, oct, bin;
+            for(uint64_t u = uint64_t(v); u || hex.empty(); u >>= 4u)
+                hex.insert(hex.begin(), "0123456789abcdef"[u & 15u]);
+            for(uint64_t u = uint64_t(v); u || oct.empty(); u >>= 3u)
+                oct.insert(oct.begin(), char('0' + (u & 7u)));
+            for(uint64_t u = uint64_t(v); u || bin.empty(); u >>= 1u)
+                bin.insert(bin.begin(), char('0' + (u & 1u)));
+            INFO("v=" << uint64_t(v));
+            substr buf = bufc;
+            CHECK_EQ(buf.first(write_hex(buf, v)), to_csubstr(hex));
+            CHECK_EQ(buf.first(write_oct(buf, v)), to_csubstr(oct));
+            CHECK_EQ(buf.first(write_bin(buf, v)), to_csubstr(bin));
+            // only the least significant digits are written
+            for(size_t sz = 0; sz < hex.size(); ++sz)
+            {
+                buf.fill('?');
+                CHECK_EQ(write_hex(buf.first(sz), v), hex.size());
+                CHECK_EQ(buf.first(sz), to_csubstr(hex).last(sz));
+                CHECK_EQ(buf[sz], '?');
+            }
+            for(size_t sz = 0; sz < bin.size(); ++sz)
+            {
+                buf.fill('?');
+                CHECK_EQ(write_bin(buf.first(sz), v), bin.size());
+                CHECK_EQ(buf.first(sz), to_csubstr(bin).last(sz));
+                CHECK_EQ(buf[sz], '?');
+            }
+        }
+    }
+}
+
+#if C4CORE_HAVE_INT128
+TEST_CASE("xtoa.int128")
+{
+    using u128 = detail::u128;
+    using i128 = detail::i128;
+    char bufc[200];
+    substr buf = bufc;
+    const u128 u64max = UINT64_MAX;
+    const u128 umax = ~u128(0);
+    const i128 imax = static_cast<i128>(umax >> 1u);
+    const i128 imin = -imax - 1;
+    // values around the 19-digit chunk boundaries
+    const u128 e19 = UINT64_C(10000000000000000000);
+    struct { u128 val; csubstr dec; } cases[] = {
+        {u128(0), "0"},
+        {u128(1), "1"},
+        {u64max, "18446744073709551615"},
+        {u64max + 1u, "18446744073709551616"},
+        {e19 - 1u, "9999999999999999999"},
+        {e19, "10000000000000000000"},
+        {e19 * e19 - 1u, "99999999999999999999999999999999999999"},
+        {e19 * e19, "100000000000000000000000000000000000000"},
+        {e19 * e19 + 1u, "100000000000000000000000000000000000001"},
+        {e19 * 5u + 7u, "50000000000000000007"},
+        {umax, "340282366920938463463374607431768211455"},
+    };
+    for(auto const& c : cases)
+    {
+        INFO("expected=" << c.dec);
+        CHECK_EQ(digits_dec(c.val), c.dec.len);
+        size_t ret = to_chars(buf, c.val);
+        CHECK_EQ(buf.first(ret), c.dec);
+        u128 back = 1;
+        CHECK_UNARY(from_chars(c.dec, &back));
+        CHECK_UNARY(back == c.val);
+        CHECK_EQ(from_chars_first(cat_sub(buf, ' ', c.dec, ' '), &back), c.dec.len + 1u);
+        CHECK_UNARY(back == c.val);
+        // too small buffers get the least significant digits
+        buf.fill('?');
+        CHECK_EQ(to_chars(buf.first(c.dec.len - 1u), c.val), c.dec.len);
+        CHECK_EQ(buf.first(c.dec.len - 1u), c.dec.sub(1));
+        CHECK_EQ(buf[c.dec.len - 1u], '?');
+    }
+    CHECK_EQ(buf.first(to_chars(buf, imax)), "170141183460469231731687303715884105727");
+    CHECK_EQ(buf.first(to_chars(buf, imin)), "-170141183460469231731687303715884105728");
+    CHECK_EQ(buf.first(to_chars(buf, i128(-1))), "-1");
+    CHECK_EQ(buf.first(to_chars(buf, fmt::hex(umax))), "0xffffffffffffffffffffffffffffffff");
+    CHECK_EQ(buf.first(to_chars(buf, fmt::hex(imin))), "-0x80000000000000000000000000000000");
+    CHECK_EQ(buf.first(to_chars(buf, fmt::bin(u64max + 1u))), "0b1" "0000000000000000000000000000000000000000000000000000000000000000");
+    CHECK_EQ(buf.first(to_chars(buf, fmt::oct(u128(1) << 100u))), "0o2" "000000000000000000000000000000000");
+    CHECK_EQ(buf.first(to_chars(buf, fmt::zpad(i128(-42), 25))), "-0000000000000000000000042");
+    CHECK_EQ(buf.first(to_chars(buf, fmt::zpad(fmt::hex(u64max + 1u), 20))), "0x00010000000000000000");
+    i128 ival = 0;
+    CHECK_UNARY(atox("-170141183460469231731687303715884105728", &ival));
+    CHECK_UNARY(ival == imin);
+    CHECK_UNARY(atox("-0x80000000000000000000000000000000", &ival));
+    CHECK_UNARY(ival == imin);
+    CHECK_UNARY(atox("0b11", &ival));
+    CHECK_UNARY(ival == 3);
+    CHECK_UNARY(atox("0o7777777777777777777777777777777777777777777", &ival));
+    CHECK_UNARY(ival == -1); // wraps around
+    u128 uval = 0;
+    CHECK_UNARY(atox("0xFFFFFFFFffffffffFFFFFFFFffffffff", &uval));
+    CHECK_UNARY(uval == umax);
+    CHECK_UNARY_FALSE(atox("-1", &uval));
+    CHECK_UNARY_FALSE(atox("12a", &uval));
+    // formatting and reading through the generic functions
+    std::string s = catrs<std::string>(umax, ' ', imin);
+    CHECK_EQ(s, "340282366920938463463374607431768211455 -170141183460469231731687303715884105728");
+    u128 ua = 0;
+    i128 ia = 0;
+    CHECK_NE(uncat(to_csubstr(s), ua, ia), csubstr::npos);
+    CHECK_UNARY(ua == umax);
+    CHECK_UNARY(ia == imin);
+}
+#endif
+
 template<class I>
 void test_toa_radix(size_t (*fn)(substr, I), size_t (*rfn)(substr, I, I), bool (*aifn)(csubstr, I*), substr buf, I num, const char *r2, const char *r8, const char *r10, const char *r16)
 {
@@ -1196,6 +1481,344 @@ TEST_CASE("atou.range_u64")
 #undef Tu
 
 
+//-----------------------------------------------------------------------------
+
+template<class T>
+void test_atox_checked(csubstr s, errc expected_err, T expected_val=T(0))
+{
+    INFO("s='" << s << "'");
+    T val = T(123);
+    errc err = atox_checked(s, &val);
+    CHECK_EQ((int)err, (int)expected_err);
+    if(expected_err == errc::ok)
+    {
+        CHECK_EQ(val, expected_val);
+    }
+    else
+    {
+        CHECK_EQ(val, T(123)); // not modified
+    }
+    // also through the wrapper
+    val = T(123);
+    err = errc::ok;
+    CHECK_EQ(from_chars(s, fmt::overflow_checked(val, &err)), expected_err == errc::ok);
+    CHECK_EQ((int)err, (int)expected_err);
+    // also with the position of the failure
+    val = T(123);
+    parse_result ret = from_chars_checked(s, &val);
+    CHECK_EQ((int)ret.err, (int)expected_err);
+    CHECK_EQ(val, expected_err == errc::ok ? expected_val : T(123));
+    if(expected_err != errc::invalid_argument)
+    {
+        CHECK_EQ(ret.consumed, s.len);
+    }
+    val = T(123);
+    ret = from_chars_first_checked(s, &val);
+    CHECK_EQ((int)ret.err, (int)expected_err);
+    CHECK_EQ(val, expected_err == errc::ok ? expected_val : T(123));
+}
+
+TEST_CASE("atox_checked.u8")
+{
+    test_atox_checked<uint8_t>("0", errc::ok, 0);
+    test_atox_checked<uint8_t>("255", errc::ok, 255);
+    test_atox_checked<uint8_t>("0000255", errc::ok, 255);
+    test_atox_checked<uint8_t>("0xff", errc::ok, 255);
+    test_atox_checked<uint8_t>("0x00ff", errc::ok, 255);
+    test_atox_checked<uint8_t>("0o377", errc::ok, 255);
+    test_atox_checked<uint8_t>("0b11111111", errc::ok, 255);
+    test_atox_checked<uint8_t>("256", errc::result_out_of_range);
+    test_atox_checked<uint8_t>("260", errc::result_out_of_range);
+    test_atox_checked<uint8_t>("999", errc::result_out_of_range);
+    test_atox_checked<uint8_t>("1000", errc::result_out_of_range);
+    test_atox_checked<uint8_t>("0x100", errc::result_out_of_range);
+    test_atox_checked<uint8_t>("0o400", errc::result_out_of_range);
+    test_atox_checked<uint8_t>("0o1000", errc::result_out_of_range);
+    test_atox_checked<uint8_t>("0b100000000", errc::result_out_of_range);
+    test_atox_checked<uint8_t>("", errc::invalid_argument);
+    test_atox_checked<uint8_t>("-1", errc::invalid_argument);
+    test_atox_checked<uint8_t>("0x", errc::invalid_argument);
+    test_atox_checked<uint8_t>("25a", errc::invalid_argument);
+    test_atox_checked<uint8_t>("10000a", errc::invalid_argument);
+    test_atox_checked<uint8_t>("0xfg", errc::invalid_argument);
+}
+
+TEST_CASE("atox_checked.i8")
+{
+    test_atox_checked<int8_t>("127", errc::ok, 127);
+    test_atox_checked<int8_t>("-128", errc::ok, -128);
+    test_atox_checked<int8_t>("-0x80", errc::ok, -128);
+    test_atox_checked<int8_t>("-0o200", errc::ok, -128);
+    test_atox_checked<int8_t>("-0", errc::ok, 0);
+    test_atox_checked<int8_t>("128", errc::result_out_of_range);
+    test_atox_checked<int8_t>("-129", errc::result_out_of_range);
+    test_atox_checked<int8_t>("0x80", errc::result_out_of_range);
+    test_atox_checked<int8_t>("-0x81", errc::result_out_of_range);
+    test_atox_checked<int8_t>("-", errc::invalid_argument);
+    test_atox_checked<int8_t>("--1", errc::invalid_argument);
+}
+
+TEST_CASE("atox_checked.u16_i16")
+{
+    test_atox_checked<uint16_t>("65535", errc::ok, 65535);
+    test_atox_checked<uint16_t>("65536", errc::result_out_of_range);
+    test_atox_checked<uint16_t>("65540", errc::result_out_of_range);
+    test_atox_checked<int16_t>("32767", errc::ok, 32767);
+    test_atox_checked<int16_t>("-32768", errc::ok, -32768);
+    test_atox_checked<int16_t>("32768", errc::result_out_of_range);
+    test_atox_checked<int16_t>("-32769", errc::result_out_of_range);
+}
+
+TEST_CASE("atox_checked.u32_i32")
+{
+    test_atox_checked<uint32_t>("4294967295", errc::ok, UINT32_C(4294967295));
+    test_atox_checked<uint32_t>("0xffffffff", errc::ok, UINT32_C(4294967295));
+    test_atox_checked<uint32_t>("0o37777777777", errc::ok, UINT32_C(4294967295));
+    test_atox_checked<uint32_t>("4294967296", errc::result_out_of_range);
+    test_atox_checked<uint32_t>("9999999999", errc::result_out_of_range);
+    test_atox_checked<uint32_t>("0x100000000", errc::result_out_of_range);
+    test_atox_checked<uint32_t>("0o40000000000", errc::result_out_of_range);
+    test_atox_checked<int32_t>("2147483647", errc::ok, INT32_C(2147483647));
+    test_atox_checked<int32_t>("-2147483648", errc::ok, INT32_C(-2147483647) - 1);
+    test_atox_checked<int32_t>("2147483648", errc::result_out_of_range);
+    test_atox_checked<int32_t>("-2147483649", errc::result_out_of_range);
+}
+
+TEST_CASE("atox_checked.u64_i64")
+{
+    const uint64_t umax = std::numeric_limits<uint64_t>::max();
+    const int64_t imin = std::numeric_limits<int64_t>::min();
+    const int64_t imax = std::numeric_limits<int64_t>::max();
+    test_atox_checked<uint64_t>("18446744073709551615", errc::ok, umax);
+    test_atox_checked<uint64_t>("0018446744073709551615", errc::ok, umax);
+    test_atox_checked<uint64_t>("0xffffffffffffffff", errc::ok, umax);
+    test_atox_checked<uint64_t>("0o1777777777777777777777", errc::ok, umax);
+    test_atox_checked<uint64_t>("0b1111111111111111111111111111111111111111111111111111111111111111", errc::ok, umax);
+    test_atox_checked<uint64_t>("18446744073709551616", errc::result_out_of_range);
+    test_atox_checked<uint64_t>("18446744073709551620", errc::result_out_of_range);
+    test_atox_checked<uint64_t>("99999999999999999999", errc::result_out_of_range);
+    test_atox_checked<uint64_t>("100000000000000000000", errc::result_out_of_range);
+    test_atox_checked<uint64_t>("0x10000000000000000", errc::result_out_of_range);
+    test_atox_checked<uint64_t>("0o2000000000000000000000", errc::result_out_of_range);
+    test_atox_checked<uint64_t>("0b10000000000000000000000000000000000000000000000000000000000000000", errc::result_out_of_range);
+    test_atox_checked<uint64_t>("1844674407370955161x", errc::invalid_argument);
+    test_atox_checked<int64_t>("9223372036854775807", errc::ok, imax);
+    test_atox_checked<int64_t>("-9223372036854775808", errc::ok, imin);
+    test_atox_checked<int64_t>("-0x8000000000000000", errc::ok, imin);
+    test_atox_checked<int64_t>("9223372036854775808", errc::result_out_of_range);
+    test_atox_checked<int64_t>("9999999999999999999", errc::result_out_of_range);
+    test_atox_checked<int64_t>("-9223372036854775809", errc::result_out_of_range);
+    test_atox_checked<int64_t>("0x8000000000000000", errc::result_out_of_range);
+}
+
+TEST_CASE("atox_first_checked")
+{
+    uint8_t vu8 = 0;
+    errc err = errc::ok;
+    CHECK_EQ(atox_first_checked(csubstr("255 rest"), &vu8, &err), 3u);
+    CHECK_EQ(vu8, 255);
+    CHECK_EQ((int)err, (int)errc::ok);
+    CHECK_EQ(atox_first_checked(csubstr("256 rest"), &vu8, &err), csubstr::npos);
+    CHECK_EQ((int)err, (int)errc::result_out_of_range);
+    CHECK_EQ(atox_first_checked(csubstr("rest"), &vu8, &err), csubstr::npos);
+    CHECK_EQ((int)err, (int)errc::invalid_argument);
+    int8_t vi8 = 0;
+    CHECK_EQ(from_chars_first(csubstr("-128,"), fmt::overflow_checked(vi8, &err)), 4u);
+    CHECK_EQ(vi8, -128);
+    CHECK_EQ(from_chars_first(csubstr("-129,"), fmt::overflow_checked(vi8, &err)), csubstr::npos);
+    CHECK_EQ((int)err, (int)errc::result_out_of_range);
+}
+
+template<class T>
+void test_from_chars_checked(csubstr s, errc expected_err, size_t expected_consumed, T expected_val=T(0))
+{
+    INFO("s='" << s << "'");
+    T val = T(123);
+    const parse_result ret = from_chars_checked(s, &val);
+    CHECK_EQ((int)ret.err, (int)expected_err);
+    CHECK_EQ(ret.consumed, expected_consumed);
+    CHECK_EQ((bool)ret, expected_err == errc::ok);
+    CHECK_EQ(val, expected_err == errc::ok ? expected_val : T(123));
+}
+
+template<class T>
+void test_from_chars_first_checked(csubstr s, errc expected_err, size_t expected_consumed, T expected_val=T(0))
+{
+    INFO("s='" << s << "'");
+    T val = T(123);
+    const parse_result ret = from_chars_first_checked(s, &val);
+    CHECK_EQ((int)ret.err, (int)expected_err);
+    CHECK_EQ(ret.consumed, expected_consumed);
+    CHECK_EQ(ret.first(), expected_err == errc::ok ? expected_consumed : csubstr::npos);
+    CHECK_EQ(val, expected_err == errc::ok ? expected_val : T(123));
+    // the unchecked version agrees when there is no overflow
+    if(expected_err != errc::result_out_of_range)
+    {
+        val = T(123);
+        CHECK_EQ(from_chars_first(s, &val), ret.first());
+        CHECK_EQ(val, expected_err == errc::ok ? expected_val : T(123));
+    }
+}
+
+TEST_CASE("from_chars_checked.int")
+{
+    test_from_chars_checked<int32_t>("12345", errc::ok, 5, 12345);
+    test_from_chars_checked<int32_t>("-0x10", errc::ok, 5, -16);
+    test_from_chars_checked<int32_t>("", errc::invalid_argument, 0);
+    test_from_chars_checked<int32_t>("-", errc::invalid_argument, 1);
+    test_from_chars_checked<int32_t>(" 1", errc::invalid_argument, 0);
+    test_from_chars_checked<int32_t>("1 ", errc::invalid_argument, 1);
+    test_from_chars_checked<int32_t>("123x5", errc::invalid_argument, 3);
+    test_from_chars_checked<int32_t>("0xfg", errc::invalid_argument, 3);
+    test_from_chars_checked<int32_t>("0b102", errc::invalid_argument, 4);
+    test_from_chars_checked<int32_t>("0x", errc::invalid_argument, 1);
+    test_from_chars_checked<int32_t>("0x,", errc::invalid_argument, 2);
+    test_from_chars_checked<int32_t>("2147483648", errc::result_out_of_range, 10);
+    test_from_chars_checked<int32_t>("-2147483648", errc::ok, 11, INT32_MIN);
+    test_from_chars_checked<int32_t>("-2147483649", errc::result_out_of_range, 11);
+    test_from_chars_checked<int32_t>("21474836480x", errc::invalid_argument, 11);
+    test_from_chars_checked<uint32_t>("-1", errc::invalid_argument, 0);
+    test_from_chars_checked<uint32_t>("00000000000000000004294967295", errc::ok, 29, UINT32_MAX);
+    test_from_chars_checked<uint32_t>("0x00000000ffffffff", errc::ok, 18, UINT32_MAX);
+    test_from_chars_checked<uint32_t>("0x100000000", errc::result_out_of_range, 11);
+    test_from_chars_checked<uint8_t>("256", errc::result_out_of_range, 3);
+}
+
+TEST_CASE("from_chars_first_checked.int")
+{
+    test_from_chars_first_checked<int32_t>("12345", errc::ok, 5, 12345);
+    test_from_chars_first_checked<int32_t>("  -42, 1", errc::ok, 5, -42);
+    test_from_chars_first_checked<int32_t>("\t0x1f]", errc::ok, 5, 31);
+    test_from_chars_first_checked<int32_t>("", errc::invalid_argument, 0);
+    test_from_chars_first_checked<int32_t>("   ", errc::invalid_argument, 3);
+    test_from_chars_first_checked<int32_t>("  abc", errc::invalid_argument, 2);
+    test_from_chars_first_checked<int32_t>("  12abc", errc::invalid_argument, 4);
+    test_from_chars_first_checked<int32_t>(" 2147483648 ", errc::result_out_of_range, 11);
+    test_from_chars_first_checked<int32_t>(" 2147483648a", errc::invalid_argument, 11);
+    test_from_chars_first_checked<uint64_t>(" 18446744073709551615 ", errc::ok, 21, UINT64_MAX);
+    test_from_chars_first_checked<uint64_t>(" 18446744073709551616 ", errc::result_out_of_range, 21);
+    test_from_chars_first_checked<uint64_t>(" -1", errc::invalid_argument, 1);
+#if C4CORE_HAVE_INT128
+    using u128 = detail::u128;
+    using i128 = detail::i128;
+    u128 u = 0;
+    i128 i = 0;
+    parse_result ret = from_chars_checked("340282366920938463463374607431768211455", &u);
+    CHECK_UNARY(ret.ok());
+    CHECK_UNARY(u == ~u128(0));
+    ret = from_chars_checked("340282366920938463463374607431768211456", &u);
+    CHECK_EQ((int)ret.err, (int)errc::result_out_of_range);
+    CHECK_EQ(ret.consumed, 39u);
+    ret = from_chars_first_checked(" -170141183460469231731687303715884105728 ", &i);
+    CHECK_UNARY(ret.ok());
+    CHECK_EQ(ret.consumed, 41u);
+    CHECK_UNARY(i == static_cast<i128>(u128(1) << 127u));
+    ret = from_chars_first_checked(" 170141183460469231731687303715884105728 ", &i);
+    CHECK_EQ((int)ret.err, (int)errc::result_out_of_range);
+#endif
+}
+
+TEST_CASE("from_chars_checked.real")
+{
+    test_from_chars_checked<double>("1.5", errc::ok, 3, 1.5);
+    test_from_chars_checked<double>("-0x1.8p+1", errc::ok, 9, -3.);
+    test_from_chars_checked<double>("1.2345678901234567e-10", errc::ok, 22, 1.2345678901234567e-10);
+    test_from_chars_checked<double>("", errc::invalid_argument, 0);
+    test_from_chars_checked<double>("abc", errc::invalid_argument, 0);
+    test_from_chars_checked<double>("1.5x", errc::invalid_argument, 3);
+    test_from_chars_checked<double>("1.5 ", errc::invalid_argument, 3);
+    test_from_chars_checked<float>("0.25", errc::ok, 4, 0.25f);
+    test_from_chars_checked<float>("0.25,", errc::invalid_argument, 4);
+    test_from_chars_first_checked<double>("  1.5, 2", errc::ok, 5, 1.5);
+    test_from_chars_first_checked<double>("  0x1p-2]", errc::ok, 8, 0.25);
+    test_from_chars_first_checked<double>("  ,1", errc::invalid_argument, 2);
+    test_from_chars_first_checked<double>("  1.5e+", errc::invalid_argument, 5);
+    test_from_chars_first_checked<double>("  1.5z", errc::invalid_argument, 5);
+    test_from_chars_first_checked<float>(" 2.5 ", errc::ok, 4, 2.5f);
+    half h;
+    parse_result ret = from_chars_checked("1.5", &h);
+    CHECK_UNARY(ret.ok());
+    CHECK_EQ(h.bits, 0x3e00);
+    ret = from_chars_first_checked(" 1.5e", &h);
+    CHECK_EQ((int)ret.err, (int)errc::invalid_argument);
+    bfloat16 b;
+    ret = from_chars_first_checked(" -2 ", &b);
+    CHECK_UNARY(ret.ok());
+    CHECK_EQ(ret.consumed, 3u);
+    CHECK_EQ(b.bits, 0xc000);
+}
+
+TEST_CASE("from_chars_checked.bool_char_str")
+{
+    test_from_chars_checked<bool>("true", errc::ok, 4, true);
+    test_from_chars_checked<bool>("FALSE", errc::ok, 5, false);
+    test_from_chars_checked<bool>("10", errc::ok, 2, true);
+    test_from_chars_checked<bool>("0x0", errc::ok, 3, false);
+    test_from_chars_checked<bool>("truex", errc::invalid_argument, 0);
+    test_from_chars_checked<bool>("12x", errc::invalid_argument, 2);
+    test_from_chars_checked<bool>("99999999999", errc::result_out_of_range, 11);
+    test_from_chars_first_checked<bool>("  True, 1", errc::ok, 6, true);
+    test_from_chars_first_checked<bool>("  0 1", errc::ok, 3, false);
+    test_from_chars_first_checked<bool>("  yes", errc::invalid_argument, 2);
+    test_from_chars_first_checked<bool>("  1x", errc::invalid_argument, 3);
+    test_from_chars_checked<char>("a", errc::ok, 1, 'a');
+    test_from_chars_checked<char>("", errc::invalid_argument, 0);
+    test_from_chars_checked<char>("ab", errc::invalid_argument, 1);
+    test_from_chars_first_checked<char>("ab", errc::ok, 1, 'a');
+    test_from_chars_first_checked<char>("", errc::invalid_argument, 0);
+    csubstr cs;
+    parse_result ret = from_chars_checked("  abc ", &cs);
+    CHECK_UNARY(ret.ok());
+    CHECK_EQ(ret.consumed, 6u);
+    CHECK_EQ(cs, "  abc ");
+    ret = from_chars_first_checked("  abc def", &cs);
+    CHECK_UNARY(ret.ok());
+    CHECK_EQ(ret.consumed, 5u);
+    CHECK_EQ(cs, "abc");
+    ret = from_chars_first_checked("   ", &cs);
+    CHECK_EQ((int)ret.err, (int)errc::invalid_argument);
+    CHECK_EQ(ret.consumed, 3u);
+    char buf_[4] = {};
+    substr ss(buf_, 4);
+    ret = from_chars_checked("abc", &ss);
+    CHECK_UNARY(ret.ok());
+    CHECK_EQ(ss, "abc");
+    ss = substr(buf_, 4);
+    ret = from_chars_checked("abcdef", &ss);
+    CHECK_EQ((int)ret.err, (int)errc::result_out_of_range);
+    CHECK_EQ(ret.consumed, 4u);
+    ss = substr(buf_, 4);
+    ret = from_chars_first_checked(" ab cd", &ss);
+    CHECK_UNARY(ret.ok());
+    CHECK_EQ(ret.consumed, 3u);
+    CHECK_EQ(ss, "ab");
+    ss = substr(buf_, 4);
+    ret = from_chars_first_checked(" abcdef", &ss);
+    CHECK_EQ((int)ret.err, (int)errc::result_out_of_range);
+    CHECK_EQ(ret.consumed, 5u);
+    int *ptr = nullptr;
+    ret = from_chars_first_checked(" 0x1234 ", &ptr);
+    CHECK_UNARY(ret.ok());
+    CHECK_EQ(ret.consumed, 7u);
+    CHECK_EQ((void*)ptr, (void*)0x1234);
+    CHECK_EQ(from_chars_first(" -0x1234 ", &ptr), 8u);
+    CHECK_EQ((void*)ptr, (void*)-0x1234);
+    ret = from_chars_checked(" 0x1234", &ptr);
+    CHECK_EQ((int)ret.err, (int)errc::invalid_argument);
+    // through the fmt wrapper
+    errc err = errc::ok;
+    int8_t vi8 = 0;
+    ret = from_chars_first_checked(" -129,", fmt::overflow_checked(vi8, &err));
+    CHECK_EQ((int)ret.err, (int)errc::result_out_of_range);
+    CHECK_EQ((int)err, (int)errc::result_out_of_range);
+    CHECK_EQ(ret.consumed, 5u);
+    ret = from_chars_checked("-128", fmt::overflow_checked(vi8, &err));
+    CHECK_UNARY(ret.ok());
+    CHECK_EQ((int)err, (int)errc::ok);
+    CHECK_EQ(vi8, -128);
+}
+
+
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
@@ -1292,6 +1915,153 @@ TEST_CASE("ftoa.basic")
     test_rtoa(buf, d, &dtoa, 4, /*scient*/"1.0123e+00", /*flt*/"1.0123", /*flex*/"1.0123", /*hexa*/"0x1.0329p+0");
 }
 
+TEST_CASE("dtoa.shortest")
+{
+    char bufc[64];
+    substr buf = bufc;
+    auto t_ = [&](double d, csubstr flex, csubstr scient){
+        INFO("flex=" << flex << "  scient=" << scient);
+        size_t ret = dtoa(buf, d);
+        CHECK_EQ(buf.first(ret), flex);
+        ret = dtoa(buf, d, -1, FTOA_SCIENT);
+        CHECK_EQ(buf.first(ret), scient);
+        // buffers too small: must report the size, and not write
+        buf.fill('?');
+        CHECK_EQ(dtoa(buf.first(flex.len - 1), d), flex.len);
+        CHECK_EQ(buf.first_not_of('?'), csubstr::npos);
+        // must read back to the same value
+        double rt = 0.0;
+        CHECK(atod(flex, &rt));
+        CHECK_EQ(memcmp(&rt, &d, sizeof(d)), 0);
+    };
+    t_(0.0, "0", "0e+00");
+    t_(-0.0, "-0", "-0e+00");
+    t_(1.0, "1", "1e+00");
+    t_(-1.5, "-1.5", "-1.5e+00");
+    t_(0.1, "0.1", "1e-01");
+    t_(0.3, "0.3", "3e-01");
+    t_(100.0, "100", "1e+02");
+    t_(123456.0, "123456", "1.23456e+05");
+    t_(1234567.0, "1.234567e+06", "1.234567e+06");
+    t_(0.0001, "0.0001", "1e-04");
+    t_(0.00001234, "1.234e-05", "1.234e-05");
+    t_(299792458.0, "2.99792458e+08", "2.99792458e+08");
+    t_(9007199254740991.0, "9.007199254740991e+15", "9.007199254740991e+15");
+    t_(1e23, "1e+23", "1e+23");
+    t_(5e-324, "5e-324", "5e-324");
+    t_(2.2250738585072014e-308, "2.2250738585072014e-308", "2.2250738585072014e-308");
+    t_(1.7976931348623157e308, "1.7976931348623157e+308", "1.7976931348623157e+308");
+    t_(0.1 + 0.2, "0.30000000000000004", "3.0000000000000004e-01");
+    size_t ret = dtoa(buf, std::numeric_limits<double>::infinity());
+    CHECK_EQ(buf.first(ret), "inf");
+    ret = dtoa(buf, -std::numeric_limits<double>::infinity());
+    CHECK_EQ(buf.first(ret), "-inf");
+    ret = dtoa(buf, std::numeric_limits<double>::quiet_NaN());
+    CHECK_EQ(buf.first(ret), "nan");
+}
+
+TEST_CASE("ftoa.shortest")
+{
+    char bufc[64];
+    substr buf = bufc;
+    auto t_ = [&](float f, csubstr flex, csubstr scient){
+        INFO("flex=" << flex << "  scient=" << scient);
+        size_t ret = ftoa(buf, f);
+        CHECK_EQ(buf.first(ret), flex);
+        ret = ftoa(buf, f, -1, FTOA_SCIENT);
+        CHECK_EQ(buf.first(ret), scient);
+        float rt = 0.f;
+        CHECK(atof(flex, &rt));
+        CHECK_EQ(memcmp(&rt, &f, sizeof(f)), 0);
+    };
+    t_(0.f, "0", "0e+00");
+    t_(0.1f, "0.1", "1e-01");
+    t_(1.f/3.f, "0.33333334", "3.3333334e-01");
+    t_(16777216.f, "1.6777216e+07", "1.6777216e+07");
+    t_(123456789.f, "1.2345679e+08", "1.2345679e+08");
+    t_(1e-45f, "1e-45", "1e-45");
+    t_(3.4028235e38f, "3.4028235e+38", "3.4028235e+38");
+}
+
+TEST_CASE("dtoa.fixed_precision")
+{
+    char bufc[128];
+    substr buf = bufc;
+    auto t_ = [&](double d, int precision, csubstr expected){
+        INFO("d=" << d << "  precision=" << precision << "  expected=" << expected);
+        size_t ret = dtoa(buf, d, precision, FTOA_FLOAT);
+        CHECK_EQ(buf.first(ret), expected);
+        // must match the single precision result when exact
+        if((double)(float)d == d && std::fabs(d) < 1e6)
+        {
+            ret = ftoa(buf, (float)d, precision, FTOA_FLOAT);
+            CHECK_EQ(buf.first(ret), expected);
+        }
+        // too small: report the size and do not write
+        buf.fill('?');
+        CHECK_EQ(dtoa(buf.first(expected.len - 1), d, precision, FTOA_FLOAT), expected.len);
+        CHECK_EQ(buf.first_not_of('?'), csubstr::npos);
+    };
+    t_(0.0, 0, "0");
+    t_(0.0, 2, "0.00");
+    t_(-0.0, 2, "-0.00");
+    t_(1.0, 0, "1");
+    t_(1.0, 3, "1.000");
+    t_(3.14159, 2, "3.14");
+    t_(-3.14159, 4, "-3.1416");
+    t_(1234.5678, 2, "1234.57");
+    t_(0.001, 2, "0.00");
+    t_(-0.001, 2, "-0.00");
+    t_(0.009, 2, "0.01");
+    t_(0.99999, 2, "1.00");
+    t_(99.999, 2, "100.00");
+    // exact ties are rounded to even
+    t_(0.125, 2, "0.12");
+    t_(0.375, 2, "0.38");
+    t_(2.5, 0, "2");
+    t_(3.5, 0, "4");
+    t_(-2.5, 0, "-2");
+    // not exact ties: 0.015 is 0.01499999999999999944...
+    t_(0.015, 2, "0.01");
+    t_(0.025, 2, "0.03");
+    t_(1e15, 2, "1000000000000000.00");
+    t_(1e-300, 3, "0.000");
+    t_(5e-324, 5, "0.00000");
+    t_(123456789.0, 9, "123456789.000000000");
+    t_(0.1, 19, "0.1000000000000000056");
+    // larger than the integer path: falls back
+    size_t ret = dtoa(buf, 1e20, 2, FTOA_FLOAT);
+    CHECK_EQ(buf.first(ret), "100000000000000000000.00");
+    ret = dtoa(buf, 1.5e19, 3, FTOA_FLOAT);
+    CHECK_EQ(buf.first(ret), "15000000000000000000.000");
+    ret = dtoa(buf, std::numeric_limits<double>::infinity(), 2, FTOA_FLOAT);
+    CHECK_EQ(buf.first(ret), "inf");
+    ret = dtoa(buf, -std::numeric_limits<double>::infinity(), 2, FTOA_FLOAT);
+    CHECK_EQ(buf.first(ret), "-inf");
+}
+
+TEST_CASE_TEMPLATE("xtoa.shortest_roundtrip", T, float, double)
+{
+    char bufc[64];
+    substr buf = bufc;
+    // walk through the binades with a spread of mantissas
+    using U = typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type;
+    const U max_bits = sizeof(T) == 4 ? U(0x7f7fffffu) : U(UINT64_C(0x7fefffffffffffff));
+    const U step = max_bits / U(100003);
+    for(U bits = 1; bits < max_bits - step; bits = U(bits + step))
+    {
+        T val;
+        memcpy(&val, &bits, sizeof(T));
+        size_t ret = xtoa(buf, val);
+        REQUIRE_LE(ret, buf.len);
+        T rt;
+        REQUIRE(atox(buf.first(ret), &rt));
+        INFO("str=" << buf.first(ret));
+        CHECK_EQ(memcmp(&rt, &val, sizeof(T)), 0);
+        CHECK_LE(ret, (size_t)max_chars<T>::value);
+    }
+}
+
 
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
@@ -1349,10 +2119,687 @@ TEST_CASE_TEMPLATE("atof.fail_parse", T, float, double)
     //t_("123.45not a float!");
 }
 
+TEST_CASE_TEMPLATE("atof.plain_decimal", T, float, double)
+{
+    // the short plain decimals take a fast path in atof()/atod(): it
+    // must give the same correctly rounded result as the general path
+    auto t_ = [](csubstr str, bool plain){
+        INFO("str=" << str);
+        T fast = T(-1), slow = T(-2), val = T(-3);
+        CHECK_EQ(detail::_atof_plain(str, &fast), plain);
+        REQUIRE_EQ(detail::scan_real(str, &slow), str.len);
+        REQUIRE(atox(str, &val));
+        CHECK_EQ(memcmp(&val, &slow, sizeof(T)), 0);
+        if(plain)
+            CHECK_EQ(memcmp(&fast, &slow, sizeof(T)), 0);
+    };
+    t_("0", true);
+    t_("-0", true);
+    t_("0.", true);
+    t_(".5", true);
+    t_("-0.5", true);
+    t_("123.45", true);
+    t_("-123.45", true);
+    t_("0.1", true);
+    t_("0.3", true);
+    t_("1234567", true);
+    t_("123456.7", true);
+    t_(".1234567", true);
+    t_("0.000001", true);
+    t_("0.0000001", sizeof(T) == 8);
+    t_("16777216", true);
+    t_("16777217", sizeof(T) == 8);
+    t_("0.123456789", sizeof(T) == 8);
+    t_("999999999999999", sizeof(T) == 8);
+    t_("0.00000000000001", sizeof(T) == 8);
+    t_("0.000000000000001", false);
+    t_("9007199254740992", sizeof(T) == 8);
+    t_("9007199254740993", false);
+    t_("0.00000000000000000000001", false);
+    t_("00000000000000000001", false);
+    t_("1e5", false);
+    t_("1.5e-3", false);
+    t_("inf", false);
+    // every digit count and point position
+    const uint64_t max_mantissa = detail::_plain_dec<T>::max_mantissa;
+    const size_t max_len = detail::_plain_dec<T>::max_len;
+    char bufc[32];
+    for(size_t num_digits = 1; num_digits <= 20; ++num_digits)
+    {
+        for(size_t point = 0; point <= num_digits + 1; ++point) // the last has no point
+        {
+            for(uint64_t seed : {UINT64_C(1), UINT64_C(987654321987654321), UINT64_C(1357913579135791357)})
+            {
+                size_t pos = 0;
+                uint64_t mantissa = 0;
+                for(size_t i = 0; i < num_digits; ++i)
+                {
+                    if(i == point)
+                        bufc[pos++] = '.';
+                    const unsigned digit = static_cast<unsigned>((seed >> (3u * i)) % 10u);
+                    bufc[pos++] = static_cast<char>('0' + digit);
+                    mantissa = 10u * mantissa + digit;
+                }
+                if(point == num_digits)
+                    bufc[pos++] = '.';
+                t_(csubstr(bufc, pos), pos <= max_len && mantissa <= max_mantissa);
+            }
+        }
+    }
+    // the value is not modified when the shape does not match
+    T val = T(1);
+    CHECK_FALSE(detail::_atof_plain(csubstr("1.2.3"), &val));
+    CHECK_FALSE(detail::_atof_plain(csubstr("."), &val));
+    CHECK_FALSE(detail::_atof_plain(csubstr("-"), &val));
+    CHECK_FALSE(detail::_atof_plain(csubstr(""), &val));
+    CHECK_FALSE(detail::_atof_plain(csubstr("+1"), &val));
+    CHECK_FALSE(detail::_atof_plain(csubstr("1,5"), &val));
+    CHECK_FALSE(detail::_atof_plain(csubstr("12345.6789.1"), &val));
+    CHECK_EQ(val, T(1));
+}
+
+TEST_CASE_TEMPLATE("scan_real.basic", T, float, double)
+{
+    auto t_ = [](csubstr str, size_t len, double expected){
+        INFO("str=" << str);
+        T rval = T(-12345);
+        CHECK_EQ(detail::scan_real(str, &rval), len);
+        if(len != csubstr::npos)
+            CHECK_EQ(rval, T(expected));
+    };
+    t_("0", 1, 0.);
+    t_("-0", 2, 0.);
+    t_("+1.5", 4, 1.5);
+    t_(" \t\r\n1.5", 7, 1.5);
+    t_("1.5 ", 3, 1.5);
+    t_("1.5.5", 3, 1.5);
+    t_("1.25e2", 6, 125.);
+    t_("1.25E-2", 7, 0.0125);
+    t_("125e", 3, 125.);
+    t_("125e+", 3, 125.);
+    t_("125e+x", 3, 125.);
+    t_(".5", 2, 0.5);
+    t_("5.", 2, 5.);
+    t_("0x1p3", 5, 8.);
+    t_("0X1.8P-1", 8, 0.75);
+    t_("0x.8", 4, 0.5);
+    t_("0xap", 3, 10.);
+    t_("0x", 1, 0.);
+    t_("0xg", 1, 0.);
+    t_("00012345678901234567890123", 26, 12345678901234567890123.);
+    t_("", csubstr::npos, 0.);
+    t_(" ", csubstr::npos, 0.);
+    t_("-", csubstr::npos, 0.);
+    t_(".", csubstr::npos, 0.);
+    t_("+.e1", csubstr::npos, 0.);
+    t_("e1", csubstr::npos, 0.);
+    t_("in", csubstr::npos, 0.);
+    t_("na", csubstr::npos, 0.);
+    // the length of the string must be strictly respected
+    t_(csubstr("1234").first(2), 2, 12.);
+    t_(csubstr("1e12").first(3), 3, 10.);
+    t_(csubstr("0x12").first(2), 1, 0.);
+    t_(csubstr("0x12").first(3), 3, 1.);
+    // specials
+    T rval = {};
+    CHECK_EQ(detail::scan_real("infinity", &rval), 8u);
+    CHECK_EQ(rval, std::numeric_limits<T>::infinity());
+    CHECK_EQ(detail::scan_real("-INFin", &rval), 4u);
+    CHECK_EQ(rval, -std::numeric_limits<T>::infinity());
+    CHECK_EQ(detail::scan_real("nan", &rval), 3u);
+    CHECK(rval != rval);
+    CHECK_EQ(detail::scan_real("NaN(123)", &rval), 8u);
+    CHECK(rval != rval);
+    CHECK_EQ(detail::scan_real("nan(12", &rval), 3u);
+    CHECK(rval != rval);
+    // out of range
+    CHECK_EQ(detail::scan_real("1e100000", &rval), 8u);
+    CHECK_EQ(rval, std::numeric_limits<T>::infinity());
+    CHECK_EQ(detail::scan_real("-1e-100000", &rval), 10u);
+    CHECK_EQ(rval, T(0));
+    CHECK(std::signbit(rval));
+}
+
+TEST_CASE_TEMPLATE("scan_real.correctly_rounded", T, float, double)
+{
+    using U = typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type;
+    T rval = {};
+    // largest finite, and the halfway points above it
+    const T max = std::numeric_limits<T>::max();
+    const T min = std::numeric_limits<T>::denorm_min();
+    if(sizeof(T) == 4)
+    {
+        CHECK_EQ(detail::scan_real("3.4028235e38", &rval), 12u);
+        CHECK_EQ(rval, max);
+        CHECK_EQ(detail::scan_real("3.40282356779733661637539395458142568448e38", &rval), 43u); // halfway: rounds to even
+        CHECK_EQ(rval, std::numeric_limits<T>::infinity());
+        CHECK_EQ(detail::scan_real("3.40282356779733661637539395458142568447e38", &rval), 43u);
+        CHECK_EQ(rval, max);
+        CHECK_EQ(detail::scan_real("0x1.fffffep127", &rval), 14u);
+        CHECK_EQ(rval, max);
+        CHECK_EQ(detail::scan_real("0x1p-149", &rval), 8u);
+        CHECK_EQ(rval, min);
+        CHECK_EQ(detail::scan_real("0x1p-150", &rval), 8u); // halfway: rounds to even
+        CHECK_EQ(rval, T(0));
+        CHECK_EQ(detail::scan_real("0x1.000002p-150", &rval), 15u);
+        CHECK_EQ(rval, min);
+        CHECK_EQ(detail::scan_real("1.00000005960464477539062500", &rval), 28u); // halfway: rounds to even
+        CHECK_EQ(rval, T(1));
+        CHECK_EQ(detail::scan_real("1.00000005960464477539062500000000000000000001", &rval), 46u);
+        CHECK_EQ(rval, std::nextafter(T(1), T(2)));
+    }
+    else
+    {
+        CHECK_EQ(detail::scan_real("1.7976931348623157e308", &rval), 22u);
+        CHECK_EQ(rval, max);
+        CHECK_EQ(detail::scan_real("1.7976931348623158e308", &rval), 22u);
+        CHECK_EQ(rval, max);
+        CHECK_EQ(detail::scan_real("1.7976931348623159e308", &rval), 22u);
+        CHECK_EQ(rval, std::numeric_limits<T>::infinity());
+        CHECK_EQ(detail::scan_real("0x1.fffffffffffffp1023", &rval), 22u);
+        CHECK_EQ(rval, max);
+        CHECK_EQ(detail::scan_real("4.9406564584124654e-324", &rval), 23u);
+        CHECK_EQ(rval, min);
+        CHECK_EQ(detail::scan_real("2.4703282292062327e-324", &rval), 23u);
+        CHECK_EQ(rval, T(0));
+        CHECK_EQ(detail::scan_real("2.4703282292062328e-324", &rval), 23u);
+        CHECK_EQ(rval, min);
+        CHECK_EQ(detail::scan_real("9007199254740993", &rval), 16u); // halfway: rounds to even
+        CHECK_EQ(rval, T(9007199254740992.));
+        CHECK_EQ(detail::scan_real("9007199254740993.00000000000000000000000000001", &rval), 46u);
+        CHECK_EQ(rval, T(9007199254740994.));
+        CHECK_EQ(detail::scan_real("2.2250738585072011e-308", &rval), 23u);
+        CHECK_EQ(rval, std::nextafter(std::numeric_limits<T>::min(), T(0)));
+        CHECK_EQ(detail::scan_real("2.2250738585072012e-308", &rval), 23u);
+        CHECK_EQ(rval, std::numeric_limits<T>::min());
+    }
+    // the shortest representations must read back to the same value
+    char bufc[64];
+    substr buf = bufc;
+    const U max_bits = sizeof(T) == 4 ? U(0x7f7fffffu) : U(UINT64_C(0x7fefffffffffffff));
+    const U step = max_bits / U(100003);
+    for(U bits = 1; bits < max_bits - step; bits = U(bits + step))
+    {
+        T val;
+        memcpy(&val, &bits, sizeof(T));
+        for(RealFormat_e fmt : {FTOA_FLEX, FTOA_SCIENT})
+        {
+            size_t ret = sizeof(T) == 4 ? ftoa(buf, static_cast<float>(val), -1, fmt) : dtoa(buf, static_cast<double>(val), -1, fmt);
+            REQUIRE_LE(ret, buf.len);
+            INFO("str=" << buf.first(ret));
+            T rt;
+            REQUIRE_EQ(detail::scan_real(buf.first(ret), &rt), ret);
+            CHECK_EQ(memcmp(&rt, &val, sizeof(T)), 0);
+        }
+    }
+}
+
 
 //-----------------------------------------------------------------------------
+
+TEST_CASE("dtoa.hexa")
+{
+    char bufc[64];
+    substr buf = bufc;
+    auto t_ = [&](double d, int precision, csubstr expected){
+        INFO("expected=" << expected);
+        const size_t ret = dtoa(buf, d, precision, FTOA_HEXA);
+        REQUIRE_LE(ret, buf.len);
+        CHECK_EQ(buf.first(ret), expected);
+        // too small a buffer: nothing is written
+        memset(bufc, 'x', sizeof(bufc));
+        CHECK_EQ(dtoa(buf.first(ret - 1), d, precision, FTOA_HEXA), ret);
+        CHECK_EQ(buf.first(ret), std::string(ret, 'x'));
+    };
+    t_(0., -1, "0x0p+0");
+    t_(-0., -1, "-0x0p+0");
+    t_(1., -1, "0x1p+0");
+    t_(-2., -1, "-0x1p+1");
+    t_(0.5, -1, "0x1p-1");
+    t_(1.5, -1, "0x1.8p+0");
+    t_(0.1, -1, "0x1.999999999999ap-4");
+    t_(1.1234123, -1, "0x1.1f97f2d06c948p+0");
+    t_(std::numeric_limits<double>::max(), -1, "0x1.fffffffffffffp+1023");
+    t_(std::numeric_limits<double>::min(), -1, "0x1p-1022");
+    t_(std::numeric_limits<double>::denorm_min(), -1, "0x0.0000000000001p-1022");
+    t_(std::nextafter(std::numeric_limits<double>::min(), 0.), -1, "0x0.fffffffffffffp-1022");
+    t_(std::numeric_limits<double>::infinity(), -1, "inf");
+    t_(-std::numeric_limits<double>::infinity(), -1, "-inf");
+    t_(std::numeric_limits<double>::quiet_NaN(), -1, "nan");
+    // precision: rounds to nearest, ties to even, or pads with zeros
+    t_(1.5, 0, "0x2p+0"); // tie, to even
+    t_(std::numeric_limits<double>::min() / 2, 0, "0x0p-1022"); // 0x0.8p-1022: tie, to even
+    t_(3.5, 0, "0x2p+1"); // 0x1.cp+1
+    t_(1.5, 3, "0x1.800p+0");
+    t_(0.1, 3, "0x1.99ap-4");
+    t_(0.1, 20, "0x1.999999999999a0000000p-4");
+    t_(1.03125, 1, "0x1.0p+0"); // 0x1.08: tie, to even
+    t_(1.09375, 1, "0x1.2p+0"); // 0x1.18: tie, to even
+    t_(1.96875, 1, "0x2.0p+0"); // 0x1.f8: carries into the leading digit
+    t_(std::numeric_limits<double>::denorm_min(), 2, "0x0.00p-1022");
+}
+
+TEST_CASE("ftoa.hexa")
+{
+    char bufc[64];
+    substr buf = bufc;
+    auto t_ = [&](float f, int precision, csubstr expected){
+        INFO("expected=" << expected);
+        const size_t ret = ftoa(buf, f, precision, FTOA_HEXA);
+        REQUIRE_LE(ret, buf.len);
+        CHECK_EQ(buf.first(ret), expected);
+    };
+    t_(0.f, -1, "0x0p+0");
+    t_(1.f, -1, "0x1p+0");
+    t_(0.1f, -1, "0x1.99999ap-4");
+    t_(-1.1234123f, -1, "-0x1.1f97f2p+0");
+    t_(std::numeric_limits<float>::max(), -1, "0x1.fffffep+127");
+    t_(std::numeric_limits<float>::min(), -1, "0x1p-126");
+    t_(std::numeric_limits<float>::denorm_min(), -1, "0x0.000002p-126");
+    t_(std::numeric_limits<float>::infinity(), -1, "inf");
+    t_(0.1f, 2, "0x1.9ap-4");
+    t_(0.1f, 8, "0x1.99999a00p-4");
+}
+
+TEST_CASE_TEMPLATE("atof.hexa", T, float, double)
+{
+    auto t_ = [](csubstr str, double expected){
+        INFO("str='" << str << "'");
+        T val = T(77);
+        CHECK(atox(str, &val));
+        CHECK_EQ(val, T(expected));
+    };
+    t_("0x0p+0", 0.);
+    t_("0x1p+0", 1.);
+    t_("0X1P+0", 1.);
+    t_("-0x1p+1", -2.);
+    t_("0x1.8p+0", 1.5);
+    t_("0x1.8", 1.5);
+    t_("0x.8", 0.5);
+    t_("0x8.", 8.);
+    t_("0x18p-4", 1.5);
+    t_("0x0.18p+4", 1.5);
+    t_("0x00000000000000000000000000001p+0", 1.);
+    t_("0x1.00000000000000000000000000000p+0", 1.);
+    t_("0x1.8p+100000000000", double(std::numeric_limits<T>::infinity()));
+    t_("0x1.8p-100000000000", 0.);
+    t_("-inf", -double(std::numeric_limits<T>::infinity()));
+    t_("infinity", double(std::numeric_limits<T>::infinity()));
+    // correctly rounded, also with many digits
+    if(sizeof(T) == 4)
+    {
+        t_("0x1.000001p+0", 1.); // tie, to even
+        t_("0x1.0000010000000000000000001p+0", double(std::nextafter(1.f, 2.f)));
+        t_("0x1.000003p+0", double(std::nextafter(std::nextafter(1.f, 2.f), 2.f)));
+        t_("0x1p-150", 0.); // tie, to even
+        t_("0x1.0000000000000000001p-150", double(std::numeric_limits<float>::denorm_min()));
+        t_("0x12000a5p-152", std::ldexp(0x12000a8, -152));
+    }
+    else
+    {
+        t_("0x1.00000000000008p+0", 1.); // tie, to even
+        t_("0x1.00000000000008000000000000001p+0", std::nextafter(1., 2.));
+        t_("0x1.00000000000018p+0", std::nextafter(std::nextafter(1., 2.), 2.));
+        t_("0x1p-1075", 0.); // tie, to even
+        t_("0x1.0000000000000000001p-1075", std::numeric_limits<double>::denorm_min());
+        t_("0x0.38e70073cf06210p-1024", std::ldexp(double(UINT64_C(0xe39c01cf3c19)), -1074));
+    }
+    // fail
+    T val;
+    for(csubstr str : {csubstr("0x"), csubstr("0x."), csubstr("0xp1"), csubstr("0x1p"), csubstr("0x1p+"), csubstr("0x1g"), csubstr("0x1.8p1.5"), csubstr("-0x"), csubstr("0x1 ")})
+    {
+        INFO("str='" << str << "'");
+        CHECK_FALSE(atox(str, &val));
+    }
+}
+
+TEST_CASE_TEMPLATE("xtoa.hexa_roundtrip", T, float, double)
+{
+    using U = typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type;
+    char bufc[64];
+    substr buf = bufc;
+    auto check_ = [&](U bits){
+        T val;
+        memcpy(&val, &bits, sizeof(T));
+        const size_t ret = sizeof(T) == 4 ? ftoa(buf, static_cast<float>(val), -1, FTOA_HEXA) : dtoa(buf, static_cast<double>(val), -1, FTOA_HEXA);
+        REQUIRE_LE(ret, buf.len);
+        INFO("str=" << buf.first(ret));
+        T rt;
+        REQUIRE(atox(buf.first(ret), &rt));
+        CHECK_EQ(memcmp(&rt, &val, sizeof(T)), 0); // exact, including nans
+        REQUIRE_EQ(from_chars_first(buf.first(ret), &rt), ret);
+        CHECK_EQ(memcmp(&rt, &val, sizeof(T)), 0);
+    };
+    const U step = U(~U(0) / U(200003));
+    for(U bits = 0; bits < U(~U(0) - step); bits = U(bits + step))
+        check_(bits);
+    // nans with payloads
+    const U exp_mask = sizeof(T) == 4 ? U(0x7f800000u) : U(UINT64_C(0x7ff0000000000000));
+    check_(U(exp_mask | 1u));
+    check_(U(exp_mask | 0x1234u));
+    const U quiet = U(U(1) << (sizeof(T) == 4 ? 22 : 51));
+    check_(U(exp_mask | quiet | 5u));
+    check_(U(~U(0)));
+    T val = {};
+    CHECK(atox("nan(0x5)", &val));
+    CHECK(val != val);
+    CHECK(atox("-nan(abc)", &val)); // not hexadecimal: a quiet nan
+    CHECK(val != val);
+}
+
+
+TEST_CASE("real16.shortest")
+{
+    char bufc[64];
+    substr buf = bufc;
+    auto t_ = [&](uint16_t bits, csubstr flex, csubstr scient){
+        INFO("half bits=" << bits << "  flex=" << flex << "  scient=" << scient);
+        const half v = half::from_bits(bits);
+        size_t ret = ftoa(buf, v);
+        CHECK_EQ(buf.first(ret), flex);
+        ret = ftoa(buf, v, -1, FTOA_SCIENT);
+        CHECK_EQ(buf.first(ret), scient);
+    };
+    auto tb_ = [&](uint16_t bits, csubstr flex, csubstr scient){
+        INFO("bfloat16 bits=" << bits << "  flex=" << flex << "  scient=" << scient);
+        const bfloat16 v = bfloat16::from_bits(bits);
+        size_t ret = ftoa(buf, v);
+        CHECK_EQ(buf.first(ret), flex);
+        ret = ftoa(buf, v, -1, FTOA_SCIENT);
+        CHECK_EQ(buf.first(ret), scient);
+    };
+    // the digits are the shortest for the narrow type, not for the
+    // widened float (eg 0.1 would be 0.099975586 as a float)
+    t_(0x0000, "0", "0e+00");
+    t_(0x8000, "-0", "-0e+00");
+    t_(0x3c00, "1", "1e+00");
+    t_(0x2e66, "0.1", "1e-01");
+    t_(0x3555, "0.3333", "3.333e-01");
+    t_(0x7bff, "65500", "6.55e+04");
+    t_(0x0001, "6e-08", "6e-08");
+    t_(0x0400, "6.104e-05", "6.104e-05");
+    t_(0x7c00, "inf", "inf");
+    t_(0xfc00, "-inf", "-inf");
+    t_(0x7e00, "nan", "nan");
+    tb_(0x0000, "0", "0e+00");
+    tb_(0x3f80, "1", "1e+00");
+    tb_(0x3dcd, "0.1", "1e-01");
+    tb_(0x3eab, "0.334", "3.34e-01");
+    tb_(0xc020, "-2.5", "-2.5e+00");
+    tb_(0x7f7f, "3.39e+38", "3.39e+38");
+    tb_(0x0001, "1e-40", "1e-40");
+    tb_(0x7f80, "inf", "inf");
+    // with a precision, the value is written as a float
+    CHECK_EQ(to_chars_sub(buf, fmt::real(half(0.1f), 3)), "0.100");
+    CHECK_EQ(to_chars_sub(buf, fmt::real(half(0.1f), 9)), "0.099975586");
+    CHECK_EQ(to_chars_sub(buf, fmt::real(bfloat16(0.1f), 5)), "0.10010");
+}
+
+TEST_CASE_TEMPLATE("real16.roundtrip", T, half, bfloat16)
+{
+    char bufc[64];
+    substr buf = bufc;
+    for(uint32_t bits = 0; bits <= 0xffffu; ++bits)
+    {
+        const T v = T::from_bits(static_cast<uint16_t>(bits));
+        const float f = static_cast<float>(v);
+        const bool is_nan = std::isnan(f);
+        if(!is_nan)
+        {
+            // widening is exact
+            REQUIRE_EQ(T(f).bits, v.bits);
+            REQUIRE_EQ(T(static_cast<double>(f)).bits, v.bits);
+        }
+        for(RealFormat_e fmt : {FTOA_FLEX, FTOA_SCIENT})
+        {
+            const size_t ret = ftoa(buf, v, -1, fmt);
+            REQUIRE_LE(ret, buf.len);
+            INFO("bits=" << bits << "  str=" << buf.first(ret));
+            T rt = T::from_bits(0x1234);
+            REQUIRE(from_chars(buf.first(ret), &rt));
+            if(is_nan)
+                CHECK(std::isnan(static_cast<float>(rt)));
+            else
+                CHECK_EQ(rt.bits, v.bits);
+            T rt_first = T::from_bits(0x1234);
+            CHECK_EQ(from_chars_first(buf.first(ret), &rt_first), ret);
+            CHECK_EQ(rt_first.bits, rt.bits);
+        }
+    }
+}
+
+TEST_CASE("real16.correctly_rounded")
+{
+    auto t_ = [](csubstr str, uint16_t half_bits, uint16_t bfloat16_bits){
+        INFO("str=" << str);
+        half h = half::from_bits(0x1234);
+        bfloat16 b = bfloat16::from_bits(0x1234);
+        CHECK(atox(str, &h));
+        CHECK(atox(str, &b));
+        CHECK_EQ(h.bits, half_bits);
+        CHECK_EQ(b.bits, bfloat16_bits);
+        h = half::from_bits(0x1234);
+        b = bfloat16::from_bits(0x1234);
+        CHECK_EQ(from_chars_first(str, &h), str.len);
+        CHECK_EQ(from_chars_first(str, &b), str.len);
+        CHECK_EQ(h.bits, half_bits);
+        CHECK_EQ(b.bits, bfloat16_bits);
+    };
+    // halfway between 2048 and 2050 for half: rounds to even. When
+    // the halfway point is exceeded only beyond the precision of a
+    // double, it must not be rounded twice
+    t_("2049", 0x6800, 0x4500);
+    t_("2049.0000000000000001", 0x6801, 0x4500);
+    // halfway between 256 and 258 for bfloat16
+    t_("257", 0x5c04, 0x4380);
+    t_("257.00000000000000001", 0x5c04, 0x4381);
+    t_("-257.00000000000000001", 0xdc04, 0xc381);
+    // overflow to infinity for half
+    t_("65519", 0x7bff, 0x4780);
+    t_("65520", 0x7c00, 0x4780);
+    // half of the smallest half subnormal
+    t_("0.0000000298023223876953125", 0x0000, 0x3300);
+    t_("0.00000002980232238769531250001", 0x0001, 0x3300);
+    t_("inf", 0x7c00, 0x7f80);
+    t_("-inf", 0xfc00, 0xff80);
+    half h = half::from_bits(0x1234);
+    CHECK_FALSE(atox("abc", &h));
+    CHECK_FALSE(atox("", &h));
+    CHECK_EQ(from_chars_first("1.5e", &h), csubstr::npos);
+    CHECK_EQ(h.bits, 0x1234);
+    CHECK_EQ(from_chars_first("  0.1, 2", &h), 5u);
+    CHECK_EQ(h.bits, 0x2e66);
+    CHECK(atox("nan", &h));
+    CHECK(std::isnan(static_cast<float>(h)));
+}
+
+
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+TEST_CASE("decimal.to_chars")
+{
+    char bufc[64];
+    substr buf = bufc;
+    auto t_ = [&](size_t ret, csubstr expected){
+        REQUIRE_LE(ret, buf.len);
+        CHECK_EQ(buf.first(ret), expected);
+    };
+    t_(to_chars(buf, decimal<4>::from_raw(123456789)), "12345.6789");
+    t_(to_chars(buf, decimal<4>::from_raw(-123456789)), "-12345.6789");
+    t_(to_chars(buf, decimal<4>::from_raw(1)), "0.0001");
+    t_(to_chars(buf, decimal<4>::from_raw(-1)), "-0.0001");
+    t_(to_chars(buf, decimal<4>::from_raw(0)), "0.0000");
+    t_(to_chars(buf, decimal<4>::from_raw(10000)), "1.0000");
+    t_(to_chars(buf, decimal<2>::from_raw(150)), "1.50");
+    t_(to_chars(buf, decimal<0>::from_raw(-42)), "-42");
+    t_(to_chars(buf, decimal<18>::from_raw(INT64_MAX)), "9.223372036854775807");
+    t_(to_chars(buf, decimal<18>::from_raw(INT64_MIN)), "-9.223372036854775808");
+    t_(to_chars(buf, decimal<2>::from_raw(INT64_MIN)), "-92233720368547758.08");
+    t_(xtoa(buf, decimal<3>::from_raw(-5)), "-0.005");
+    // too small a buffer: nothing is written
+    memset(bufc, 'x', sizeof(bufc));
+    CHECK_EQ(to_chars(buf.first(9), decimal<4>::from_raw(123456789)), 10u);
+    CHECK_EQ(buf.first(10), "xxxxxxxxxx");
+}
+
+TEST_CASE("decimal.from_chars")
+{
+    auto t_ = [](csubstr str, int64_t expected){
+        INFO("str='" << str << "'");
+        decimal<4> d = decimal<4>::from_raw(77);
+        CHECK(from_chars(str, &d));
+        CHECK_EQ(d.raw, expected);
+        d = decimal<4>::from_raw(77);
+        CHECK(atox(str, &d));
+        CHECK_EQ(d.raw, expected);
+    };
+    t_("12345.6789", 123456789);
+    t_("-12345.6789", -123456789);
+    t_("12345.67", 123456700);
+    t_("12345", 123450000);
+    t_("12345.", 123450000);
+    t_(".5", 5000);
+    t_("-.5", -5000);
+    t_("0", 0);
+    t_("-0", 0);
+    t_("0.0001", 1);
+    t_("000000000000000000000000012.5", 125000);
+    t_("1.50000000000000000000000000000", 15000); // zeroes beyond the scale
+    t_("922337203685477.5807", INT64_MAX);
+    t_("-922337203685477.5808", INT64_MIN);
+    t_("12345678901234.5678", INT64_C(123456789012345678));
+    auto f_ = [](csubstr str){
+        INFO("str='" << str << "'");
+        decimal<4> d = decimal<4>::from_raw(77);
+        CHECK_FALSE(from_chars(str, &d));
+        CHECK_EQ(d.raw, 77);
+    };
+    f_("");
+    f_("-");
+    f_(".");
+    f_("-.");
+    f_("1.23456"); // too many decimals
+    f_("1.00001");
+    f_("922337203685477.5808"); // out of range
+    f_("-922337203685477.5809");
+    f_("9999999999999999");
+    f_("99999999999999999999999999");
+    f_("1e3");
+    f_("1.2.3");
+    f_("+1");
+    f_("1a");
+    f_(" 1");
+    f_("1 ");
+    f_("0x10");
+    f_(csubstr{});
+    // other scales
+    decimal<0> d0 = {};
+    CHECK(atox("-123", &d0));
+    CHECK_EQ(d0.raw, -123);
+    CHECK(atox("123.000", &d0));
+    CHECK_EQ(d0.raw, 123);
+    CHECK_FALSE(atox("123.5", &d0));
+    decimal<18> d18 = {};
+    CHECK(atox("9.223372036854775807", &d18));
+    CHECK_EQ(d18.raw, INT64_MAX);
+    CHECK(atox("-0.000000000000000001", &d18));
+    CHECK_EQ(d18.raw, -1);
+    CHECK_FALSE(atox("9.223372036854775808", &d18));
+    CHECK_FALSE(atox("10", &d18));
+    // the checked versions tell apart invalid and out of range numbers
+    {
+        auto c_ = [](csubstr str, errc err, size_t consumed){
+            INFO("str='" << str << "'");
+            decimal<2> d = decimal<2>::from_raw(77);
+            parse_result ret = from_chars_checked(str, &d);
+            CHECK_EQ((int)ret.err, (int)err);
+            CHECK_EQ(ret.consumed, consumed);
+            CHECK_EQ(d.raw, 77);
+            ret = from_chars_first_checked(str, &d);
+            CHECK_EQ((int)ret.err, (int)err);
+            CHECK_EQ(ret.consumed, consumed);
+            CHECK_EQ(d.raw, 77);
+        };
+        c_("12345678901234567890.00", errc::result_out_of_range, 23u);
+        c_("-92233720368547758.09", errc::result_out_of_range, 21u);
+        c_("92233720368547758.08", errc::result_out_of_range, 20u);
+        c_("1.2345", errc::invalid_argument, 4u); // nonzero decimals beyond the scale
+        c_("-1.2001", errc::invalid_argument, 6u);
+        c_("-", errc::invalid_argument, 1u);
+        c_(".", errc::invalid_argument, 1u);
+        c_("x", errc::invalid_argument, 0u);
+        decimal<2> d = {};
+        CHECK_UNARY(from_chars_checked("-92233720368547758.08", &d).ok());
+        CHECK_EQ(d.raw, INT64_MIN);
+        CHECK_UNARY(from_chars_checked("1.2300", &d).ok());
+        CHECK_EQ(d.raw, 123);
+        // trailing characters are reported where they start
+        parse_result ret = from_chars_checked("12345678901234567890x", &d);
+        CHECK_EQ((int)ret.err, (int)errc::invalid_argument);
+        CHECK_EQ(ret.consumed, 20u);
+    }
+    // conversion to double
+    CHECK_EQ(static_cast<double>(decimal<2>::from_raw(150)), 1.5);
+    CHECK_EQ(static_cast<double>(decimal<4>::from_raw(-123456789)), -12345.6789);
+}
+
+TEST_CASE("decimal.from_chars_first")
+{
+    auto t_ = [](csubstr str, size_t len, int64_t expected){
+        INFO("str='" << str << "'");
+        decimal<2> d = decimal<2>::from_raw(77);
+        CHECK_EQ(from_chars_first(str, &d), len);
+        CHECK_EQ(d.raw, expected);
+    };
+    t_("1.5", 3, 150);
+    t_("  -1.25,3", 7, -125);
+    t_("10]", 2, 1000);
+    t_("\t0.01 ", 5, 1);
+    t_("", csubstr::npos, 77);
+    t_("  ", csubstr::npos, 77);
+    t_("1.5x", csubstr::npos, 77);
+    t_("1.555", csubstr::npos, 77);
+    t_("1e2", csubstr::npos, 77);
+    // the checked versions tell where the reading stopped
+    decimal<2> d = decimal<2>::from_raw(77);
+    parse_result ret = from_chars_first_checked("  1.5x", &d);
+    CHECK_EQ((int)ret.err, (int)errc::invalid_argument);
+    CHECK_EQ(ret.consumed, 5u);
+    ret = from_chars_first_checked("  1.555", &d);
+    CHECK_EQ((int)ret.err, (int)errc::invalid_argument);
+    CHECK_EQ(ret.consumed, 6u);
+    CHECK_EQ(d.raw, 77);
+    ret = from_chars_checked("-1.25", &d);
+    CHECK_UNARY(ret.ok());
+    CHECK_EQ(ret.consumed, 5u);
+    CHECK_EQ(d.raw, -125);
+    ret = from_chars_checked("1.25 ", &d);
+    CHECK_EQ((int)ret.err, (int)errc::invalid_argument);
+    CHECK_EQ(ret.consumed, 4u);
+}
+
+TEST_CASE("decimal.roundtrip")
+{
+    char bufc[64];
+    substr buf = bufc;
+    uint64_t state = UINT64_C(0x9e3779b97f4a7c15);
+    for(int i = 0; i < 20000; ++i)
+    {
+        state = state * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+        // vary the number of digits
+        const int64_t raw = static_cast<int64_t>(state) >> (state & 63u);
+        const decimal<4> d = decimal<4>::from_raw(raw);
+        const size_t ret = to_chars(buf, d);
+        REQUIRE_LE(ret, buf.len);
+        INFO("str=" << buf.first(ret));
+        decimal<4> rt = {};
+        CHECK(from_chars(buf.first(ret), &rt));
+        CHECK_EQ(rt.raw, raw);
+    }
+}
+
+
 TEST_CASE_TEMPLATE("to_chars.empty_buffer", T, uint8_t, int8_t, uint16_t, int16_t, uint32_t, int32_t, uint64_t, int64_t, void*)
 {
     char buf_[100];
@@ -1418,6 +2865,98 @@ TEST_CASE("from_chars.bool")
     }
 }
 
+TEST_CASE_TEMPLATE("from_chars_first.int", T, uint8_t, int8_t, uint16_t, int16_t, uint32_t, int32_t, uint64_t, int64_t)
+{
+    auto t_ = [](csubstr str, size_t len, int expected){
+        INFO("str='" << str << "'");
+        T val = T(77);
+        CHECK_EQ(from_chars_first(str, &val), len);
+        CHECK_EQ(val, len != csubstr::npos ? T(expected) : T(77));
+    };
+    t_("12", 2, 12);
+    t_("  \t\r\n12", 7, 12);
+    t_("12 34", 2, 12);
+    t_("12,34", 2, 12);
+    t_("12;", 2, 12);
+    t_("12]", 2, 12);
+    t_("12)", 2, 12);
+    t_("12}", 2, 12);
+    t_(csubstr("1234").first(3), 3, 123);
+    t_("0012", 4, 12);
+    t_("0x1f,", 4, 31);
+    t_("0X1F", 4, 31);
+    t_("0b101 ", 5, 5);
+    t_("0o17]", 4, 15);
+    // the base prefix is recognized only at the start of the number
+    t_("5,0x", 1, 5);
+    t_("5,0b2", 1, 5);
+    t_("", csubstr::npos, 0);
+    t_("  ", csubstr::npos, 0);
+    t_("+12", csubstr::npos, 0);
+    t_("12a", csubstr::npos, 0);
+    t_("12.5", csubstr::npos, 0);
+    t_("0x", csubstr::npos, 0);
+    t_("0x,", csubstr::npos, 0);
+    t_("0xg", csubstr::npos, 0);
+    t_("0b2", csubstr::npos, 0);
+    t_("0o8", csubstr::npos, 0);
+    t_("-", csubstr::npos, 0);
+    if C4_IF_CONSTEXPR (std::is_signed<T>::value)
+    {
+        t_("-12", 3, -12);
+        t_(" -12,", 4, -12);
+        t_("-0x1f", 5, -31);
+        t_("--12", csubstr::npos, 0);
+    }
+    else
+    {
+        t_("-12", csubstr::npos, 0);
+        t_("-0x1f", csubstr::npos, 0);
+    }
+}
+
+TEST_CASE_TEMPLATE("from_chars_first.real", T, float, double)
+{
+    auto t_ = [](csubstr str, size_t len, double expected){
+        INFO("str='" << str << "'");
+        T val = T(77);
+        CHECK_EQ(from_chars_first(str, &val), len);
+        CHECK_EQ(val, len != csubstr::npos ? T(expected) : T(77));
+    };
+    t_("1.5", 3, 1.5);
+    t_("  \t\r\n1.5", 8, 1.5);
+    t_("-1.5 2", 4, -1.5);
+    t_("1.5,2", 3, 1.5);
+    t_("1.5;", 3, 1.5);
+    t_("1.5]", 3, 1.5);
+    t_("1e3)", 3, 1000.);
+    t_("1.25e-2}", 7, 0.0125);
+    t_(csubstr("1.25").first(3), 3, 1.2);
+    t_("12", 2, 12.);
+    t_("", csubstr::npos, 0.);
+    t_("  ", csubstr::npos, 0.);
+    t_("a", csubstr::npos, 0.);
+    t_("1.5a", csubstr::npos, 0.);
+    // the whole number must be read
+    t_("1.5e", csubstr::npos, 0.);
+    t_("1.5e+", csubstr::npos, 0.);
+    t_("1.2.3", csubstr::npos, 0.);
+    t_("1-", csubstr::npos, 0.);
+    T val = {};
+    CHECK_EQ(from_chars_first(" inf,", &val), 4u);
+    CHECK_EQ(val, std::numeric_limits<T>::infinity());
+    CHECK_EQ(from_chars_first("-infinity]", &val), 9u);
+    CHECK_EQ(val, -std::numeric_limits<T>::infinity());
+    CHECK_EQ(from_chars_first("nan", &val), 3u);
+    CHECK(val != val);
+    // hexadecimal
+    t_("0x1.8p+1,", 8, 3.);
+    t_(" -0x1p-2 ", 8, -0.25);
+    t_("0x10]", 4, 16.);
+    t_("0x1p", csubstr::npos, 0.);
+    t_("0x1.8p+1z", csubstr::npos, 0.);
+}
+
 TEST_CASE("from_chars_first.bool")
 {
     bool result = false;
@@ -1771,6 +3310,83 @@ TEST_CASE("from_chars_first.ptr")
     test_from_chars_first_ptr<std::vector<int>>("std::vector<int>");
 }
 
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<class T>
+void test_max_chars_extremes()
+{
+    char bufc[128];
+    substr buf(bufc, sizeof(bufc));
+    const T vals[] = {T(0), T(1), T(-1), std::numeric_limits<T>::min(), std::numeric_limits<T>::max()};
+    size_t longest = 0;
+    for(T v : vals)
+    {
+        size_t ret = to_chars(buf, v);
+        CHECK_LE(ret, (size_t)max_chars<T>::value);
+        CHECK_EQ(to_chars_bound(v), (size_t)max_chars<T>::value);
+        longest = ret > longest ? ret : longest;
+    }
+    // the bound is tight
+    CHECK_EQ(longest, (size_t)max_chars<T>::value);
+}
+
+TEST_CASE("max_chars.int")
+{
+    CHECK_EQ((size_t)max_chars<uint8_t>::value, 3u);
+    CHECK_EQ((size_t)max_chars<int8_t>::value, 4u);
+    CHECK_EQ((size_t)max_chars<uint16_t>::value, 5u);
+    CHECK_EQ((size_t)max_chars<int16_t>::value, 6u);
+    CHECK_EQ((size_t)max_chars<uint32_t>::value, 10u);
+    CHECK_EQ((size_t)max_chars<int32_t>::value, 11u);
+    CHECK_EQ((size_t)max_chars<uint64_t>::value, 20u);
+    CHECK_EQ((size_t)max_chars<int64_t>::value, 20u);
+    test_max_chars_extremes<uint8_t>();
+    test_max_chars_extremes<int8_t>();
+    test_max_chars_extremes<uint16_t>();
+    test_max_chars_extremes<int16_t>();
+    test_max_chars_extremes<uint32_t>();
+    test_max_chars_extremes<int32_t>();
+    test_max_chars_extremes<uint64_t>();
+    test_max_chars_extremes<int64_t>();
+    test_max_chars_extremes<int>();
+    test_max_chars_extremes<long>();
+    test_max_chars_extremes<long long>();
+    test_max_chars_extremes<unsigned long long>();
+#if C4CORE_HAVE_INT128
+    CHECK_EQ((size_t)max_chars<detail::u128>::value, 39u);
+    CHECK_EQ((size_t)max_chars<detail::i128>::value, 40u);
+#endif
+}
+
+TEST_CASE("max_chars.other")
+{
+    char bufc[128];
+    substr buf(bufc, sizeof(bufc));
+    CHECK_EQ((size_t)max_chars<bool>::value, 1u);
+    CHECK_EQ((size_t)max_chars<char>::value, 1u);
+    CHECK_EQ((size_t)max_chars<char[6]>::value, 5u);
+    CHECK_EQ(to_chars_bound("hello"), 5u);
+    CHECK_EQ(to_chars_bound((const char*)"hello"), 5u);
+    CHECK_EQ(to_chars_bound(csubstr("hello")), 5u);
+    CHECK_EQ(to_chars_bound(std::string("hello")), 5u);
+    CHECK_EQ(to_chars(buf, (int*)INTPTR_MIN), to_chars_bound((int*)-1));
+    CHECK_LE(to_chars(buf, (void*)&buf), to_chars_bound((void*)&buf));
+    CHECK_LE(to_chars(buf, half(-65504.f)), (size_t)max_chars<half>::value);
+    CHECK_LE(to_chars(buf, bfloat16(-3.3895e38f)), (size_t)max_chars<bfloat16>::value);
+    CHECK_LE(to_chars(buf, bfloat16(-1.2e-38f)), (size_t)max_chars<bfloat16>::value);
+    CHECK_EQ(to_chars(buf, decimal<4>::from_raw(INT64_MIN)), 21u);
+    CHECK_LE(to_chars(buf, decimal<4>::from_raw(INT64_MIN)), (size_t)max_chars<decimal<4>>::value);
+    CHECK_LE(to_chars(buf, decimal<0>::from_raw(INT64_MIN)), (size_t)max_chars<decimal<0>>::value);
+    CHECK_LE(to_chars(buf, decimal<18>::from_raw(INT64_MIN)), (size_t)max_chars<decimal<18>>::value);
+    // types without a bound
+    CHECK_UNARY(detail::has_max_chars<double>::value);
+    CHECK_UNARY(detail::has_max_chars<csubstr>::value);
+    CHECK_UNARY_FALSE(detail::has_max_chars<std::vector<int>>::value);
+}
+
 } // namespace c4
 
 #ifdef __clang__
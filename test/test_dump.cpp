@@ -1119,6 +1119,150 @@ TEST_CASE_TEMPLATE("format_dump", T, CatDumpTplArg, CatDumpFnArg)
 }
 
 
+TEST_CASE_TEMPLATE("format_dump.ct", T, CatDumpTplArg, CatDumpFnArg)
+{
+    using namespace buffers;
+    size_t needed_size;
+    substr buf = DumpChecker::s_workspace;
+    auto accum = [&]{ return csubstr(DumpChecker::s_accum).first(DumpChecker::s_accum_pos); };
+    SUBCASE("strings")
+    {
+        DumpChecker::s_reset();
+        needed_size = T::call_format_dump(buf.first(1), C4_FMT("{}-{}-{}-{}"), "1", "22", "333", "4444");
+        CHECK_EQ(needed_size, 0);
+        CHECK_EQ(DumpChecker::s_num_calls, 7);
+        CHECK_EQ(accum(), csubstr("1-22-333-4444"));
+    }
+    SUBCASE("no args")
+    {
+        DumpChecker::s_reset();
+        needed_size = T::call_format_dump(buf, C4_FMT("01234567890123456789"));
+        CHECK_EQ(needed_size, 0);
+        CHECK_EQ(DumpChecker::s_num_calls, 1);
+        CHECK_EQ(accum(), csubstr("01234567890123456789"));
+    }
+    SUBCASE("empty segments are not dumped")
+    {
+        DumpChecker::s_reset();
+        needed_size = T::call_format_dump(buf, C4_FMT("{}{}_{}"), b1, b2, b3);
+        CHECK_EQ(needed_size, 3);
+        CHECK_EQ(DumpChecker::s_num_calls, 4);
+        CHECK_EQ(accum(), csubstr("122_333"));
+    }
+    SUBCASE("small buffer")
+    {
+        DumpChecker::s_reset();
+        needed_size = T::call_format_dump(buf.first(0), C4_FMT("a{}b{}c{}d{}e"), b1, b2, b3, b4);
+        CHECK_EQ(needed_size, 4);
+        CHECK_EQ(DumpChecker::s_num_calls, 0);
+        DumpChecker::s_reset();
+        needed_size = T::call_format_dump(buf.first(2), C4_FMT("a{}b{}c{}d{}e"), b1, b2, b3, b4);
+        CHECK_EQ(needed_size, 4);
+        CHECK_EQ(accum(), csubstr("a1b22c"));
+        DumpChecker::s_reset();
+        needed_size = T::call_format_dump(buf, C4_FMT("a{}b{}c{}d{}e"), b1, b2, b3, b4);
+        CHECK_EQ(needed_size, 4);
+        CHECK_EQ(accum(), csubstr("a1b22c333d4444e"));
+    }
+}
+
+
+TEST_CASE_TEMPLATE("format_dump.compiled", T, CatDumpTplArg, CatDumpFnArg)
+{
+    using namespace buffers;
+    size_t needed_size;
+    substr buf = DumpChecker::s_workspace;
+    auto accum = [&]{ return csubstr(DumpChecker::s_accum).first(DumpChecker::s_accum_pos); };
+    compiled_format cf("{1}-{0}-{1}-{}");
+    SUBCASE("strings")
+    {
+        DumpChecker::s_reset();
+        needed_size = T::call_format_dump(buf.first(1), cf, "1", "22");
+        CHECK_EQ(needed_size, 0);
+        CHECK_EQ(DumpChecker::s_num_calls, 7);
+        CHECK_EQ(accum(), csubstr("22-1-22-1"));
+    }
+    SUBCASE("missing args")
+    {
+        DumpChecker::s_reset();
+        needed_size = T::call_format_dump(buf, cf, b1);
+        CHECK_EQ(needed_size, 1);
+        CHECK_EQ(accum(), csubstr("{1}-1-{1}-1"));
+    }
+    SUBCASE("small buffer")
+    {
+        DumpChecker::s_reset();
+        needed_size = T::call_format_dump(buf.first(0), cf, b3, b1);
+        CHECK_EQ(needed_size, 3);
+        CHECK_EQ(DumpChecker::s_num_calls, 0);
+        DumpChecker::s_reset();
+        needed_size = T::call_format_dump(buf.first(2), cf, b3, b1);
+        CHECK_EQ(needed_size, 3);
+        CHECK_EQ(accum(), csubstr("1-"));
+        DumpChecker::s_reset();
+        needed_size = T::call_format_dump(buf, cf, b3, b1);
+        CHECK_EQ(needed_size, 3);
+        CHECK_EQ(accum(), csubstr("1-333-1-333"));
+    }
+}
+
+
+TEST_CASE("format_dump.erased_args")
+{
+    using namespace buffers;
+    size_t needed_size;
+    substr buf = DumpChecker::s_workspace;
+    auto accum = [&]{ return csubstr(DumpChecker::s_accum).first(DumpChecker::s_accum_pos); };
+    SUBCASE("vcat_dump")
+    {
+        DumpChecker::s_reset();
+        needed_size = vcat_dump(&DumpChecker::s_dump, buf.first(0), make_format_args(b1, b2, b3, b4));
+        CHECK_EQ(needed_size, 4);
+        CHECK_EQ(DumpChecker::s_num_calls, 0);
+        DumpChecker::s_reset();
+        needed_size = vcat_dump(&DumpChecker::s_dump, buf.first(2), make_format_args(b1, "-", b2, b3, b4));
+        CHECK_EQ(needed_size, 4);
+        CHECK_EQ(accum(), csubstr("1-22"));
+        DumpChecker::s_reset();
+        needed_size = vcat_dump(&DumpChecker::s_dump, buf, make_format_args(b1, "-", b2, b3, b4));
+        CHECK_EQ(needed_size, 4);
+        CHECK_EQ(accum(), csubstr("1-223334444"));
+    }
+    SUBCASE("vcatsep_dump")
+    {
+        DumpChecker::s_reset();
+        needed_size = vcatsep_dump(&DumpChecker::s_dump, buf.first(2), make_format_arg(sep), make_format_args(b1, b2, b3));
+        CHECK_EQ(needed_size, seplen);
+        CHECK_EQ(accum(), csubstr("1"));
+        DumpChecker::s_reset();
+        needed_size = vcatsep_dump(&DumpChecker::s_dump, buf, make_format_arg(sep), make_format_args(b1, b2, b3));
+        CHECK_EQ(needed_size, seplen);
+        CHECK_EQ(accum(), csubstr("1900092290009333"));
+        DumpChecker::s_reset();
+        needed_size = vcatsep_dump(&DumpChecker::s_dump, buf.first(1), make_format_arg(", "), make_format_args("a", "b"));
+        CHECK_EQ(needed_size, 0);
+        CHECK_EQ(DumpChecker::s_num_calls, 3);
+        CHECK_EQ(accum(), csubstr("a, b"));
+    }
+    SUBCASE("vformat_dump")
+    {
+        DumpChecker::s_reset();
+        needed_size = vformat_dump(&DumpChecker::s_dump, buf.first(1), "{}-{}-{}-{}", make_format_args("1", "22", "333", "4444"));
+        CHECK_EQ(needed_size, 0);
+        CHECK_EQ(DumpChecker::s_num_calls, 7);
+        CHECK_EQ(accum(), csubstr("1-22-333-4444"));
+        DumpChecker::s_reset();
+        needed_size = vformat_dump(&DumpChecker::s_dump, buf.first(2), "a{}b{}c{}d{}e", make_format_args(b1, b2, b3, b4));
+        CHECK_EQ(needed_size, 4);
+        CHECK_EQ(accum(), csubstr("a1b22c"));
+        DumpChecker::s_reset();
+        needed_size = vformat_dump(&DumpChecker::s_dump, buf, "a{}b{}c{}d{}e", make_format_args(b1, b2));
+        CHECK_EQ(needed_size, 2);
+        CHECK_EQ(accum(), csubstr("a1b22c{}d{}e"));
+    }
+}
+
+
 TEST_CASE_TEMPLATE("format_dump_resume", T, CatDumpTplArg, CatDumpFnArg)
 {
     using namespace buffers;
@@ -1209,6 +1353,100 @@ TEST_CASE_TEMPLATE("format_dump_resume", T, CatDumpTplArg, CatDumpFnArg)
     }
 }
 
+
+//-----------------------------------------------------------------------------
+
+namespace {
+struct sink_recorder
+{
+    std::string *log; // each call to the sink is recorded between brackets
+    void operator() (csubstr s) const { log->append("["); log->append(s.str, s.len); log->append("]"); }
+};
+} // anon namespace
+
+TEST_CASE("dump_buffer.batches")
+{
+    std::string log;
+    char mem[16];
+    {
+        dump_buffer<sink_recorder> out(substr(mem, sizeof(mem)), sink_recorder{&log});
+        CHECK_EQ(out.capacity(), 16u);
+        CHECK_EQ(out.cat("a=", 1, '\n'), 0u);
+        CHECK_EQ(out.catsep(',', 2, 3, 4), 0u);
+        CHECK_EQ(out.format("{}+{}\n", 5, 6), 0u);
+        CHECK_EQ(log, ""); // nothing was flushed yet
+        CHECK_EQ(out.buffered(), "a=1\n2,3,45+6\n");
+        // this record does not fit: only the previous records are flushed
+        CHECK_EQ(out.format("x={}\n", 789), 0u);
+        CHECK_EQ(log, "[a=1\n2,3,45+6\n]");
+        CHECK_EQ(out.buffered(), "x=789\n");
+        out.flush();
+        CHECK_EQ(log, "[a=1\n2,3,45+6\n][x=789\n]");
+        CHECK_EQ(out.buffered(), "");
+        out.flush(); // nothing to flush
+        CHECK_EQ(log, "[a=1\n2,3,45+6\n][x=789\n]");
+        out.cat("end");
+    }
+    // the destructor flushes
+    CHECK_EQ(log, "[a=1\n2,3,45+6\n][x=789\n][end]");
+}
+
+TEST_CASE("dump_buffer.records_are_whole")
+{
+    std::string log;
+    char mem[8];
+    dump_buffer<sink_recorder> out(substr(mem, sizeof(mem)), sink_recorder{&log});
+    out.cat("abc");
+    // the record is split across two writes into the buffer;
+    // the first part must not be flushed before the second
+    out.cat(12, "345", 6);
+    CHECK_EQ(log, "[abc]");
+    CHECK_EQ(out.buffered(), "123456");
+    out.format("{}{}", 1234, 5678);
+    CHECK_EQ(log, "[abc][123456]");
+    CHECK_EQ(out.buffered(), "12345678");
+    // a record larger than the buffer is flushed in pieces
+    out.cat("ab", "cdef", "ghij");
+    CHECK_EQ(log, "[abc][123456][12345678][abcdef]");
+    CHECK_EQ(out.buffered(), "ghij");
+}
+
+TEST_CASE("dump_buffer.passthrough")
+{
+    std::string log;
+    char mem[8];
+    dump_buffer<sink_recorder> out(substr(mem, sizeof(mem)), sink_recorder{&log});
+    out.cat("ab");
+    csubstr large = "0123456789";
+    out.cat(large, 1);
+    // the buffered characters are flushed before the large string,
+    // which is given to the sink without being copied
+    CHECK_EQ(log, "[ab][0123456789]");
+    CHECK_EQ(out.buffered(), "1");
+    // arguments which are not strings cannot pass through: they
+    // are skipped, and the size they need is returned
+    CHECK_EQ(out.cat('a', fmt::zpad(1, 10), 'b'), 10u);
+    CHECK_EQ(out.buffered(), "1ab");
+    CHECK_EQ(log, "[ab][0123456789]");
+}
+
+TEST_CASE("dump_buffer.as_dumper")
+{
+    std::string log;
+    char mem[12];
+    char scratch[8];
+    dump_buffer<sink_recorder> out(substr(mem, sizeof(mem)), sink_recorder{&log});
+    size_t ret = cat_dump(out, scratch, "a=", 1, ", b=", 2.5, '\n');
+    CHECK_EQ(ret, 3u);
+    CHECK_EQ(log, "");
+    CHECK_EQ(out.buffered(), "a=1, b=2.5\n");
+    // each dumped piece is a record
+    ret = format_dump(out, scratch, "{}-{}\n", 3, 4);
+    CHECK_EQ(ret, 1u);
+    CHECK_EQ(log, "[a=1, b=2.5\n3]");
+    CHECK_EQ(out.buffered(), "-4\n");
+}
+
 } // namespace c4
 
 #ifdef __clang__
@@ -206,6 +206,44 @@ TEST_CASE_TEMPLATE("to_chars.fmt.real", T, float, double)
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 
+TEST_CASE("to_chars.fmt.decimal")
+{
+    char bufc[64];
+    substr buf = bufc;
+    auto t_ = [&](size_t ret, csubstr expected){
+        REQUIRE_LE(ret, buf.len);
+        CHECK_EQ(buf.first(ret), expected);
+    };
+    const decimal<4> d = decimal<4>::from_raw(123456789);
+    t_(to_chars(buf, fmt::real(d, 4)), "12345.6789");
+    t_(to_chars(buf, fmt::real(d, -1)), "12345.6789");
+    t_(to_chars(buf, fmt::real(d, 2)), "12345.68");
+    t_(to_chars(buf, fmt::real(d, 0)), "12346");
+    t_(to_chars(buf, fmt::real(d, 6)), "12345.678900");
+    t_(to_chars(buf, fmt::zpad(d, 8)), "00012345.6789");
+    t_(to_chars(buf, fmt::zpad(d, 3)), "12345.6789");
+    t_(to_chars(buf, fmt::zpad(fmt::real(d, 1), 7)), "0012345.7");
+    const decimal<4> n = decimal<4>::from_raw(-1250);
+    t_(to_chars(buf, fmt::zpad(n, 3)), "-000.1250");
+    // ties to even
+    t_(to_chars(buf, fmt::real(n, 2)), "-0.12");
+    t_(to_chars(buf, fmt::real(decimal<4>::from_raw(-1350), 2)), "-0.14");
+    t_(to_chars(buf, fmt::real(decimal<4>::from_raw(-1351), 2)), "-0.14");
+    t_(to_chars(buf, fmt::real(decimal<4>::from_raw(-49), 2)), "0.00");
+    t_(to_chars(buf, fmt::real(decimal<2>::from_raw(250), 0)), "2");
+    t_(to_chars(buf, fmt::real(decimal<2>::from_raw(350), 0)), "4");
+    t_(to_chars(buf, fmt::real(decimal<0>::from_raw(7), 2)), "7.00");
+    t_(to_chars(buf, fmt::real(decimal<18>::from_raw(INT64_MIN), 0)), "-9");
+    // cat and unformat
+    std::string s = catrs<std::string>(decimal<2>::from_raw(199), ' ', fmt::real(d, 1));
+    CHECK_EQ(s, "1.99 12345.7");
+    decimal<2> a = {};
+    decimal<4> b = {};
+    CHECK_NE(unformat(to_csubstr(s), "{} {}", a, b), csubstr::npos);
+    CHECK_EQ(a.raw, 199);
+    CHECK_EQ(b.raw, 123457000);
+}
+
 TEST_CASE("to_chars.fmt.boolalpha")
 {
     char bufc[128];
@@ -241,6 +279,28 @@ TEST_CASE("align.right.overflow")
     CHECK_EQ(to_chars(substr(), fmt::right("0123456789.123456789.123456789.123456789", 30u)), 40u);
 }
 
+TEST_CASE("align.small_buffer")
+{
+    char buf_[8];
+    // the value fits, but not the field: no writes beyond the buffer
+    memset(buf_, '?', sizeof(buf_));
+    CHECK_EQ(to_chars(substr(buf_, 6), fmt::left(1234, 10, '+')), 10u);
+    CHECK_EQ(csubstr(buf_, 8), "1234++??");
+    memset(buf_, '?', sizeof(buf_));
+    CHECK_EQ(to_chars(substr(buf_, 6), fmt::right(1234, 10, '+')), 10u);
+    CHECK_EQ(csubstr(buf_, 8).sub(6), "??");
+    // the field fits exactly
+    memset(buf_, '?', sizeof(buf_));
+    CHECK_EQ(to_chars(substr(buf_, 6), fmt::left(-12, 6, '+')), 6u);
+    CHECK_EQ(csubstr(buf_, 8), "-12+++??");
+    memset(buf_, '?', sizeof(buf_));
+    CHECK_EQ(to_chars(substr(buf_, 6), fmt::right(-12, 6, '+')), 6u);
+    CHECK_EQ(csubstr(buf_, 8), "+++-12??");
+    memset(buf_, '?', sizeof(buf_));
+    CHECK_EQ(to_chars(substr(buf_, 6), fmt::right(fmt::real(1.5, 2), 6)), 6u);
+    CHECK_EQ(csubstr(buf_, 8), "  1.50??");
+}
+
 TEST_CASE("align.left")
 {
     char buf[128] = {};
@@ -415,6 +475,21 @@ TEST_CASE("uncat.vars")
     CHECK_EQ(v4, 4);
 }
 
+TEST_CASE("uncat.overflow_checked")
+{
+    size_t npos = csubstr::npos;
+    uint8_t v1 = 0, v2 = 0;
+    errc err = errc::ok;
+    auto checked = fmt::overflow_checked(v1, &err);
+    CHECK_EQ(uncat("255 7", checked, v2), 5);
+    CHECK_EQ((int)err, (int)errc::ok);
+    CHECK_EQ(v1, 255);
+    CHECK_EQ(v2, 7);
+    CHECK_EQ(uncat("256 7", checked, v2), npos);
+    CHECK_EQ((int)err, (int)errc::result_out_of_range);
+    CHECK_EQ(v1, 255);
+}
+
 #ifdef C4_TUPLE_TO_STR
 TEST_CASE("uncat.tuple")
 {
@@ -581,6 +656,54 @@ TEST_CASE("format.empty_buffer")
              format({} , "a={} foo {} {} bar {}", 101, 10, 11, 12));
 }
 
+TEST_CASE("format.ct")
+{
+    char buf_[256];
+    substr buf(buf_, sizeof(buf_));
+    size_t sz;
+
+    auto fmt4 = C4_FMT("{} and {} and {} and {}");
+    auto fmt0 = C4_FMT("no args");
+    auto fmt1 = C4_FMT("{{}}}{");
+    static_assert(ct_fmt_num_args<decltype(fmt4)>::value == 4, "");
+    static_assert(ct_fmt_num_args<decltype(fmt0)>::value == 0, "");
+    static_assert(ct_fmt_num_args<decltype(fmt1)>::value == 1, "");
+
+    sz = format(buf, fmt4, 1, 2, 3, 4);
+    CHECK_EQ(buf.first(sz), "1 and 2 and 3 and 4");
+    sz = format(buf, C4_FMT("{} args only at the begin"), 1);
+    CHECK_EQ(buf.first(sz), "1 args only at the begin");
+    sz = format(buf, C4_FMT("args only at the end {}"), 1);
+    CHECK_EQ(buf.first(sz), "args only at the end 1");
+    sz = format(buf, C4_FMT("{}{}{}"), 1, csubstr("22"), 3.5);
+    CHECK_EQ(buf.first(sz), "1223.5");
+    sz = format(buf, fmt0);
+    CHECK_EQ(buf.first(sz), "no args");
+    sz = format(buf, C4_FMT(""));
+    CHECK_EQ(sz, 0u);
+    sz = format(buf, fmt1, 1);
+    CHECK_EQ(buf.first(sz), "{1}}{");
+    // the same results as the runtime format
+    const auto fmt = C4_FMT("a={} foo {} {} bar {}");
+    CHECK_EQ(to_csubstr(fmt), "a={} foo {} {} bar {}");
+    CHECK_EQ(format(buf, fmt, 101, 10, 11, 12),
+             format(buf, to_csubstr(fmt), 101, 10, 11, 12));
+    CHECK_EQ(format({}, fmt, 101, 10, 11, 12),
+             format(buf, fmt, 101, 10, 11, 12));
+    CHECK_EQ(format_sub(buf, fmt, 101, 10, 11, 12), "a=101 foo 10 11 bar 12");
+    // a long format string
+    sz = format(buf, C4_FMT("0123456789012345678901234567890123456789012345678901234567890123456789"
+                            "0123456789012345678901234567890123456789012345678901234567890123456789"
+                            "{}"), 1);
+    CHECK_EQ(sz, 141u);
+    CHECK_EQ(buf[140], '1');
+    // the buffer size is respected
+    char small_[6] = {'+', '+', '+', '+', '+', '+'};
+    sz = format(substr(small_, 5), C4_FMT("a={} b={}"), 10, 20);
+    CHECK_EQ(sz, 9u);
+    CHECK_EQ(csubstr(small_, 6), "a=10 +");
+}
+
 #ifdef C4_TUPLE_TO_STR
 TEST_CASE("format.tuple")
 {
@@ -621,6 +744,126 @@ TEST_CASE("format.tuple")
 }
 #endif // C4_TUPLE_TO_STR
 
+TEST_CASE("format.compiled")
+{
+    char buf_[256];
+    substr buf(buf_, sizeof(buf_));
+    size_t sz;
+
+    compiled_format cf("{} and {} and {} and {}");
+    CHECK_EQ(cf.num_slots(), 5u);
+    CHECK_EQ(cf.num_args(), 4u);
+    sz = format(buf, cf, 1, 2, 3, 4);
+    CHECK_EQ(buf.first(sz), "1 and 2 and 3 and 4");
+    // the same results as the runtime format
+    sz = format(buf, cf, 1, 2, 3, 4, 5, 6, 7);
+    CHECK_EQ(buf.first(sz), "1 and 2 and 3 and 4");
+    sz = format(buf, cf, 1, 2);
+    CHECK_EQ(buf.first(sz), "1 and 2 and {} and {}");
+    sz = format(buf, cf);
+    CHECK_EQ(buf.first(sz), "{} and {} and {} and {}");
+    CHECK_EQ(format({}, cf, 1, 2, 3, 4), 19u);
+    CHECK_EQ(format_sub(buf, cf, 10, 20, 30, 40), "10 and 20 and 30 and 40");
+
+    SUBCASE("positional")
+    {
+        cf.compile("{1} {0} {1}, {} {}");
+        CHECK_EQ(cf.num_slots(), 6u);
+        CHECK_EQ(cf.num_args(), 2u);
+        CHECK_EQ(format_sub(buf, cf, "a", "b"), "b a b, a b");
+        CHECK_EQ(format_sub(buf, cf, "a"), "{1} a {1}, a {}");
+        cf.compile("{10}{2}");
+        CHECK_EQ(cf.num_args(), 11u);
+        CHECK_EQ(format_sub(buf, cf, 0, 1, 2), "{10}2");
+    }
+    SUBCASE("not placeholders")
+    {
+        cf.compile("{x} {1x} {-1} {{}} {");
+        CHECK_EQ(cf.num_slots(), 2u);
+        CHECK_EQ(cf.num_args(), 1u);
+        CHECK_EQ(format_sub(buf, cf, 7), "{x} {1x} {-1} {7} {");
+        cf.compile("no placeholders");
+        CHECK_EQ(cf.num_slots(), 1u);
+        CHECK_EQ(cf.num_args(), 0u);
+        CHECK_EQ(format_sub(buf, cf, 7), "no placeholders");
+        cf.compile("");
+        CHECK_EQ(format(buf, cf, 7), 0u);
+    }
+    SUBCASE("too many placeholders")
+    {
+        basic_compiled_format<3> small;
+        CHECK(small.compile("{}{}"));
+        CHECK_FALSE(small.compile("{}{}{}"));
+        CHECK_EQ(small.num_slots(), 1u);
+        CHECK_EQ(format(buf, small, 1, 2, 3), 0u);
+    }
+    SUBCASE("small buffer")
+    {
+        char small_[6] = {'+', '+', '+', '+', '+', '+'};
+        cf.compile("a={0} b={0}");
+        sz = format(substr(small_, 5), cf, 10);
+        CHECK_EQ(sz, 9u);
+        CHECK_EQ(csubstr(small_, 6), "a=10 +");
+    }
+}
+
+TEST_CASE("format.erased_args")
+{
+    char buf_[256];
+    substr buf(buf_, sizeof(buf_));
+    size_t sz;
+    const std::string str = "str";
+
+    sz = vcat(buf, make_format_args(1, " and ", csubstr("2"), '+', str, 0.5));
+    CHECK_EQ(buf.first(sz), "1 and 2+str0.5");
+    sz = vcat(buf, make_format_args());
+    CHECK_EQ(sz, 0u);
+    sz = vcatsep(buf, make_format_arg(", "), make_format_args(1, fmt::hex(255), str));
+    CHECK_EQ(buf.first(sz), "1, 0xff, str");
+    sz = vcatsep(buf, make_format_arg('_'), make_format_args(1));
+    CHECK_EQ(buf.first(sz), "1");
+    // the same results as the variadic format
+    sz = vformat(buf, "{} and {} and {} and {}", make_format_args(1, 2, 3, 4));
+    CHECK_EQ(buf.first(sz), "1 and 2 and 3 and 4");
+    sz = vformat(buf, "{} and {} and {} and {}", make_format_args(1, 2, 3, 4, 5, 6, 7));
+    CHECK_EQ(buf.first(sz), "1 and 2 and 3 and 4");
+    sz = vformat(buf, "{} and {} and {} and {}", make_format_args(1, 2));
+    CHECK_EQ(buf.first(sz), "1 and 2 and {} and {}");
+    sz = vformat(buf, "{} and {} and {} and {}", make_format_args());
+    CHECK_EQ(buf.first(sz), "{} and {} and {} and {}");
+    CHECK_EQ(vformat({}, "{} and {} and {} and {}", make_format_args(1, 2, 3, 4)), 19u);
+
+    SUBCASE("format_arg")
+    {
+        int i = 123;
+        format_arg a = make_format_arg(i);
+        CHECK_FALSE(a.is_str());
+        CHECK_EQ(a.to_chars(buf), 3u);
+        CHECK_EQ(buf.first(3), "123");
+        CHECK_EQ(a.to_chars({}), 3u);
+        a = make_format_arg("abc");
+        CHECK(a.is_str());
+        CHECK_EQ(a.str(), "abc");
+        a = make_format_arg(str.c_str());
+        CHECK(a.is_str());
+        CHECK_EQ(a.str(), "str");
+        format_arg arr[] = {make_format_arg(i), make_format_arg("abc")};
+        CHECK_EQ(vcat(buf, arr), 6u);
+        CHECK_EQ(buf.first(6), "123abc");
+    }
+    SUBCASE("small buffer")
+    {
+        char small_[6] = {'+', '+', '+', '+', '+', '+'};
+        sz = vformat(substr(small_, 5), "a={} b={}", make_format_args(10, 20));
+        CHECK_EQ(sz, 9u);
+        CHECK_EQ(csubstr(small_, 6), "a=10 +");
+        sz = vcatsep(substr(small_, 5), make_format_arg(' '), make_format_args(10, 200));
+        CHECK_EQ(sz, 6u);
+        CHECK_EQ(csubstr(small_, 3), "10 ");
+        CHECK_EQ(small_[5], '+');
+    }
+}
+
 TEST_CASE("unformat.vars")
 {
     size_t sz;
@@ -653,6 +896,136 @@ TEST_CASE("unformat.vars")
     CHECK_EQ(v3, 3);
 }
 
+TEST_CASE("unformat.ct")
+{
+    size_t sz;
+    int v1 = 0, v2 = 0, v3 = 0, v4 = 0;
+
+    sz = unformat("1 and 2 and 3 and 4", C4_FMT("{} and {} and {} and {}"), v1, v2, v3, v4);
+    CHECK_EQ(sz, 19);
+    CHECK_EQ(v1, 1);
+    CHECK_EQ(v2, 2);
+    CHECK_EQ(v3, 3);
+    CHECK_EQ(v4, 4);
+
+    v1 = v2 = v3 = 0;
+    sz = unformat("1,2,3,,,", C4_FMT("{},{},{}"), v1, v2, v3);
+    CHECK_EQ(sz, 5);
+    CHECK_EQ(v1, 1);
+    CHECK_EQ(v2, 2);
+    CHECK_EQ(v3, 3);
+
+    v1 = v2 = v3 = 0;
+    sz = unformat("1,2,3,,,", C4_FMT("{},{},{},,,"), v1, v2, v3);
+    CHECK_EQ(sz, 8); // make sure we count the trailing characters in the format
+    CHECK_EQ(v1, 1);
+    CHECK_EQ(v2, 2);
+    CHECK_EQ(v3, 3);
+
+    sz = unformat("a=1,b=x", C4_FMT("a={},b={}"), v1, v2);
+    CHECK_EQ(sz, csubstr::npos);
+}
+
+TEST_CASE("unformat_checked.ct")
+{
+    int v1 = 0;
+    double v2 = 0;
+    csubstr v3;
+    auto fmt = C4_FMT("id={} val={} name=[{}]");
+    unformat_result r;
+
+    r = unformat_checked("id=7 val=1.5 name=[foo bar]", fmt, v1, v2, v3);
+    CHECK(r.ok());
+    CHECK_EQ(r.consumed, 27u);
+    CHECK_EQ(v1, 7);
+    CHECK_EQ(v2, 1.5);
+    CHECK_EQ(v3, "foo bar");
+    // the literals are verified
+    r = unformat_checked("id=7 vaX=1.5 name=[foo]", fmt, v1, v2, v3);
+    CHECK_FALSE(r);
+    CHECK_EQ(r.field, 1u);
+    CHECK_EQ(r.consumed, 4u);
+    // the whole field must be converted
+    r = unformat_checked("id=7x val=1.5 name=[foo]", fmt, v1, v2, v3);
+    CHECK_EQ(r.field, 0u);
+    CHECK_EQ(r.consumed, 3u);
+    r = unformat_checked("id= val=1.5 name=[foo]", fmt, v1, v2, v3);
+    CHECK_EQ(r.field, 0u);
+    // the trailing literal is verified, and the record must span the buffer
+    r = unformat_checked("id=7 val=1.5 name=[foo", fmt, v1, v2, v3);
+    CHECK_EQ(r.field, 2u);
+    r = unformat_checked("id=7 val=1.5 name=[foo]]", fmt, v1, v2, v3);
+    CHECK_EQ(r.field, 3u);
+    CHECK_EQ(r.consumed, 22u);
+    // the last field takes the rest of the buffer
+    int a = 0, b = 0;
+    r = unformat_checked("1,23", C4_FMT("{},{}"), a, b);
+    CHECK(r.ok());
+    CHECK_EQ(a, 1);
+    CHECK_EQ(b, 23);
+    r = unformat_checked("1,23,", C4_FMT("{},{}"), a, b);
+    CHECK_EQ(r.field, 1u);
+    r = unformat_checked("", C4_FMT(""));
+    CHECK(r.ok());
+}
+
+TEST_CASE("unformat_checked.compiled")
+{
+    int v1 = 0, v2 = 0;
+    compiled_format cf("<{1}|{0}>");
+    unformat_result r;
+
+    r = unformat_checked("<1|22>", cf, v1, v2);
+    CHECK(r.ok());
+    CHECK_EQ(v1, 22);
+    CHECK_EQ(v2, 1);
+    r = unformat_checked("<1|22", cf, v1, v2);
+    CHECK_EQ(r.field, 1u);
+    r = unformat_checked("<1|22>>", cf, v1, v2);
+    CHECK_EQ(r.field, 2u);
+    CHECK_EQ(r.consumed, 5u);
+    r = unformat_checked("(1|22)", cf, v1, v2);
+    CHECK_EQ(r.field, 0u);
+    CHECK_EQ(r.consumed, 0u);
+    // a missing argument fails
+    r = unformat_checked("<1|22>", cf, v1);
+    CHECK_EQ(r.field, 0u);
+    // adjacent placeholders are not bounded
+    cf.compile("{}{}");
+    r = unformat_checked("12", cf, v1, v2);
+    CHECK_EQ(r.field, 0u);
+    cf.compile("{} {}");
+    r = unformat_checked("12 345", cf, v1, v2);
+    CHECK(r.ok());
+    CHECK_EQ(v1, 12);
+    CHECK_EQ(v2, 345);
+}
+
+TEST_CASE("unformat_lines")
+{
+    int num = 0;
+    csubstr name;
+    std::string ok, failed;
+    auto fn = [&](size_t line, csubstr, unformat_result r){
+        if(r)
+            catrs(append, &ok, name, num, ' ');
+        else
+            catrs(append, &failed, line, ':', r.field, ' ');
+    };
+    size_t num_ok = unformat_lines("1 a\n2 b\r\nx c\n\n4 d", C4_FMT("{} {}"), fn, num, name);
+    CHECK_EQ(num_ok, 3u);
+    CHECK_EQ(ok, "a1 b2 d4 ");
+    CHECK_EQ(failed, "2:0 3:0 ");
+    // with a compiled format, and a trailing newline
+    ok.clear();
+    failed.clear();
+    compiled_format cf("{1}={0}");
+    num_ok = unformat_lines("a=1\nb=2\nc=3=\n", cf, fn, num, name);
+    CHECK_EQ(num_ok, 2u);
+    CHECK_EQ(ok, "a1 b2 ");
+    CHECK_EQ(failed, "2:1 ");
+}
+
 #ifdef C4_TUPLE_TO_STR
 TEST_CASE("unformat.tuple")
 {
@@ -743,6 +1116,152 @@ TEST_CASE("catrs.const_fwd")
     CHECK_EQ(to_csubstr(buf), "5678");
 }
 
+/** count the calls to to_chars() */
+struct counted_int { int val; };
+struct counted_int_unbounded { int val; };
+size_t num_counted_writes = 0;
+size_t to_chars(substr buf, counted_int v) { ++num_counted_writes; return to_chars(buf, v.val); }
+size_t to_chars(substr buf, counted_int_unbounded v) { ++num_counted_writes; return to_chars(buf, v.val); }
+template<> struct max_chars<counted_int> : public max_chars<int> {};
+
+TEST_CASE("catrs.single_pass")
+{
+    const counted_int a{-123}, b{45678};
+    std::string s;
+    num_counted_writes = 0;
+    catrs(&s, a, ' ', b, " ", 1.5, fmt::real(2.25, 1), csubstr("!"));
+    CHECK_EQ(s, "-123 45678 1.52.2!");
+    CHECK_EQ(num_counted_writes, 2u);
+    num_counted_writes = 0;
+    catrs(append, &s, b, fmt::left(a, 6));
+    CHECK_EQ(s, "-123 45678 1.52.2!45678-123  ");
+    CHECK_EQ(num_counted_writes, 2u);
+    num_counted_writes = 0;
+    catseprs(&s, ", ", a, b);
+    CHECK_EQ(s, "-123, 45678");
+    CHECK_EQ(num_counted_writes, 2u);
+    num_counted_writes = 0;
+    catseprs(append, &s, '/', a, b);
+    CHECK_EQ(s, "-123, 45678-123/45678");
+    CHECK_EQ(num_counted_writes, 2u);
+    s.clear();
+    num_counted_writes = 0;
+    formatrs(&s, "a={} b={}", a, b);
+    CHECK_EQ(s, "a=-123 b=45678");
+    CHECK_EQ(num_counted_writes, 2u);
+    num_counted_writes = 0;
+    formatrs(append, &s, " {}{}", a, b);
+    CHECK_EQ(s, "a=-123 b=45678 -12345678");
+    CHECK_EQ(num_counted_writes, 2u);
+    // without a known bound, only the argument which does not fit
+    // is serialized again
+    const counted_int_unbounded c{-123};
+    s.resize(5);
+    num_counted_writes = 0;
+    catrs(&s, c, b);
+    CHECK_EQ(s, "-12345678");
+    CHECK_EQ(num_counted_writes, 3u);
+}
+
+TEST_CASE("catrs.resume")
+{
+    const counted_int_unbounded c{-123};
+    std::string s;
+    SUBCASE("catrs")
+    {
+        s.resize(10);
+        num_counted_writes = 0;
+        catrs(&s, c, c, c, c);
+        CHECK_EQ(s, "-123-123-123-123");
+        CHECK_EQ(num_counted_writes, 5u);
+        num_counted_writes = 0;
+        csubstr out = catrs(append, &s, c, '+', c);
+        CHECK_EQ(out, "-123+-123");
+        CHECK_EQ(s, "-123-123-123-123-123+-123");
+        CHECK_EQ(num_counted_writes, 3u);
+    }
+    SUBCASE("catseprs")
+    {
+        s.resize(10);
+        num_counted_writes = 0;
+        catseprs(&s, ", ", c, c, c);
+        CHECK_EQ(s, "-123, -123, -123");
+        CHECK_EQ(num_counted_writes, 3u);
+        num_counted_writes = 0;
+        csubstr out = catseprs(append, &s, '/', c, c);
+        CHECK_EQ(out, "-123/-123");
+        CHECK_EQ(s, "-123, -123, -123-123/-123");
+        CHECK_EQ(num_counted_writes, 3u);
+    }
+    SUBCASE("formatrs")
+    {
+        s.resize(10);
+        num_counted_writes = 0;
+        formatrs(&s, "a={} b={} c={}!", c, c, c);
+        CHECK_EQ(s, "a=-123 b=-123 c=-123!");
+        CHECK_EQ(num_counted_writes, 4u);
+        num_counted_writes = 0;
+        csubstr out = formatrs(append, &s, " [{}]", c);
+        CHECK_EQ(out, " [-123]");
+        CHECK_EQ(s, "a=-123 b=-123 c=-123! [-123]");
+        CHECK_EQ(num_counted_writes, 1u);
+    }
+    SUBCASE("empty_container")
+    {
+        std::vector<char> v;
+        num_counted_writes = 0;
+        catrs(&v, c, c, c, c, c, c, c, c);
+        CHECK_EQ(to_csubstr(v), "-123-123-123-123-123-123-123-123");
+        CHECK_LE(num_counted_writes, 12u);
+    }
+}
+
+TEST_CASE("max_chars.fmt")
+{
+    char bufc[1024];
+    substr buf(bufc, sizeof(bufc));
+    auto check = [&](size_t bound, size_t len){
+        CHECK_LE(len, bound);
+    };
+    #define _check(...) check(to_chars_bound(__VA_ARGS__), to_chars(buf, __VA_ARGS__))
+    _check(fmt::boolalpha(false));
+    _check(fmt::integral(INT64_MIN, INT64_C(2)));
+    _check(fmt::integral(INT64_MIN, INT64_C(8)));
+    _check(fmt::integral(INT64_MIN, INT64_C(10)));
+    _check(fmt::integral(INT64_MIN, INT64_C(16)));
+    _check(fmt::integral(UINT64_MAX, UINT64_C(2)));
+    _check(fmt::integral(UINT64_MAX, UINT64_C(8)));
+    _check(fmt::hex(UINT8_MAX));
+    _check(fmt::zpad(INT32_MIN, 30));
+    _check(fmt::zpad(fmt::bin(int8_t(-128)), 10));
+    _check(fmt::real(-DBL_MAX, 3));
+    _check(fmt::real(-DBL_MAX, -1));
+    _check(fmt::real(-FLT_MAX, 3));
+    _check(fmt::real(-5e-324, 2, FTOA_SCIENT));
+    _check(fmt::real(-5e-324, 20, FTOA_FLEX));
+    _check(fmt::real(-1.234e-5, 20, FTOA_FLEX));
+    _check(fmt::real(-5e-324, 30, FTOA_HEXA));
+    _check(fmt::real(-5e-324, -1, FTOA_HEXA));
+    _check(fmt::real(-DBL_MAX, -1, FTOA_HEXA));
+    _check(fmt::real(-std::numeric_limits<double>::denorm_min(), -1, FTOA_FLOAT));
+    _check(fmt::real(decimal<2>::from_raw(INT64_MIN), 10));
+    _check(fmt::real(decimal<2>::from_raw(INT64_MIN), 1));
+    _check(fmt::zpad(decimal<2>::from_raw(INT64_MIN), 25));
+    _check(fmt::left(fmt::real(-DBL_MAX, 3), 10));
+    _check(fmt::right(-12, 10));
+    _check(fmt::right("abc", 2));
+    _check(fmt::craw(buf.first(10), 64));
+    #undef _check
+    CHECK_EQ(to_chars_bound(fmt::left(-12, 10)), 11u);
+    CHECK_EQ(to_chars_bound(fmt::right(-12, 20)), 20u);
+    CHECK_UNARY_FALSE(detail::has_max_chars<fmt::left_<std::vector<int>>>::value);
+    CHECK_EQ((size_t)cat_max_chars<>::value, 0u);
+    CHECK_EQ((size_t)(cat_max_chars<int8_t, char, bool, uint16_t>::value), 11u);
+    char stackbuf[cat_max_chars<int64_t, char, double>::value];
+    csubstr s = cat_sub(substr(stackbuf, sizeof(stackbuf)), INT64_MIN, ',', -1.2345678901234568e-300);
+    CHECK_EQ(s, "-9223372036854775808,-1.2345678901234568e-300");
+}
+
 
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
@@ -925,6 +1444,50 @@ TEST_CASE("formatrs.const_fwd")
     CHECK_EQ(to_csubstr(buf), "Remember gentlemen, it's not just France we are fighting for, it's Champagne!");
 }
 
+TEST_CASE("formatrs.compiled")
+{
+    compiled_format cf("{} goes with food, {} goes with heat, {} anytime");
+    std::string buf;
+    formatrs(&buf, cf, "wine", "beer", "coffee");
+    CHECK_EQ(buf, "wine goes with food, beer goes with heat, coffee anytime");
+    cf.compile("{0}{1}{0}");
+    formatrs(&buf, cf, 1, 2);
+    CHECK_EQ(buf, "121");
+    csubstr out = formatrs(append, &buf, cf, 3, 4);
+    CHECK_EQ(out, "343");
+    CHECK_EQ(buf, "121343");
+    buf = formatrs<std::string>(cf, 1.5, 2);
+    CHECK_EQ(buf, "1.521.5");
+    // repeated arguments are accounted for in the bound
+    cf.compile("{0}{0}{0}{0}");
+    buf.clear();
+    formatrs(&buf, cf, INT64_MIN);
+    CHECK_EQ(buf, "-9223372036854775808-9223372036854775808-9223372036854775808-9223372036854775808");
+    const counted_int_unbounded c{-123};
+    std::vector<char> vbuf;
+    num_counted_writes = 0;
+    formatrs(&vbuf, cf, c);
+    CHECK_EQ(to_csubstr(vbuf), "-123-123-123-123");
+    CHECK_LE(num_counted_writes, 7u);
+}
+
+TEST_CASE("formatrs.ct")
+{
+    std::string buf;
+    formatrs(&buf, C4_FMT("{} goes with food, {} goes with heat, {} anytime"), "wine", "beer", "coffee");
+    CHECK_EQ(buf, "wine goes with food, beer goes with heat, coffee anytime");
+    formatrs(&buf, C4_FMT("{}"), 1);
+    CHECK_EQ(buf, "1");
+    csubstr out = formatrs(append, &buf, C4_FMT(", {}, {}"), 2, 3);
+    CHECK_EQ(out, ", 2, 3");
+    CHECK_EQ(buf, "1, 2, 3");
+    buf = formatrs<std::string>(C4_FMT("{}+{}={}"), 1, 2.5, "3.5");
+    CHECK_EQ(buf, "1+2.5=3.5");
+    std::vector<char> vbuf;
+    formatrs(&vbuf, C4_FMT("a long string to make the container grow: {} {} {}"), 12345678, csubstr("and a long argument"), 3);
+    CHECK_EQ(to_csubstr(vbuf), "a long string to make the container grow: 12345678 and a long argument 3");
+}
+
 
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
@@ -1011,6 +1574,14 @@ template<class T> void test_raw_roundtrip(const char *valstr, T const& orig)
         bool ok = c4::from_chars_first(sbuf, fmt::raw(copy));
         REQUIRE_EQ(ok, true);
         CHECK_EQ(copy, orig);
+        copy = {};
+        parse_result ret = c4::from_chars_checked(sbuf, fmt::raw(copy));
+        REQUIRE_UNARY(ret.ok());
+        CHECK_EQ(ret.consumed, szwrite);
+        CHECK_EQ(copy, orig);
+        ret = c4::from_chars_checked(sbuf.first(szwrite - 1), fmt::raw(copy));
+        CHECK_EQ((int)ret.err, (int)errc::invalid_argument);
+        CHECK_EQ(ret.consumed, szwrite - 1);
 
         // cover also insufficient buffers
         sbuf = sbuf.first(sizeof(T)-1);
@@ -1036,6 +1607,254 @@ TEST_CASE("fmt.raw_int")
     #undef _
 }
 
+
+//-----------------------------------------------------------------------------
+
+TEST_CASE_TEMPLATE("parse_array.int", T, uint8_t, int8_t, uint16_t, int16_t, uint32_t, int32_t, uint64_t, int64_t)
+{
+    T arr[8] = {};
+    span<T> out(arr, C4_COUNTOF(arr));
+    parse_array_result ret;
+    ret = parse_array(csubstr(""), ',', out);
+    CHECK(ret.ok());
+    CHECK_EQ(ret.count, 0);
+    ret = parse_array(csubstr("7"), ',', out);
+    CHECK(ret.ok());
+    CHECK_EQ(ret.count, 1);
+    CHECK_EQ(arr[0], T(7));
+    ret = parse_array(csubstr("1,22,0,0x1f,0b11,0o7,0099,123"), ',', out);
+    CHECK(ret.ok());
+    REQUIRE_EQ(ret.count, 8);
+    CHECK_EQ(arr[0], T(1));
+    CHECK_EQ(arr[1], T(22));
+    CHECK_EQ(arr[2], T(0));
+    CHECK_EQ(arr[3], T(31));
+    CHECK_EQ(arr[4], T(3));
+    CHECK_EQ(arr[5], T(7));
+    CHECK_EQ(arr[6], T(99));
+    CHECK_EQ(arr[7], T(123));
+    // any separator
+    ret = parse_array(csubstr("4 5 6"), ' ', out);
+    CHECK(ret.ok());
+    CHECK_EQ(ret.count, 3);
+    CHECK_EQ(arr[2], T(6));
+    // errors
+    ret = parse_array(csubstr("1,2,x,4"), ',', out);
+    CHECK_FALSE(ret.ok());
+    CHECK_EQ(ret.count, 2);
+    CHECK_EQ(ret.error, 4);
+    ret = parse_array(csubstr("1,2,3a,4"), ',', out);
+    CHECK_EQ(ret.count, 2);
+    CHECK_EQ(ret.error, 4);
+    ret = parse_array(csubstr("1,,3"), ',', out);
+    CHECK_EQ(ret.count, 1);
+    CHECK_EQ(ret.error, 2);
+    ret = parse_array(csubstr("1,2,"), ',', out);
+    CHECK_EQ(ret.count, 2);
+    CHECK_EQ(ret.error, 4);
+    ret = parse_array(csubstr(",1"), ',', out);
+    CHECK_EQ(ret.count, 0);
+    CHECK_EQ(ret.error, 0);
+    ret = parse_array(csubstr("1, 2"), ',', out);
+    CHECK_EQ(ret.count, 1);
+    CHECK_EQ(ret.error, 2);
+    // output too small
+    arr[2] = T(99);
+    ret = parse_array(csubstr("1,2,3"), ',', out.first(2));
+    CHECK_EQ(ret.count, 2);
+    CHECK_EQ(ret.error, 4);
+    CHECK_EQ(arr[2], T(99)); // not modified
+}
+
+TEST_CASE_TEMPLATE("parse_array.int_long_fields", T, uint32_t, int32_t, uint64_t, int64_t)
+{
+    // exercise every position of the field end in the 8-byte chunks
+    std::string src;
+    std::vector<T> expected;
+    T val = 0;
+    for(size_t i = 0; i < 60; ++i)
+    {
+        val = static_cast<T>(val * T(10) + T(i % 10u));
+        if(std::is_signed<T>::value && (i & 1u))
+            val = static_cast<T>(-val);
+        if(i)
+            src += ';';
+        c4::catrs(append, &src, val);
+        expected.push_back(val);
+        val = static_cast<T>(val < 0 ? -val : val);
+        if(val > std::numeric_limits<T>::max() / T(100))
+            val = T(i);
+    }
+    std::vector<T> out(expected.size() + 1);
+    parse_array_result ret = parse_array(to_csubstr(src), ';', span<T>(out.data(), out.size()));
+    CHECK(ret.ok());
+    REQUIRE_EQ(ret.count, expected.size());
+    for(size_t i = 0; i < expected.size(); ++i)
+    {
+        INFO("i=" << i);
+        CHECK_EQ(out[i], expected[i]);
+    }
+}
+
+TEST_CASE_TEMPLATE("parse_array.real", T, float, double)
+{
+    T arr[4] = {};
+    span<T> out(arr, C4_COUNTOF(arr));
+    parse_array_result ret = parse_array(csubstr("1.5\t-2\t1e3\t0.25"), '\t', out);
+    CHECK(ret.ok());
+    REQUIRE_EQ(ret.count, 4);
+    CHECK_EQ(arr[0], T(1.5));
+    CHECK_EQ(arr[1], T(-2));
+    CHECK_EQ(arr[2], T(1000));
+    CHECK_EQ(arr[3], T(0.25));
+    ret = parse_array(csubstr("1.5,2.5.5,3"), ',', out);
+    CHECK_FALSE(ret.ok());
+    CHECK_EQ(ret.count, 1);
+    CHECK_EQ(ret.error, 4);
+    ret = parse_array(csubstr("1.5,,3"), ',', out);
+    CHECK_EQ(ret.count, 1);
+    CHECK_EQ(ret.error, 4);
+}
+
+TEST_CASE("parse_array.real16")
+{
+    half harr[4] = {};
+    parse_array_result ret = parse_array(csubstr("1.5,-2,0.1,2049.0000000000000001"), ',', span<half>(harr, C4_COUNTOF(harr)));
+    CHECK(ret.ok());
+    REQUIRE_EQ(ret.count, 4);
+    CHECK_EQ(harr[0].bits, 0x3e00);
+    CHECK_EQ(harr[1].bits, 0xc000);
+    CHECK_EQ(harr[2].bits, 0x2e66);
+    CHECK_EQ(harr[3].bits, 0x6801); // rounded once, not via the double
+    bfloat16 barr[2] = {};
+    ret = parse_array(csubstr("0.1,x"), ',', span<bfloat16>(barr, C4_COUNTOF(barr)));
+    CHECK_FALSE(ret.ok());
+    CHECK_EQ(ret.count, 1);
+    CHECK_EQ(ret.error, 4);
+    CHECK_EQ(barr[0].bits, 0x3dcd);
+    // and back, with the shortest digits of each value
+    char bufc[64];
+    substr buf = bufc;
+    to_chars_array_result wret = to_chars_array(buf, cspan<half>(harr, C4_COUNTOF(harr)), ",");
+    CHECK_EQ(buf.first(wret.pos), "1.5,-2,0.1,2050");
+}
+
+//-----------------------------------------------------------------------------
+
+TEST_CASE_TEMPLATE("to_chars_array.int", T, uint8_t, int8_t, uint16_t, int16_t, uint32_t, int32_t, uint64_t, int64_t)
+{
+    const T vals[] = {T(0), T(1), T(10), T(127), T(-1), T(-100)};
+    cspan<T> span_(vals, C4_COUNTOF(vals));
+    std::string expected;
+    for(T v : vals)
+    {
+        if(!expected.empty())
+            expected += ", ";
+        catrs(append, &expected, v);
+    }
+    char bufc[128];
+    substr buf = bufc;
+    to_chars_array_result ret = to_chars_array(buf, span_, ", ");
+    CHECK_EQ(ret.required, expected.size());
+    CHECK_EQ(ret.count, C4_COUNTOF(vals));
+    CHECK_EQ(ret.pos, expected.size());
+    CHECK_EQ(buf.first(ret.pos), to_csubstr(expected));
+    // empty array
+    ret = to_chars_array(buf, span_.first(0), ", ");
+    CHECK_EQ(ret.required, 0);
+    CHECK_EQ(ret.count, 0);
+    // every buffer size, then resume
+    for(size_t sz = 0; sz <= expected.size(); ++sz)
+    {
+        INFO("sz=" << sz);
+        buf.fill('?');
+        ret = to_chars_array(buf.first(sz), span_, ", ");
+        CHECK_EQ(ret.required, expected.size());
+        CHECK_LE(ret.pos, sz);
+        CHECK_EQ(buf.first(ret.pos), to_csubstr(expected).first(ret.pos));
+        CHECK_EQ(buf.sub(sz).first_not_of('?'), csubstr::npos);
+        if(ret.count < C4_COUNTOF(vals))
+        {
+            CHECK_LT(ret.pos, sz + 1);
+            ret = to_chars_array_resume(buf.first(ret.required), span_, ", ", ret);
+        }
+        CHECK_EQ(ret.count, C4_COUNTOF(vals));
+        CHECK_EQ(ret.pos, expected.size());
+        CHECK_EQ(buf.first(ret.pos), to_csubstr(expected));
+    }
+}
+
+TEST_CASE_TEMPLATE("to_chars_array.real", T, float, double)
+{
+    const T vals[] = {T(0), T(1.5), T(-0.25), T(1e10), T(3.0)};
+    cspan<T> span_(vals, C4_COUNTOF(vals));
+    char bufc[128];
+    substr buf = bufc;
+    to_chars_array_result ret = to_chars_array(buf, span_, ",");
+    CHECK_EQ(ret.count, C4_COUNTOF(vals));
+    CHECK_EQ(buf.first(ret.pos), "0,1.5,-0.25,1e+10,3");
+    ret = to_chars_array(buf.first(8), span_, ",");
+    CHECK_EQ(ret.required, 19);
+    CHECK_EQ(ret.count, 2);
+    CHECK_EQ(ret.pos, 5);
+}
+
+TEST_CASE_TEMPLATE("to_chars_array_hexa", T, float, double)
+{
+    const T vals[] = {T(0), T(1.5), T(-0.25), T(1024), std::numeric_limits<T>::denorm_min(), std::numeric_limits<T>::infinity(), T(0.1)};
+    cspan<T> span_(vals, C4_COUNTOF(vals));
+    char bufc[128];
+    substr buf = bufc;
+    to_chars_array_result ret = to_chars_array_hexa(buf, span_, ",");
+    CHECK_EQ(ret.count, C4_COUNTOF(vals));
+    CHECK_EQ(ret.required, ret.pos);
+    const csubstr expected = sizeof(T) == 4 ?
+        csubstr("0x0p+0,0x1.8p+0,-0x1p-2,0x1p+10,0x0.000002p-126,inf,0x1.99999ap-4") :
+        csubstr("0x0p+0,0x1.8p+0,-0x1p-2,0x1p+10,0x0.0000000000001p-1022,inf,0x1.999999999999ap-4");
+    CHECK_EQ(buf.first(ret.pos), expected);
+    // the values read back exactly
+    T arr[C4_COUNTOF(vals)] = {};
+    parse_array_result pret = parse_array(buf.first(ret.pos), ',', span<T>(arr, C4_COUNTOF(arr)));
+    CHECK(pret.ok());
+    REQUIRE_EQ(pret.count, C4_COUNTOF(vals));
+    CHECK_EQ(memcmp(arr, vals, sizeof(vals)), 0);
+    // too small: resume
+    ret = to_chars_array_hexa(buf.first(24), span_, ",");
+    CHECK_EQ(ret.required, expected.len);
+    CHECK_EQ(ret.count, 3);
+    CHECK_EQ(ret.pos, 23);
+    ret = to_chars_array_hexa_resume(buf, span_, ",", ret);
+    CHECK_EQ(ret.count, C4_COUNTOF(vals));
+    CHECK_EQ(buf.first(ret.pos), expected);
+    // a nan payload is kept
+    using U = typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type;
+    const U nan_bits = sizeof(T) == 4 ? U(0x7f800123u) : U(UINT64_C(0xfff0000000000123));
+    T nan;
+    memcpy(&nan, &nan_bits, sizeof(T));
+    ret = to_chars_array_hexa(buf, cspan<T>(&nan, 1), ",");
+    CHECK_EQ(buf.first(ret.pos), sizeof(T) == 4 ? csubstr("nan(0x123)") : csubstr("-nan(0x123)"));
+    pret = parse_array(buf.first(ret.pos), ',', span<T>(arr, 1));
+    CHECK(pret.ok());
+    CHECK_EQ(memcmp(arr, &nan, sizeof(T)), 0);
+}
+
+TEST_CASE("to_chars_arrayrs")
+{
+    const int vals[] = {1, 22, 333, -4444};
+    cspan<int> span_(vals, C4_COUNTOF(vals));
+    std::string s;
+    to_chars_arrayrs(&s, span_, " ");
+    CHECK_EQ(s, "1 22 333 -4444");
+    s = "previous contents which are too long";
+    to_chars_arrayrs(&s, span_, "; ");
+    CHECK_EQ(s, "1; 22; 333; -4444");
+    CHECK_EQ(to_chars_arrayrs<std::string>(span_.first(2), ","), "1,22");
+    s = "x=";
+    csubstr appended = to_chars_arrayrs(append, &s, span_, ",");
+    CHECK_EQ(appended, "1,22,333,-4444");
+    CHECK_EQ(s, "x=1,22,333,-4444");
+}
+
 } // namespace c4
 
 #ifdef __clang__
@@ -0,0 +1,252 @@
+#include "c4/test.hpp"
+#ifndef C4CORE_SINGLE_HEADER
+#include "c4/scanner.hpp"
+#endif
+
+#include "c4/libtest/supprwarn_push.hpp"
+
+namespace c4 {
+
+TEST_CASE("scanner.empty")
+{
+    scanner sc;
+    CHECK(sc.ok());
+    CHECK(sc.at_end());
+    CHECK_EQ(sc.peek(), '\0');
+    CHECK_EQ(sc.rest().len, 0u);
+    sc.skip(' ').skip_ws().expect("");
+    CHECK(sc.ok());
+    sc.expect('a');
+    CHECK_FALSE(sc.ok());
+}
+
+TEST_CASE("scanner.read")
+{
+    scanner sc("1 -2 3.5 0x10,7");
+    int a = 0, b = 0;
+    double c = 0;
+    unsigned d = 0;
+    sc.read(&a).read(&b).read(&c).read(&d);
+    CHECK(sc);
+    CHECK_EQ(a, 1);
+    CHECK_EQ(b, -2);
+    CHECK_EQ(c, 3.5);
+    CHECK_EQ(d, 16u);
+    CHECK_EQ(sc.pos(), 13u);
+    CHECK_EQ(sc.peek(), ',');
+    sc.expect(',');
+    CHECK_EQ(sc.read<int>(), 7);
+    CHECK(sc.at_end());
+    CHECK(sc.ok());
+    // integers need not be followed by a delimiter
+    sc = scanner("12ab");
+    CHECK_EQ(sc.read<int>(), 12);
+    CHECK_EQ(sc.rest(), "ab");
+    CHECK(sc.ok());
+    sc = scanner("-");
+    CHECK_EQ(sc.read<int>(), 0);
+    CHECK_FALSE(sc.ok());
+    sc = scanner("-1");
+    CHECK_EQ(sc.read<unsigned>(), 0u);
+    CHECK_FALSE(sc.ok());
+}
+
+TEST_CASE("scanner.read_int_overflow")
+{
+    scanner sc("2147483647 -2147483648");
+    CHECK_EQ(sc.read<int32_t>(), INT32_MAX);
+    CHECK_EQ(sc.read<int32_t>(), INT32_MIN);
+    CHECK(sc.ok());
+    int32_t i = 1;
+    sc = scanner("2147483648");
+    sc.read(&i);
+    CHECK_FALSE(sc.ok());
+    CHECK_EQ(i, 1);
+    CHECK_EQ(sc.pos(), 0u);
+    sc = scanner("-2147483649");
+    sc.read(&i);
+    CHECK_FALSE(sc.ok());
+    CHECK_EQ(i, 1);
+    sc = scanner("99999999999");
+    sc.read(&i);
+    CHECK_FALSE(sc.ok());
+    CHECK_EQ(i, 1);
+    uint64_t u = 1;
+    sc = scanner("18446744073709551615");
+    sc.read(&u);
+    CHECK(sc.ok());
+    CHECK_EQ(u, UINT64_MAX);
+    sc = scanner("18446744073709551616");
+    sc.read(&u);
+    CHECK_FALSE(sc.ok());
+    CHECK_EQ(u, UINT64_MAX);
+    sc = scanner("0x1ffffffffffffffff");
+    sc.read(&u);
+    CHECK_FALSE(sc.ok());
+    uint8_t small = 1;
+    sc = scanner("256");
+    sc.read(&small);
+    CHECK_FALSE(sc.ok());
+    CHECK_EQ(small, 1u);
+    sc = scanner(" -5");
+    sc.read(&u);
+    CHECK_FALSE(sc.ok());
+    CHECK_EQ(u, UINT64_MAX);
+    CHECK_EQ(sc.pos(), 0u);
+}
+
+TEST_CASE("scanner.read_real")
+{
+    // reals need not be followed by a delimiter
+    scanner sc("1.5x 2.25e1y-0.5");
+    double d = 0;
+    sc.read(&d);
+    CHECK(sc.ok());
+    CHECK_EQ(d, 1.5);
+    CHECK_EQ(sc.rest(), "x 2.25e1y-0.5");
+    sc.expect('x');
+    CHECK_EQ(sc.read<float>(), 22.5f);
+    sc.expect('y');
+    CHECK_EQ(sc.read<double>(), -0.5);
+    CHECK(sc.at_end());
+    CHECK(sc.ok());
+    sc = scanner("0x1.8p1;");
+    CHECK_EQ(sc.read<double>(), 3.0);
+    CHECK_EQ(sc.peek(), ';');
+    sc = scanner("1.5h");
+    CHECK_EQ(float(sc.read<half>()), 1.5f);
+    CHECK_EQ(sc.peek(), 'h');
+    sc = scanner("2.5b");
+    CHECK_EQ(float(sc.read<bfloat16>()), 2.5f);
+    CHECK_EQ(sc.peek(), 'b');
+    sc = scanner("x1.5");
+    d = 7;
+    sc.read(&d);
+    CHECK_FALSE(sc.ok());
+    CHECK_EQ(d, 7);
+    CHECK_EQ(sc.pos(), 0u);
+}
+
+TEST_CASE("scanner.read_strings")
+{
+    // strings are read with read_until() and read_quoted(); read()
+    // rejects them at compile time
+    scanner sc("key=\"value\";");
+    csubstr key, value;
+    sc.read_until('=', &key).expect('=').read_quoted(&value).expect(';');
+    CHECK(sc.ok());
+    CHECK(sc.at_end());
+    CHECK_EQ(key, "key");
+    CHECK_EQ(value, "value");
+}
+
+TEST_CASE("scanner.sticky_failure")
+{
+    scanner sc("10 abc 20");
+    int a = 0, b = 0, c = 0;
+    sc.read(&a).read(&b).read(&c);
+    CHECK_FALSE(sc);
+    CHECK_EQ(a, 10);
+    CHECK_EQ(c, 0);
+    // the cursor stays where the failing operation started
+    CHECK_EQ(sc.pos(), 2u);
+    CHECK_EQ(sc.rest(), " abc 20");
+    // later operations do nothing
+    sc.skip(' ').expect("abc");
+    CHECK_EQ(sc.pos(), 2u);
+    CHECK_EQ(sc.read_until('2'), "");
+    CHECK_EQ(sc.read<int>(), 0);
+    CHECK_EQ(sc.pos(), 2u);
+    CHECK_FALSE(sc);
+    // a failed read stays sticky, even if the rest would be readable
+    sc = scanner("4294967296 5 6.5");
+    int64_t x = 0;
+    double y = 0;
+    sc.read(&c).read(&x).read(&y);
+    CHECK_FALSE(sc);
+    CHECK_EQ(c, 0);
+    CHECK_EQ(x, 0);
+    CHECK_EQ(y, 0);
+    CHECK_EQ(sc.pos(), 0u);
+    sc.skip_ws().expect('4').read_quoted();
+    CHECK_FALSE(sc);
+    CHECK_EQ(sc.pos(), 0u);
+}
+
+TEST_CASE("scanner.skip")
+{
+    scanner sc("   \t\r\n x--+-y");
+    sc.skip(' ');
+    CHECK_EQ(sc.pos(), 3u);
+    sc.skip_ws();
+    CHECK_EQ(sc.peek(), 'x');
+    sc.expect('x').skip("-+");
+    CHECK_EQ(sc.peek(), 'y');
+    sc.skip("");
+    CHECK_EQ(sc.peek(), 'y');
+    CHECK(sc.ok());
+}
+
+TEST_CASE("scanner.expect")
+{
+    scanner sc("HTTP/1.1\r\n");
+    int major = 0, minor = 0;
+    sc.expect("HTTP/").read(&major).expect('.').read(&minor).expect("\r\n");
+    CHECK(sc);
+    CHECK(sc.at_end());
+    CHECK_EQ(major, 1);
+    CHECK_EQ(minor, 1);
+    sc = scanner("HTTP/1.1");
+    sc.expect("HTTPS");
+    CHECK_FALSE(sc);
+    CHECK_EQ(sc.pos(), 0u);
+    sc = scanner("HTTP");
+    sc.expect("HTTP/");
+    CHECK_FALSE(sc);
+    sc = scanner("a");
+    sc.expect('b');
+    CHECK_FALSE(sc);
+}
+
+TEST_CASE("scanner.read_until")
+{
+    scanner sc("GET /index.html HTTP/1.1");
+    CHECK_EQ(sc.read_until(' '), "GET");
+    CHECK_EQ(sc.peek(), ' ');
+    CHECK_EQ(sc.skip(' ').read_until(' '), "/index.html");
+    csubstr proto;
+    sc.skip(' ').read_until('\n', &proto);
+    CHECK_FALSE(sc);
+    CHECK_EQ(proto, nullptr);
+    CHECK_EQ(sc.pos(), 16u);
+    sc = scanner(",x");
+    CHECK_EQ(sc.read_until(','), "");
+    CHECK(sc);
+    CHECK_EQ(sc.pos(), 0u);
+}
+
+TEST_CASE("scanner.read_quoted")
+{
+    scanner sc(R"("abc" 'd"e' "f\"g" "h\\" "i)");
+    CHECK_EQ(sc.read_quoted(), "abc");
+    CHECK_EQ(sc.skip(' ').read_quoted('\''), "d\"e");
+    CHECK_EQ(sc.skip(' ').read_quoted(), "f\\\"g");
+    CHECK_EQ(sc.skip(' ').read_quoted(), "h\\\\");
+    CHECK(sc);
+    const size_t pos = sc.skip(' ').pos();
+    csubstr v;
+    sc.read_quoted(&v);
+    CHECK_FALSE(sc);
+    CHECK_EQ(sc.pos(), pos);
+    sc = scanner("abc");
+    CHECK_EQ(sc.read_quoted(), "");
+    CHECK_FALSE(sc);
+    sc = scanner(R"("")");
+    CHECK_EQ(sc.read_quoted(), "");
+    CHECK(sc);
+    CHECK(sc.at_end());
+}
+
+} // namespace c4
+
+#include "c4/libtest/supprwarn_pop.hpp"
@@ -86,8 +86,11 @@ INSTRUCTIONS:
         "src/c4/std/std_fwd.hpp",
         "src/c4/charconv.hpp",
         "src/c4/utf.hpp",
+        "src/c4/format_string.hpp",
+        "src/c4/format_args.hpp",
         "src/c4/format.hpp",
         "src/c4/dump.hpp",
+        "src/c4/scanner.hpp",
         "src/c4/enum.hpp",
         "src/c4/bitmask.hpp",
         "src/c4/span.hpp",
@@ -105,6 +108,7 @@ INSTRUCTIONS:
         am.ignfile("src/c4/restrict.hpp"),
         am.ignfile("src/c4/unrestrict.hpp"),
         "src/c4/language.cpp",
+        "src/c4/charconv.cpp",
         "src/c4/format.cpp",
         "src/c4/memory_util.cpp",
         "src/c4/char_traits.cpp",